@@ -2,123 +2,1851 @@
 
 #include "core.h"
 #include "crypto/aes.h"
+#include "crypto/argon2.h"
+#include "crypto/chacha20poly1305.h"
+#include "crypto/hkdf.h"
+#include "crypto/pbkdf2.h"
+#include "crypto/random.h"
 #include "storage/localdb.h"
 #include "sync/firestore_sync.h"
 #include "utils/base64.h"
+#include "utils/bytes.h"
+#include "utils/thread_pool.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
 
 #define MASTER_SALT       "OpenLockrSaltValue"  // you should choose a secure, unique salt
 #define MASTER_SALT_LEN   (sizeof(MASTER_SALT) - 1)
 #define KEY_LEN_BYTES     32                     // AES-256
 #define IV_LEN_BYTES      16                     // AES block size
 
-// Global context holding derived key & default IV
+// Record format (versions 2 to 4):
+//   [version][12-byte nonce][AEAD ciphertext][16-byte tag]
+// Version 2 is AES-256-GCM, version 3 ChaCha20-Poly1305, both with a random
+// nonce. Version 4 is deterministic AES-256-GCM-SIV under the fixed
+// DEDUPE_NONCE, written only by openlockr_lock_dedupe(). All use the same
+// nonce and tag sizes, and the version byte is authenticated as AAD. Blobs
+// written before versioning are raw AES-256-CBC under the zero IV; unlock
+// still accepts them, but only in a legacy vault (META_LEGACY_CBC).
+#define RECORD_VERSION_GCM     0x02
+#define RECORD_VERSION_CHACHA  0x03
+#define RECORD_VERSION_SIV     0x04
+#define RECORD_HEADER_LEN      (1 + AES_GCM_NONCE_LEN)
+#define RECORD_OVERHEAD        (RECORD_HEADER_LEN + AES_GCM_TAG_LEN)
+
+// GCM-SIV derives its per-message keys by encrypting LE32(i) || nonce under
+// the vault key. A constant that no random GCM nonce is expected to hit keeps
+// those blocks apart from GCM's counter blocks under the same key.
+static const uint8_t DEDUPE_NONCE[AES_GCM_SIV_NONCE_LEN] = {
+    'o', 'l', 'k', 'r', '-', 'd', 'e', 'd', 'u', 'p', 'e', '1'
+};
+
+// Deduplicated entries are stored as BLOB_REF_PREFIX + content id, where the
+// content id is the hex GCM-SIV tag; the record itself lives once in the
+// `blobs` table and is synced under BLOB_SYNC_PREFIX + content id.
+#define BLOB_REF_PREFIX    '@'
+#define BLOB_SYNC_PREFIX   "blob_"
+#define BLOB_ID_LEN        (2 * AES_GCM_TAG_LEN)
+
+// The AEAD is fixed when the vault is created and kept in the meta table
+#define META_AEAD          "aead"
+#define AEAD_NAME_GCM      "aes-256-gcm"
+#define AEAD_NAME_CHACHA   "chacha20-poly1305"
+
+// Entries are encrypted under a random data key (DEK). The meta table keeps
+// it wrapped by a key-encryption key (KEK) derived from the master password
+// with the vault's KDF, so changing the password or the KDF rewrites only
+// the wrapped DEK:
+//   [format][KDF header][16-byte KEK salt][12-byte nonce][32-byte DEK ciphertext][16-byte tag]
+// with the KDF header [algorithm][LE32 iterations][LE32 memory KiB][LE32 lanes],
+// sealed with AES-256-GCM and everything before the nonce as AAD. Format 1,
+// written before KDFs were selectable, has no KDF header and means PBKDF2
+// with 100000 iterations. The wrapped DEK is also synced under DEK_SYNC_ID
+// so every device of a vault shares one DEK; META_DEK_SYNCED holds the last
+// value uploaded. Vaults created before the hierarchy keep their
+// password-derived key as the DEK, and only they have META_LEGACY_CBC set
+// ("1"): unauthenticated CBC blobs are accepted in those vaults alone.
+#define META_DEK           "dek"
+#define META_DEK_SYNCED    "dek_synced"
+#define META_LEGACY_CBC    "legacy_cbc"
+#define DEK_SYNC_ID        "vault_dek"
+#define DEK_WRAP_FORMAT_V1 0x01
+#define DEK_WRAP_FORMAT    0x02
+#define KDF_HEADER_LEN     13
+#define KEK_SALT_LEN       16
+#define DEK_WRAP_TAIL_LEN  (AES_GCM_NONCE_LEN + KEY_LEN_BYTES + AES_GCM_TAG_LEN)
+#define DEK_WRAP_V1_LEN    (1 + KEK_SALT_LEN + DEK_WRAP_TAIL_LEN)
+#define DEK_WRAP_AAD_LEN   (1 + KDF_HEADER_LEN + KEK_SALT_LEN)
+#define DEK_WRAP_LEN       (DEK_WRAP_AAD_LEN + DEK_WRAP_TAIL_LEN)
+
+// Largest KDF costs accepted from a wrapped DEK, which may arrive via sync.
+// The header is checked before the tag, so these bound what a tampered one
+// can make unlock spend.
+#define KDF_MAX_MEMORY_KIB        (1u << 20)   // 1 GiB
+#define KDF_MAX_LANES             64
+#define KDF_MAX_PBKDF2_ITERATIONS (1u << 26)   // ~20 s with SHA instructions
+#define KDF_MAX_ARGON2_PASSES     64
+
+// KDF of format-1 wrapped DEKs, and of new vaults if calibration fails
+static const olkr_kdf_params KDF_DEFAULT = { OLKR_KDF_PBKDF2, 100000, 0, 0 };
+
+// New vaults get Argon2id with costs measured on the creating device to take
+// about g_kdf_target_ms. Probes double their cost until they run long enough
+// to time reliably; results never go below the floors.
+#define KDF_PROBE_NS          20000000LL   // 20 ms
+#define KDF_MAX_TARGET_MS     60000
+#define KDF_MIN_ITERATIONS    100000       // PBKDF2, the pre-calibration default
+#define KDF_ARGON2_PASSES     3
+#define KDF_ARGON2_MIN_KIB    (8u << 10)   // 8 MiB
+#define KDF_ARGON2_MAX_KIB    (256u << 10) // 256 MiB, leaves headroom on phones
+#define KDF_ARGON2_MAX_LANES  4
+
+static uint32_t g_kdf_target_ms = OLKR_KDF_TARGET_MS;
+
+// Purpose-separated subkeys are HKDF-SHA256(salt SUBKEY_SALT, ikm DEK,
+// info label). The most recently derived SUBKEY_SLOTS are cached in g_ctx.
+#define SUBKEY_SALT        "OpenLockr subkeys v1"
+#define SUBKEY_SLOTS       8
+#define SUBKEY_LABEL_MAX   31
+
+typedef struct {
+    char    label[SUBKEY_LABEL_MAX + 1];   // "" while the slot is unused
+    uint8_t key[OLKR_SUBKEY_LEN];
+} subkey_slot;
+
+// Global context holding the vault's data key, keyed cipher & legacy (zero) CBC IV
 static struct {
-    uint8_t key[KEY_LEN_BYTES];
-    uint8_t iv[IV_LEN_BYTES];
-    int     initialized;
-} g_ctx = { {0}, {0}, 0 };
+    uint8_t         key[KEY_LEN_BYTES];
+    uint8_t         iv[IV_LEN_BYTES];
+    aes_256_key    *cipher;        // key schedule expanded once, reused by lock/unlock
+    uint8_t         aead;          // record version written by lock
+    int             legacy_cbc;    // vault predates AEAD records; CBC blobs allowed
+    int             initialized;
+    olkr_kdf_params kdf;           // KDF the DEK is wrapped with
+    uint8_t         subkey_prk[HKDF_SHA256_PRK_LEN];   // HKDF-Extract of the DEK
+    subkey_slot     subkeys[SUBKEY_SLOTS];            // guarded by g_subkey_lock
+    size_t          subkey_next;                      // slot replaced next when full
+} g_ctx = { {0}, {0}, NULL, 0, 0, 0, {0, 0, 0, 0}, {0}, {{{0}, {0}}}, 0 };
+
+static pthread_mutex_t g_subkey_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /**
- * Initialize the OpenLockr core with a master password.
- * Derives AES key via PBKDF2-HMAC-SHA256, stores in g_ctx.
+ * Load the vault's AEAD from the meta table. A new vault records AES-256-GCM
+ * when the CPU has AES instructions and ChaCha20-Poly1305 otherwise, where
+ * software AES would be slow and cache-timing sensitive.
  */
-int openlockr_init(const char *master_password) {
-    if (!master_password) return OLKR_ERR_INVALID_ARG;
+static int vault_load_aead(void) {
+    char *name = NULL;
+    int rc = localdb_get_meta(META_AEAD, &name);
+    if (rc == -2) {
+        int gcm = aes_hardware_accelerated();
+        if (localdb_put_meta(META_AEAD, gcm ? AEAD_NAME_GCM : AEAD_NAME_CHACHA) != 0) {
+            return -1;
+        }
+        g_ctx.aead = gcm ? RECORD_VERSION_GCM : RECORD_VERSION_CHACHA;
+        return 0;
+    }
+    if (rc != 0) return -1;
+
+    if (strcmp(name, AEAD_NAME_GCM) == 0) {
+        g_ctx.aead = RECORD_VERSION_GCM;
+    } else if (strcmp(name, AEAD_NAME_CHACHA) == 0) {
+        g_ctx.aead = RECORD_VERSION_CHACHA;
+    } else {
+        rc = -1;
+    }
+    free(name);
+    return rc;
+}
+
+/*=============================================================================
+  Key hierarchy
+=============================================================================*/
+
+// Costs a KEK may be derived with; bounds what a synced header can demand
+static int kdf_valid(const olkr_kdf_params *kdf) {
+    switch (kdf->algorithm) {
+    case OLKR_KDF_PBKDF2:
+        return kdf->iterations > 0 && kdf->iterations <= KDF_MAX_PBKDF2_ITERATIONS;
+    case OLKR_KDF_ARGON2ID:
+        return kdf->iterations > 0 && kdf->iterations <= KDF_MAX_ARGON2_PASSES &&
+               kdf->lanes > 0 && kdf->lanes <= KDF_MAX_LANES &&
+               kdf->memory_kib / 8 >= kdf->lanes && kdf->memory_kib <= KDF_MAX_MEMORY_KIB;
+    default:
+        return 0;
+    }
+}
+
+static int kek_derive(const char *password, const olkr_kdf_params *kdf,
+                      const uint8_t *salt, uint8_t kek[KEY_LEN_BYTES]) {
+    int rc;
+    if (kdf->algorithm == OLKR_KDF_ARGON2ID) {
+        argon2_params p = { kdf->iterations, kdf->memory_kib, kdf->lanes };
+        rc = argon2id(&p, (const uint8_t *)password, strlen(password), salt, KEK_SALT_LEN,
+                      NULL, 0, NULL, 0, kek, KEY_LEN_BYTES);
+    } else {
+        rc = pbkdf2_hmac_sha256(password, strlen(password), salt, KEK_SALT_LEN,
+                                kdf->iterations, kek, KEY_LEN_BYTES);
+    }
+    return rc == 0 ? OLKR_OK : OLKR_ERR_CRYPTO;
+}
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Nanoseconds one KEK derivation with `kdf` takes, or -1 on failure
+static long long kdf_time(const olkr_kdf_params *kdf) {
+    static const uint8_t salt[KEK_SALT_LEN] = {0};
+    uint8_t kek[KEY_LEN_BYTES];
+    long long start = now_ns();
+    int rc = kek_derive("calibration", kdf, salt, kek);
+    long long elapsed = now_ns() - start;
+    memset(kek, 0, sizeof(kek));
+    return rc == OLKR_OK ? (elapsed > 0 ? elapsed : 1) : -1;
+}
+
+// Scale the cost `unit` that took `ns` up to `target_ms`, within [lo, hi]
+static uint32_t kdf_scale(uint32_t unit, long long ns, uint32_t target_ms,
+                          uint32_t lo, uint32_t hi) {
+    double v = (double)unit * target_ms * 1e6 / (double)ns;
+    return v < lo ? lo : v > hi ? hi : (uint32_t)v;
+}
 
-    // Derive KEY_LEN_BYTES key using PBKDF2(master_password, MASTER_SALT)
+/**
+ * Pick costs for `algorithm` that take about `target_ms` on this device.
+ *
+ * PBKDF2 scales its iterations. Argon2id uses one lane per core (up to
+ * KDF_ARGON2_MAX_LANES) and KDF_ARGON2_PASSES passes, and spends the budget
+ * on memory first; past KDF_ARGON2_MAX_KIB it adds passes instead, and below
+ * KDF_ARGON2_MIN_KIB it drops passes, then stays at the floor. Iterations
+ * and passes stop at the caps kdf_valid() enforces.
+ */
+static int kdf_calibrate(uint32_t algorithm, uint32_t target_ms, olkr_kdf_params *out) {
+    olkr_kdf_params k = { algorithm, 0, 0, 0 };
+    long long ns;
+
+    if (algorithm == OLKR_KDF_PBKDF2) {
+        k.iterations = 10000;
+        while ((ns = kdf_time(&k)) >= 0 && ns < KDF_PROBE_NS && k.iterations < (1u << 30)) {
+            k.iterations *= 2;
+        }
+        if (ns < 0) return OLKR_ERR_CRYPTO;
+        k.iterations = kdf_scale(k.iterations, ns, target_ms, KDF_MIN_ITERATIONS,
+                                 KDF_MAX_PBKDF2_ITERATIONS);
+    } else if (algorithm == OLKR_KDF_ARGON2ID) {
+        size_t threads = thread_pool_threads();
+        k.lanes = threads < KDF_ARGON2_MAX_LANES ? (uint32_t)threads : KDF_ARGON2_MAX_LANES;
+        k.iterations = KDF_ARGON2_PASSES;
+        k.memory_kib = 1024;
+        while ((ns = kdf_time(&k)) >= 0 && ns < KDF_PROBE_NS && k.memory_kib < KDF_ARGON2_MAX_KIB) {
+            k.memory_kib *= 2;
+        }
+        if (ns < 0) return OLKR_ERR_CRYPTO;
+
+        // Spend the budget (in KiB-passes). Large memory runs slower per KiB
+        // than the cache-sized probe, so time the first pick and rescale once.
+        uint32_t cost = k.memory_kib * KDF_ARGON2_PASSES;
+        for (int round = 0; round < 2; round++) {
+            uint32_t budget = kdf_scale(cost, ns, target_ms, KDF_ARGON2_MIN_KIB, UINT32_MAX);
+            k.iterations = KDF_ARGON2_PASSES;
+            k.memory_kib = budget / KDF_ARGON2_PASSES;
+            if (k.memory_kib > KDF_ARGON2_MAX_KIB) {
+                k.memory_kib = KDF_ARGON2_MAX_KIB;
+                k.iterations = budget / KDF_ARGON2_MAX_KIB;
+            } else if (k.memory_kib < KDF_ARGON2_MIN_KIB) {
+                k.memory_kib = KDF_ARGON2_MIN_KIB;
+                k.iterations = budget / KDF_ARGON2_MIN_KIB;
+            }
+            if (k.iterations > KDF_MAX_ARGON2_PASSES) k.iterations = KDF_MAX_ARGON2_PASSES;
+            if (round == 1 || budget / 2 <= cost) break;
+            cost = k.memory_kib * k.iterations;
+            if ((ns = kdf_time(&k)) < 0) return OLKR_ERR_CRYPTO;
+        }
+    } else {
+        return OLKR_ERR_INVALID_ARG;
+    }
+    *out = k;
+    return OLKR_OK;
+}
+
+// Seal `dek` under a KEK derived from `password` with `kdf` and a fresh salt
+static int dek_wrap(const char *password, const olkr_kdf_params *kdf,
+                    const uint8_t *dek, char **out_b64) {
+    uint8_t w[DEK_WRAP_LEN], kek[KEY_LEN_BYTES];
+    uint8_t *salt = w + 1 + KDF_HEADER_LEN;
+    uint8_t *nonce = w + DEK_WRAP_AAD_LEN;
+    uint8_t *ct = nonce + AES_GCM_NONCE_LEN;
+
+    w[0] = DEK_WRAP_FORMAT;
+    w[1] = (uint8_t)kdf->algorithm;
+    store32_le(w + 2, kdf->iterations);
+    store32_le(w + 6, kdf->memory_kib);
+    store32_le(w + 10, kdf->lanes);
+
+    int rc = OLKR_ERR_CRYPTO;
+    if (random_bytes(salt, KEK_SALT_LEN) == 0 && random_bytes(nonce, AES_GCM_NONCE_LEN) == 0 &&
+        kek_derive(password, kdf, salt, kek) == OLKR_OK) {
+        aes_256_key *k = aes_256_key_new(kek, KEY_LEN_BYTES);
+        if (k && aes_256_gcm_encrypt_keyed(k, nonce, w, DEK_WRAP_AAD_LEN, dek, KEY_LEN_BYTES,
+                                           ct, ct + KEY_LEN_BYTES) >= 0) {
+            rc = OLKR_OK;
+        }
+        aes_256_key_free(k);
+    }
+    secure_wipe(kek, sizeof(kek));
+    if (rc != OLKR_OK) return rc;
+
+    size_t b64_len = 0;
+    *out_b64 = base64_encode(w, DEK_WRAP_LEN, &b64_len);
+    return *out_b64 ? OLKR_OK : OLKR_ERR_OOM;
+}
+
+// Recover the DEK and its KDF from a wrapped value; OLKR_ERR_CRYPTO for a
+// wrong password
+static int dek_unwrap(const char *password, const char *b64,
+                      uint8_t dek[KEY_LEN_BYTES], olkr_kdf_params *kdf) {
+    uint8_t w[DEK_WRAP_LEN];
+    int n = base64_decode_into(b64, strlen(b64), w, sizeof(w));
+    if (n < 0) return OLKR_ERR_CRYPTO;
+
+    size_t len = (size_t)n;
+    size_t aad_len = 0;
+    if (len == DEK_WRAP_V1_LEN && w[0] == DEK_WRAP_FORMAT_V1) {
+        *kdf = KDF_DEFAULT;
+        aad_len = 1 + KEK_SALT_LEN;
+    } else if (len == DEK_WRAP_LEN && w[0] == DEK_WRAP_FORMAT) {
+        kdf->algorithm = w[1];
+        kdf->iterations = load32_le(w + 2);
+        kdf->memory_kib = load32_le(w + 6);
+        kdf->lanes = load32_le(w + 10);
+        aad_len = DEK_WRAP_AAD_LEN;
+    }
+
+    int rc = OLKR_ERR_CRYPTO;
+    if (aad_len && kdf_valid(kdf)) {
+        uint8_t kek[KEY_LEN_BYTES];
+        uint8_t *nonce = w + aad_len;
+        uint8_t *ct = nonce + AES_GCM_NONCE_LEN;
+        if (kek_derive(password, kdf, nonce - KEK_SALT_LEN, kek) == OLKR_OK) {
+            aes_256_key *k = aes_256_key_new(kek, KEY_LEN_BYTES);
+            if (k && aes_256_gcm_decrypt_keyed(k, nonce, w, aad_len, ct, KEY_LEN_BYTES,
+                                               ct + KEY_LEN_BYTES, dek) >= 0) {
+                rc = OLKR_OK;
+            }
+            aes_256_key_free(k);
+        }
+        secure_wipe(kek, sizeof(kek));
+    }
+    if (rc != OLKR_OK) secure_wipe(dek, KEY_LEN_BYTES);
+    return rc;
+}
+
+// Upload the wrapped DEK and remember that this value reached the server
+static int dek_publish(const char *wrapped) {
+    if (firestore_sync_upload(DEK_SYNC_ID, wrapped) != 0) return OLKR_ERR_SYNC;
+    return localdb_put_meta(META_DEK_SYNCED, wrapped) == 0 ? OLKR_OK : OLKR_ERR_STORAGE;
+}
+
+/**
+ * Vaults created before the key hierarchy encrypted entries directly under
+ * PBKDF2(master_password, MASTER_SALT); that key becomes their DEK.
+ */
+static int legacy_key_derive(const char *master_password, uint8_t key[KEY_LEN_BYTES]) {
     int rc = pbkdf2_hmac_sha256(
-        (const uint8_t *)master_password,
+        master_password,
         strlen(master_password),
         (const uint8_t *)MASTER_SALT,
         MASTER_SALT_LEN,
         /*iterations=*/100000,
-        g_ctx.key,
+        key,
         KEY_LEN_BYTES
     );
-    if (rc != 0) return OLKR_ERR_CRYPTO;
+    return rc == 0 ? OLKR_OK : OLKR_ERR_CRYPTO;
+}
+
+// Record whether the vault is legacy (its DEK is the password-derived key)
+static int vault_set_legacy(int legacy) {
+    g_ctx.legacy_cbc = legacy;
+    return localdb_put_meta(META_LEGACY_CBC, legacy ? "1" : "0") == 0 ? OLKR_OK : OLKR_ERR_STORAGE;
+}
+
+// Is the DEK just taken from the server this vault's legacy key? Compared
+// once, when a device first joins the vault, and remembered in the meta table.
+static int vault_detect_legacy(const char *password) {
+    uint8_t key[KEY_LEN_BYTES];
+    int rc = legacy_key_derive(password, key);
+    if (rc == OLKR_OK) rc = vault_set_legacy(memcmp(key, g_ctx.key, KEY_LEN_BYTES) == 0);
+    secure_wipe(key, sizeof(key));
+    return rc;
+}
+
+// Load the flag vault_set_legacy() stored; vaults without one are not legacy
+static int vault_load_legacy(void) {
+    char *flag = NULL;
+    int rc = localdb_get_meta(META_LEGACY_CBC, &flag);
+    if (rc == -1) return OLKR_ERR_STORAGE;
+    g_ctx.legacy_cbc = rc == 0 && strcmp(flag, "1") == 0;
+    free(flag);
+    return OLKR_OK;
+}
+
+// Local wrapped DEK unwrapped ahead of vault_load_dek(), while the
+// database was still loading (openlockr_init_start)
+typedef struct {
+    char           *wrapped;   // value that was unwrapped; NULL if none
+    int             rc;        // dek_unwrap() result
+    uint8_t         key[KEY_LEN_BYTES];
+    olkr_kdf_params kdf;
+} dek_prefetch;
+
+/**
+ * Put the vault's DEK in g_ctx.key. In order of preference: unwrap the local
+ * copy (or reuse `pre` if it unwrapped that same value); take the synced
+ * copy (first run on this device, or the password was changed on another
+ * device); adopt the legacy password-derived key for a vault that already
+ * has data; or create a random DEK for a new vault. Also settles
+ * g_ctx.legacy_cbc, which only a vault using the legacy key gets.
+ */
+static int vault_load_dek(const char *password, const dek_prefetch *pre) {
+    char *wrapped = NULL, *remote = NULL;
+    int rc = localdb_get_meta(META_DEK, &wrapped);
+    if (rc == -1) return OLKR_ERR_STORAGE;
+
+    if (rc == 0) {
+        if (pre && pre->wrapped && strcmp(pre->wrapped, wrapped) == 0) {
+            rc = pre->rc;
+            memcpy(g_ctx.key, pre->key, KEY_LEN_BYTES);
+            g_ctx.kdf = pre->kdf;
+        } else {
+            rc = dek_unwrap(password, wrapped, g_ctx.key, &g_ctx.kdf);
+        }
+        if (rc == OLKR_ERR_CRYPTO &&
+            firestore_sync_download(DEK_SYNC_ID, &remote) == OLKR_OK &&
+            strcmp(remote, wrapped) != 0 &&
+            dek_unwrap(password, remote, g_ctx.key, &g_ctx.kdf) == OLKR_OK) {
+            free(wrapped);
+            wrapped = remote;
+            remote = NULL;
+            rc = localdb_put_meta(META_DEK, wrapped) == 0 &&
+                 localdb_put_meta(META_DEK_SYNCED, wrapped) == 0
+               ? OLKR_OK : OLKR_ERR_STORAGE;
+        }
+        if (rc == OLKR_OK) rc = vault_load_legacy();
+    } else {
+        char *aead = NULL;
+        int legacy = localdb_get_meta(META_AEAD, &aead) == 0 || localdb_has_entries() == 1;
+        free(aead);
+
+        int dl = firestore_sync_download(DEK_SYNC_ID, &remote);
+        if (dl == OLKR_OK) {
+            wrapped = remote;
+            remote = NULL;
+            rc = dek_unwrap(password, wrapped, g_ctx.key, &g_ctx.kdf);
+            if (rc == OLKR_OK && localdb_put_meta(META_DEK_SYNCED, wrapped) != 0) {
+                rc = OLKR_ERR_STORAGE;
+            }
+            if (rc == OLKR_OK) rc = vault_detect_legacy(password);
+        } else if (legacy || dl == OLKR_ERR_NOT_FOUND) {
+            // Offline is only safe for a legacy vault, whose DEK every
+            // device derives alike; a new DEK must not race another device's
+            rc = legacy ? legacy_key_derive(password, g_ctx.key)
+               : random_bytes(g_ctx.key, KEY_LEN_BYTES) == 0 ? OLKR_OK : OLKR_ERR_CRYPTO;
+            if (rc == OLKR_OK &&
+                kdf_calibrate(OLKR_KDF_ARGON2ID, g_kdf_target_ms, &g_ctx.kdf) != OLKR_OK) {
+                g_ctx.kdf = KDF_DEFAULT;
+            }
+            if (rc == OLKR_OK) rc = vault_set_legacy(legacy);
+            if (rc == OLKR_OK) rc = dek_wrap(password, &g_ctx.kdf, g_ctx.key, &wrapped);
+        } else {
+            rc = dl;
+        }
+        if (rc == OLKR_OK && localdb_put_meta(META_DEK, wrapped) != 0) rc = OLKR_ERR_STORAGE;
+    }
+
+    // Retry an upload that failed earlier; the local vault works without it
+    if (rc == OLKR_OK) {
+        char *synced = NULL;
+        if (localdb_get_meta(META_DEK_SYNCED, &synced) != 0 || strcmp(synced, wrapped) != 0) {
+            dek_publish(wrapped);
+        }
+        free(synced);
+    } else {
+        memset(g_ctx.key, 0, KEY_LEN_BYTES);
+    }
+    free(wrapped);
+    free(remote);
+    return rc;
+}
 
-    // Initialize IV to zeros or derive per-entry if you prefer
+// Create the keyed cipher every lock/unlock reuses and the subkey PRK
+// from g_ctx.key
+static int vault_key_setup(void) {
+    aes_256_key_free(g_ctx.cipher);
+    g_ctx.cipher = aes_256_key_new(g_ctx.key, KEY_LEN_BYTES);
+    if (!g_ctx.cipher) return OLKR_ERR_CRYPTO;
+
+    // Subkeys then cost one HKDF-Expand each
+    if (hkdf_sha256_extract((const uint8_t *)SUBKEY_SALT, sizeof(SUBKEY_SALT) - 1,
+                            g_ctx.key, KEY_LEN_BYTES, g_ctx.subkey_prk) != 0) {
+        return OLKR_ERR_CRYPTO;
+    }
+    return OLKR_OK;
+}
+
+/**
+ * Finish initialization once the database is ready: unwrap (or create) the
+ * vault's data key and key the shared cipher. On failure the database is
+ * closed and g_ctx wiped.
+ */
+static int vault_open(const char *password, const dek_prefetch *pre) {
+    // Legacy CBC blobs were written with an all-zero IV
     memset(g_ctx.iv, 0, IV_LEN_BYTES);
 
-    // Initialize local DB
-    rc = localdb_init();
-    if (rc != 0) return OLKR_ERR_STORAGE;
+    // Load the data key and everything keyed by it
+    int rc = vault_load_dek(password, pre);
+    if (rc == OLKR_OK) rc = vault_key_setup();
+
+    // Pick up the vault's AEAD
+    if (rc == OLKR_OK && vault_load_aead() != 0) rc = OLKR_ERR_STORAGE;
+
+    if (rc != OLKR_OK) {
+        localdb_close();
+        aes_256_key_free(g_ctx.cipher);
+        memset(&g_ctx, 0, sizeof(g_ctx));
+        return rc;
+    }
 
     g_ctx.initialized = 1;
     return OLKR_OK;
 }
 
+/*=============================================================================
+  Session
+=============================================================================*/
+
+// A suspended vault keeps its DEK sealed with ChaCha20-Poly1305 under
+// HKDF-SHA256(salt session key, ikm PIN or token, info SESSION_INFO), where
+// the session key is random per suspend. Both live in one mlock'd page that
+// is left out of core dumps and wiped in a forked child; a watchdog thread
+// wipes it once the idle timeout passes, and so does a resume that finds
+// the deadline gone (the watchdog's clock may stop while the device sleeps).
+#define SESSION_INFO  "OpenLockr session v1"
+
+typedef struct {
+    uint8_t key[KEY_LEN_BYTES];
+    uint8_t nonce[CHACHA20_POLY1305_NONCE_LEN];
+    uint8_t sealed[KEY_LEN_BYTES];
+    uint8_t tag[CHACHA20_POLY1305_TAG_LEN];
+} session_secret;
+
+static pthread_once_t g_session_once = PTHREAD_ONCE_INIT;
+
+static struct {
+    pthread_mutex_t lock;       // guards the fields below
+    pthread_cond_t  wake;       // CLOCK_MONOTONIC; wakes the watchdog early
+    pthread_t       watchdog;
+    int             watching;   // watchdog started, not yet joined
+    int             stop;       // watchdog should exit
+    session_secret *secret;     // NULL when no vault is suspended
+    long long       deadline;   // session_clock_ns() at which it expires
+    unsigned        failures;   // wrong secrets so far
+    olkr_kdf_params kdf;
+    uint8_t         aead;
+    int             legacy_cbc;
+} g_session;
+
+static void session_setup(void) {
+    pthread_condattr_t attr;
+    pthread_mutex_init(&g_session.lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&g_session.wake, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+// Time that keeps counting while the device sleeps, where the OS has one
+static long long session_clock_ns(void) {
+    struct timespec ts;
+#ifdef CLOCK_BOOTTIME
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static session_secret *session_page_new(void) {
+    void *p = mmap(NULL, sizeof(session_secret), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    if (mlock(p, sizeof(session_secret)) != 0) {
+        munmap(p, sizeof(session_secret));
+        return NULL;
+    }
+#ifdef MADV_DONTDUMP
+    madvise(p, sizeof(session_secret), MADV_DONTDUMP);
+#endif
+#ifdef MADV_WIPEONFORK
+    madvise(p, sizeof(session_secret), MADV_WIPEONFORK);
+#endif
+    return (session_secret *)p;
+}
+
+static void session_page_free(session_secret *s) {
+    secure_wipe(s, sizeof(*s));
+    munlock(s, sizeof(*s));
+    munmap(s, sizeof(*s));
+}
+
+static int session_wrap_key(const session_secret *s, const uint8_t *secret, size_t secret_len,
+                            uint8_t wrap[KEY_LEN_BYTES]) {
+    return hkdf_sha256(s->key, sizeof(s->key), secret, secret_len,
+                       (const uint8_t *)SESSION_INFO, sizeof(SESSION_INFO) - 1,
+                       wrap, KEY_LEN_BYTES);
+}
+
+// Drop the suspended vault, closing the database it kept open. Called with
+// g_session.lock held.
+static void session_wipe_locked(void) {
+    if (!g_session.secret) return;
+    session_page_free(g_session.secret);
+    g_session.secret = NULL;
+    if (!g_ctx.initialized) localdb_close();
+}
+
+static void *session_watchdog(void *unused) {
+    (void)unused;
+    pthread_mutex_lock(&g_session.lock);
+    while (!g_session.stop && g_session.secret) {
+        long long left = g_session.deadline - session_clock_ns();
+        if (left <= 0) {
+            session_wipe_locked();
+            break;
+        }
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        long long at = (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec + left;
+        ts.tv_sec = (time_t)(at / 1000000000LL);
+        ts.tv_nsec = (long)(at % 1000000000LL);
+        pthread_cond_timedwait(&g_session.wake, &g_session.lock, &ts);
+    }
+    pthread_mutex_unlock(&g_session.lock);
+    return NULL;
+}
+
+// Wipe any suspended vault and stop its watchdog
+static void session_end(void) {
+    pthread_once(&g_session_once, session_setup);
+    pthread_mutex_lock(&g_session.lock);
+    session_wipe_locked();
+    int join = g_session.watching;
+    g_session.watching = 0;
+    g_session.stop = 1;
+    pthread_cond_broadcast(&g_session.wake);
+    pthread_mutex_unlock(&g_session.lock);
+    if (join) pthread_join(g_session.watchdog, NULL);
+}
+
+int openlockr_session_suspend(const uint8_t *secret, size_t secret_len, uint32_t idle_timeout_s) {
+    if (!g_ctx.initialized || !secret || secret_len == 0 || idle_timeout_s == 0) {
+        return OLKR_ERR_INVALID_ARG;
+    }
+    session_end();
+
+    session_secret *s = session_page_new();
+    if (!s) return OLKR_ERR_OOM;
+    uint8_t wrap[KEY_LEN_BYTES];
+    int rc = OLKR_ERR_CRYPTO;
+    if (random_bytes(s->key, sizeof(s->key)) == 0 &&
+        random_bytes(s->nonce, sizeof(s->nonce)) == 0 &&
+        session_wrap_key(s, secret, secret_len, wrap) == 0 &&
+        chacha20_poly1305_encrypt(wrap, s->nonce, NULL, 0, g_ctx.key, KEY_LEN_BYTES,
+                                  s->sealed, s->tag) >= 0) {
+        rc = OLKR_OK;
+    }
+    secure_wipe(wrap, sizeof(wrap));
+    if (rc != OLKR_OK) {
+        session_page_free(s);
+        return rc;
+    }
+
+    pthread_mutex_lock(&g_session.lock);
+    g_session.secret = s;
+    g_session.deadline = session_clock_ns() + (long long)idle_timeout_s * 1000000000LL;
+    g_session.failures = 0;
+    g_session.kdf = g_ctx.kdf;
+    g_session.aead = g_ctx.aead;
+    g_session.legacy_cbc = g_ctx.legacy_cbc;
+    g_session.stop = 0;
+    // Without a watchdog the deadline is still enforced at resume
+    g_session.watching = pthread_create(&g_session.watchdog, NULL, session_watchdog, NULL) == 0;
+    pthread_mutex_unlock(&g_session.lock);
+
+    // Lock the vault; the database stays open for the resume
+    aes_256_key_free(g_ctx.cipher);
+    pthread_mutex_lock(&g_subkey_lock);
+    memset(&g_ctx, 0, sizeof(g_ctx));
+    pthread_mutex_unlock(&g_subkey_lock);
+    return OLKR_OK;
+}
+
+int openlockr_session_resume(const uint8_t *secret, size_t secret_len) {
+    if (g_ctx.initialized || !secret || secret_len == 0) return OLKR_ERR_INVALID_ARG;
+    pthread_once(&g_session_once, session_setup);
+
+    pthread_mutex_lock(&g_session.lock);
+    if (g_session.secret && session_clock_ns() >= g_session.deadline) session_wipe_locked();
+
+    int rc = OLKR_ERR_NOT_FOUND;
+    session_secret *s = g_session.secret;
+    if (s) {
+        uint8_t wrap[KEY_LEN_BYTES];
+        rc = OLKR_ERR_CRYPTO;
+        if (session_wrap_key(s, secret, secret_len, wrap) == 0 &&
+            chacha20_poly1305_decrypt(wrap, s->nonce, NULL, 0, s->sealed, KEY_LEN_BYTES,
+                                      s->tag, g_ctx.key) >= 0) {
+            g_ctx.kdf = g_session.kdf;
+            g_ctx.aead = g_session.aead;
+            g_ctx.legacy_cbc = g_session.legacy_cbc;
+            rc = vault_key_setup();
+            if (rc == OLKR_OK) {
+                g_ctx.initialized = 1;
+            } else {
+                aes_256_key_free(g_ctx.cipher);
+                memset(&g_ctx, 0, sizeof(g_ctx));
+            }
+        }
+        secure_wipe(wrap, sizeof(wrap));
+        // A session is good for one resume, or a few wrong guesses
+        if (rc == OLKR_OK || ++g_session.failures >= OLKR_SESSION_MAX_ATTEMPTS) {
+            session_wipe_locked();
+        }
+    }
+    int ended = !g_session.secret;
+    pthread_mutex_unlock(&g_session.lock);
+
+    if (ended) session_end();
+    return rc;
+}
+
+void openlockr_session_end(void) {
+    session_end();
+}
+
+/**
+ * Initialize the OpenLockr core with a master password.
+ */
+int openlockr_init(const char *master_password) {
+    if (!master_password) return OLKR_ERR_INVALID_ARG;
+    session_end();
+    if (localdb_init() != 0) return OLKR_ERR_STORAGE;
+    return vault_open(master_password, NULL);
+}
+
+/*=============================================================================
+  Asynchronous init
+=============================================================================*/
+
+// An existing vault keeps its KEK salt and KDF costs in the meta table, so
+// the init thread reads that one row, hands the derivation to a second
+// thread and meanwhile finishes loading the database; vault_open() then
+// picks up the prefetched DEK.
+struct olkr_init_op {
+    pthread_t     thread;
+    char         *password;
+    olkr_init_cb  cb;
+    void         *user;
+    int           fds[2];     // pipe; fds[0] turns readable when done
+    int           rc;
+    dek_prefetch  pre;
+};
+
+static void *init_kdf_thread(void *arg) {
+    olkr_init_op *op = (olkr_init_op *)arg;
+    op->pre.rc = dek_unwrap(op->password, op->pre.wrapped, op->pre.key, &op->pre.kdf);
+    return NULL;
+}
+
+static void *init_thread(void *arg) {
+    olkr_init_op *op = (olkr_init_op *)arg;
+    int rc = OLKR_ERR_STORAGE;
+
+    if (localdb_open() == 0) {
+        pthread_t kdf;
+        int kdf_running = 0;
+        if (localdb_get_meta(META_DEK, &op->pre.wrapped) == 0) {
+            kdf_running = pthread_create(&kdf, NULL, init_kdf_thread, op) == 0;
+            if (!kdf_running) init_kdf_thread(op);
+        }
+
+        // Schema check and cache warm-up overlap the derivation
+        int db_ok = localdb_init() == 0;
+        if (db_ok) localdb_warm();
+        if (kdf_running) pthread_join(kdf, NULL);
+
+        if (db_ok) {
+            rc = vault_open(op->password, &op->pre);
+        } else {
+            localdb_close();
+        }
+    }
+
+    secure_wipe(op->pre.key, KEY_LEN_BYTES);
+    free(op->pre.wrapped);
+    op->pre.wrapped = NULL;
+    secure_wipe(op->password, strlen(op->password));
+    free(op->password);
+    op->password = NULL;
+
+    op->rc = rc;
+    if (op->cb) op->cb(rc, op->user);
+    ssize_t n;
+    do {
+        n = write(op->fds[1], "", 1);
+    } while (n < 0 && errno == EINTR);
+    return NULL;
+}
+
+int openlockr_init_start(const char *master_password, olkr_init_cb cb, void *user,
+                         olkr_init_op **out_op) {
+    if (!master_password || !out_op) return OLKR_ERR_INVALID_ARG;
+    session_end();
+
+    olkr_init_op *op = (olkr_init_op *)calloc(1, sizeof(*op));
+    if (!op) return OLKR_ERR_OOM;
+    op->cb = cb;
+    op->user = user;
+    op->password = strdup(master_password);
+    if (!op->password || pipe(op->fds) != 0) {
+        if (op->password) secure_wipe(op->password, strlen(op->password));
+        free(op->password);
+        free(op);
+        return OLKR_ERR_OOM;
+    }
+    fcntl(op->fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(op->fds[1], F_SETFD, FD_CLOEXEC);
+
+    if (pthread_create(&op->thread, NULL, init_thread, op) != 0) {
+        close(op->fds[0]);
+        close(op->fds[1]);
+        secure_wipe(op->password, strlen(op->password));
+        free(op->password);
+        free(op);
+        return OLKR_ERR_OOM;
+    }
+    *out_op = op;
+    return OLKR_OK;
+}
+
+int openlockr_init_fd(const olkr_init_op *op) {
+    return op ? op->fds[0] : -1;
+}
+
+int openlockr_init_finish(olkr_init_op *op) {
+    if (!op) return OLKR_ERR_INVALID_ARG;
+    pthread_join(op->thread, NULL);
+    int rc = op->rc;
+    close(op->fds[0]);
+    close(op->fds[1]);
+    free(op);
+    return rc;
+}
+
+/**
+ * Re-wrap the data key for `new_password` with `kdf`, after checking
+ * `old_password` against the loaded DEK. Entries are untouched.
+ */
+static int dek_rewrap(const char *old_password, const char *new_password,
+                      const olkr_kdf_params *kdf) {
+    char *wrapped = NULL;
+    if (localdb_get_meta(META_DEK, &wrapped) != 0) return OLKR_ERR_STORAGE;
+
+    uint8_t dek[KEY_LEN_BYTES];
+    olkr_kdf_params old_kdf;
+    int rc = dek_unwrap(old_password, wrapped, dek, &old_kdf);
+    if (rc == OLKR_OK && memcmp(dek, g_ctx.key, KEY_LEN_BYTES) != 0) rc = OLKR_ERR_CRYPTO;
+    secure_wipe(dek, sizeof(dek));
+    free(wrapped);
+    wrapped = NULL;
+
+    if (rc == OLKR_OK) rc = dek_wrap(new_password, kdf, g_ctx.key, &wrapped);
+    if (rc == OLKR_OK && localdb_put_meta(META_DEK, wrapped) != 0) rc = OLKR_ERR_STORAGE;
+    if (rc == OLKR_OK) {
+        g_ctx.kdf = *kdf;
+        rc = dek_publish(wrapped);
+    }
+    free(wrapped);
+    return rc;
+}
+
+int openlockr_change_password(const char *old_password, const char *new_password) {
+    if (!g_ctx.initialized || !old_password || !new_password) return OLKR_ERR_INVALID_ARG;
+    olkr_kdf_params kdf = g_ctx.kdf;
+    return dek_rewrap(old_password, new_password, &kdf);
+}
+
+int openlockr_set_kdf(const char *master_password, const olkr_kdf_params *kdf) {
+    if (!g_ctx.initialized || !master_password || !kdf) return OLKR_ERR_INVALID_ARG;
+
+    // PBKDF2 has no memory or lane cost; keep the header canonical
+    olkr_kdf_params k = *kdf;
+    if (k.algorithm == OLKR_KDF_PBKDF2) k.memory_kib = k.lanes = 0;
+    if (!kdf_valid(&k)) return OLKR_ERR_INVALID_ARG;
+    return dek_rewrap(master_password, master_password, &k);
+}
+
+int openlockr_get_kdf(olkr_kdf_params *out_kdf) {
+    if (!g_ctx.initialized || !out_kdf) return OLKR_ERR_INVALID_ARG;
+    *out_kdf = g_ctx.kdf;
+    return OLKR_OK;
+}
+
+int openlockr_set_kdf_target(uint32_t target_ms) {
+    if (target_ms > KDF_MAX_TARGET_MS) return OLKR_ERR_INVALID_ARG;
+    g_kdf_target_ms = target_ms ? target_ms : OLKR_KDF_TARGET_MS;
+    return OLKR_OK;
+}
+
+int openlockr_calibrate_kdf(uint32_t algorithm, uint32_t target_ms, olkr_kdf_params *out_kdf) {
+    if (!out_kdf || target_ms > KDF_MAX_TARGET_MS) return OLKR_ERR_INVALID_ARG;
+    return kdf_calibrate(algorithm, target_ms ? target_ms : g_kdf_target_ms, out_kdf);
+}
+
+/*=============================================================================
+  Subkeys
+=============================================================================*/
+
+/**
+ * Copy the subkey for `label` from the cache, deriving it on a miss.
+ * A full cache replaces its slots round-robin.
+ */
+int openlockr_subkey(const char *label, uint8_t out_key[OLKR_SUBKEY_LEN]) {
+    if (!g_ctx.initialized || !label || !out_key) return OLKR_ERR_INVALID_ARG;
+    size_t label_len = strlen(label);
+    if (label_len == 0 || label_len > SUBKEY_LABEL_MAX) return OLKR_ERR_INVALID_ARG;
+
+    int rc = OLKR_OK;
+    pthread_mutex_lock(&g_subkey_lock);
+
+    subkey_slot *slot = NULL;
+    for (size_t i = 0; i < SUBKEY_SLOTS && !slot; i++) {
+        if (strcmp(g_ctx.subkeys[i].label, label) == 0) slot = &g_ctx.subkeys[i];
+    }
+    if (!slot) {
+        slot = &g_ctx.subkeys[g_ctx.subkey_next];
+        g_ctx.subkey_next = (g_ctx.subkey_next + 1) % SUBKEY_SLOTS;
+        if (hkdf_sha256_expand(g_ctx.subkey_prk, HKDF_SHA256_PRK_LEN,
+                               (const uint8_t *)label, label_len,
+                               slot->key, OLKR_SUBKEY_LEN) == 0) {
+            memcpy(slot->label, label, label_len + 1);
+        } else {
+            memset(slot, 0, sizeof(*slot));
+            rc = OLKR_ERR_CRYPTO;
+        }
+    }
+    if (rc == OLKR_OK) memcpy(out_key, slot->key, OLKR_SUBKEY_LEN);
+
+    pthread_mutex_unlock(&g_subkey_lock);
+    return rc;
+}
+
+/*=============================================================================
+  AEAD dispatch: the algorithm is named by a record's version byte
+=============================================================================*/
+
+typedef union {
+    aes_gcm_stream           gcm;
+    chacha20_poly1305_stream chacha;
+} aead_state;
+
+// Start the AEAD named by `version` under the vault key
+static int aead_start(aead_state *a, uint8_t version, const uint8_t *nonce,
+                      const uint8_t *aad, size_t aad_len, int decrypt) {
+    switch (version) {
+    case RECORD_VERSION_GCM:
+        return aes_256_gcm_stream_init(&a->gcm, g_ctx.cipher, nonce,
+                                       aad, aad_len, decrypt);
+    case RECORD_VERSION_CHACHA:
+        return chacha20_poly1305_stream_init(&a->chacha, g_ctx.key, nonce,
+                                             aad, aad_len, decrypt);
+    default:
+        return -1;
+    }
+}
+
+// Start the AEAD named by header[0] with the nonce in header[1..]
+static int aead_init(aead_state *a, const uint8_t *header, int decrypt) {
+    return aead_start(a, header[0], header + 1, header, 1, decrypt);   // version byte as AAD
+}
+
+static int aead_update(aead_state *a, uint8_t version,
+                       const uint8_t *in, size_t len, uint8_t *out) {
+    return version == RECORD_VERSION_CHACHA
+         ? chacha20_poly1305_stream_update(&a->chacha, in, len, out)
+         : aes_256_gcm_stream_update(&a->gcm, in, len, out);
+}
+
+static int aead_final(aead_state *a, uint8_t version, uint8_t *tag) {
+    return version == RECORD_VERSION_CHACHA
+         ? chacha20_poly1305_stream_final(&a->chacha, tag)
+         : aes_256_gcm_stream_final(&a->gcm, tag);
+}
+
+/*=============================================================================
+  Records
+=============================================================================*/
+
 /**
- * Encrypt plaintext into a Base64-encoded ciphertext.
+ * Seal a record in place with the vault's AEAD. The plaintext must already
+ * sit at rec + RECORD_HEADER_LEN; `rec` must hold RECORD_OVERHEAD + plain_len
+ * bytes and ends up as version || nonce || ciphertext || tag.
+ */
+static int record_seal(uint8_t *rec, size_t plain_len) {
+    rec[0] = g_ctx.aead;
+    if (random_bytes(rec + 1, AES_GCM_NONCE_LEN) != 0) return -1;
+
+    uint8_t *ct = rec + RECORD_HEADER_LEN;
+    aead_state a;
+    if (aead_init(&a, rec, 0) != 0 ||
+        aead_update(&a, rec[0], ct, plain_len, ct) < 0 ||
+        aead_final(&a, rec[0], ct + plain_len) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Could `rec` be an AEAD record? (Legacy blobs may still collide.)
+static int record_is_aead(const uint8_t *rec, size_t rec_len) {
+    return rec_len >= RECORD_OVERHEAD &&
+           (rec[0] == RECORD_VERSION_GCM || rec[0] == RECORD_VERSION_CHACHA ||
+            rec[0] == RECORD_VERSION_SIV);
+}
+
+// Could `rec` be a legacy CBC blob? Never outside a legacy vault, where
+// every record must be AEAD.
+static int record_is_cbc(size_t rec_len) {
+    return g_ctx.legacy_cbc && rec_len != 0 && rec_len % IV_LEN_BYTES == 0;
+}
+
+/**
+ * Verify and decrypt an AEAD record in place, using the AEAD named by its
+ * version byte (not the vault default). The plaintext is moved to the start
+ * of `rec`. On failure the keystream is applied again, which restores the
+ * ciphertext so the record can still be tried as a legacy CBC blob.
+ * @return plaintext length, or -1 on failure.
+ */
+static int record_open_aead(uint8_t *rec, size_t rec_len) {
+    size_t ct_len = rec_len - RECORD_OVERHEAD;
+    uint8_t *ct = rec + RECORD_HEADER_LEN;
+    if (ct_len > (size_t)INT_MAX) return -1;
+
+    // GCM-SIV is two-pass; it restores the ciphertext itself on failure
+    if (rec[0] == RECORD_VERSION_SIV) {
+        if (aes_256_gcm_siv_decrypt_keyed(g_ctx.cipher, rec + 1, rec, 1,
+                                          ct, ct_len, ct + ct_len, ct) < 0) {
+            return -1;
+        }
+        memmove(rec, ct, ct_len);
+        return (int)ct_len;
+    }
+
+    aead_state a;
+    if (aead_init(&a, rec, 1) != 0) return -1;
+
+    aead_update(&a, rec[0], ct, ct_len, ct);
+    if (aead_final(&a, rec[0], ct + ct_len) == 0) {
+        memmove(rec, ct, ct_len);
+        return (int)ct_len;
+    }
+
+    uint8_t unused_tag[AES_GCM_TAG_LEN];
+    aead_init(&a, rec, 0);
+    aead_update(&a, rec[0], ct, ct_len, ct);
+    aead_final(&a, rec[0], unused_tag);
+    return -1;
+}
+
+/**
+ * Open a record in place; the plaintext is left at the start of `rec`.
+ * AEAD records are verified first, and one that fails verification is
+ * rejected. Only in a legacy vault, where a CBC blob may start with a
+ * version byte by chance, is such a lookalike (or anything else) tried as a
+ * legacy CBC blob.
+ * @return plaintext length, or -1 on failure.
+ */
+static int record_open(uint8_t *rec, size_t rec_len) {
+    if (record_is_aead(rec, rec_len)) {
+        int dec_len = record_open_aead(rec, rec_len);
+        if (dec_len >= 0 || !g_ctx.legacy_cbc) return dec_len;
+    }
+
+    // Legacy AES-256-CBC blob with the fixed zero IV
+    if (!record_is_cbc(rec_len)) return -1;
+    return aes_256_cbc_decrypt_inplace(g_ctx.cipher, g_ctx.iv, rec, rec_len);
+}
+
+/**
+ * Copy a Base64 record into one malloc'd buffer and decode it in place.
+ * The buffer keeps room for a NUL after the decoded record, so the plaintext
+ * can later be returned from it directly. Caller must free(*out_rec).
+ */
+static int record_decode(const char *b64, uint8_t **out_rec, size_t *rec_len) {
+    size_t b64_len = strlen(b64);
+    char *buf = malloc(b64_len + 1);
+    if (!buf) return OLKR_ERR_OOM;
+    memcpy(buf, b64, b64_len);
+
+    *out_rec = base64_decode_inplace(buf, b64_len, rec_len);
+    if (!*out_rec) {
+        free(buf);
+        return OLKR_ERR_CRYPTO;
+    }
+    return OLKR_OK;
+}
+
+/**
+ * Encrypt plaintext into a Base64-encoded record under the vault's AEAD.
+ * The record is sealed and Base64-expanded within a single allocation.
  * Caller must free(*out_b64).
  */
 int openlockr_lock(const char *plain, char **out_b64) {
     if (!g_ctx.initialized || !plain || !out_b64) return OLKR_ERR_INVALID_ARG;
 
     size_t plain_len = strlen(plain);
-    // Allocate buffer for cipher: ciphertext length = plain_len + AES block size
-    size_t cipher_buf_len = plain_len + IV_LEN_BYTES;
-    uint8_t *cipher_buf = malloc(cipher_buf_len);
-    if (!cipher_buf) return OLKR_ERR_OOM;
-
-    // Perform AES-256-CBC encryption
-    int cipher_len = aes_256_cbc_encrypt(
-        g_ctx.key, IV_LEN_BYTES, g_ctx.iv,
-        (const uint8_t *)plain, plain_len,
-        cipher_buf
-    );
-    if (cipher_len < 0) {
-        free(cipher_buf);
+    // Record = version byte + nonce + ciphertext (same length as plain) + tag
+    size_t rec_len = RECORD_OVERHEAD + plain_len;
+    size_t b64_len = base64_encoded_len(rec_len);
+    uint8_t *buf = malloc(b64_len + 1);
+    if (!buf) return OLKR_ERR_OOM;
+
+    memcpy(buf + RECORD_HEADER_LEN, plain, plain_len);
+    if (record_seal(buf, plain_len) != 0) {
+        memset(buf, 0, rec_len);
+        free(buf);
         return OLKR_ERR_CRYPTO;
     }
 
-    // Base64-encode the cipher blob
-    size_t b64_len = 0;
-    *out_b64 = base64_encode(cipher_buf, cipher_len, &b64_len);
-    free(cipher_buf);
-    if (!*out_b64) return OLKR_ERR_CRYPTO;
+    // Base64-encode the record over itself
+    *out_b64 = base64_encode_inplace(buf, rec_len, b64_len + 1, &b64_len);
+    if (!*out_b64) {
+        memset(buf, 0, rec_len);
+        free(buf);
+        return OLKR_ERR_CRYPTO;
+    }
+    return OLKR_OK;
+}
 
+/**
+ * Encrypt plaintext deterministically (AES-256-GCM-SIV, fixed nonce), so
+ * identical plaintexts give identical records. Same single-allocation layout
+ * as openlockr_lock(). Caller must free(*out_b64).
+ */
+int openlockr_lock_dedupe(const char *plain, char **out_b64) {
+    if (!g_ctx.initialized || !plain || !out_b64) return OLKR_ERR_INVALID_ARG;
+
+    size_t plain_len = strlen(plain);
+    size_t rec_len = RECORD_OVERHEAD + plain_len;
+    size_t b64_len = base64_encoded_len(rec_len);
+    uint8_t *buf = malloc(b64_len + 1);
+    if (!buf) return OLKR_ERR_OOM;
+
+    uint8_t *ct = buf + RECORD_HEADER_LEN;
+    buf[0] = RECORD_VERSION_SIV;
+    memcpy(buf + 1, DEDUPE_NONCE, AES_GCM_SIV_NONCE_LEN);
+    memcpy(ct, plain, plain_len);
+    if (aes_256_gcm_siv_encrypt_keyed(g_ctx.cipher, DEDUPE_NONCE, buf, 1,
+                                      ct, plain_len, ct, ct + plain_len) < 0) {
+        memset(buf, 0, rec_len);
+        free(buf);
+        return OLKR_ERR_CRYPTO;
+    }
+
+    *out_b64 = base64_encode_inplace(buf, rec_len, b64_len + 1, &b64_len);
+    if (!*out_b64) {
+        memset(buf, 0, rec_len);
+        free(buf);
+        return OLKR_ERR_CRYPTO;
+    }
     return OLKR_OK;
 }
 
 /**
- * Decrypt a Base64-encoded ciphertext back into plaintext.
+ * Decrypt a Base64-encoded record (or legacy CBC blob) back into plaintext.
+ * Decoding and decryption happen in place within a single allocation.
  * Caller must free(*out_plain).
  */
 int openlockr_unlock(const char *b64_cipher, char **out_plain) {
     if (!g_ctx.initialized || !b64_cipher || !out_plain) return OLKR_ERR_INVALID_ARG;
 
-    // Base64-decode
-    size_t cipher_len = 0;
-    uint8_t *cipher_buf = base64_decode(b64_cipher, strlen(b64_cipher), &cipher_len);
-    if (!cipher_buf) return OLKR_ERR_CRYPTO;
+    uint8_t *rec = NULL;
+    size_t rec_len = 0;
+    int rc = record_decode(b64_cipher, &rec, &rec_len);
+    if (rc != OLKR_OK) return rc;
 
-    // Allocate plaintext buffer
-    size_t plain_buf_len = cipher_len;
-    uint8_t *plain_buf = malloc(plain_buf_len + 1);
-    if (!plain_buf) {
-        free(cipher_buf);
+    int dec_len = record_open(rec, rec_len);
+    if (dec_len < 0) {
+        free(rec);
+        return OLKR_ERR_CRYPTO;
+    }
+
+    // Null-terminate and return
+    rec[dec_len] = '\0';
+    *out_plain = (char *)rec;
+    return OLKR_OK;
+}
+
+/**
+ * Decrypt many records at once. AEAD records are opened individually; every
+ * legacy CBC blob is collected and handed to the interleaved batch decryptor.
+ * Each entry is decoded and decrypted in place in one allocation.
+ * Caller must free() each non-NULL out_plains[i].
+ */
+int openlockr_unlock_batch(const char *const *b64_ciphers, size_t count,
+                           char **out_plains) {
+    if (!g_ctx.initialized || (count && (!b64_ciphers || !out_plains))) {
+        return OLKR_ERR_INVALID_ARG;
+    }
+
+    int first_err = OLKR_OK;
+    aes_cbc_batch_item *cbc = calloc(count ? count : 1, sizeof(*cbc));
+    size_t *cbc_index = calloc(count ? count : 1, sizeof(*cbc_index));
+    if (!cbc || !cbc_index) {
+        free(cbc);
+        free(cbc_index);
         return OLKR_ERR_OOM;
     }
+    size_t ncbc = 0;
 
-    // AES-256-CBC decrypt
-    int dec_len = aes_256_cbc_decrypt(
-        g_ctx.key, IV_LEN_BYTES, g_ctx.iv,
-        cipher_buf, cipher_len,
-        plain_buf
-    );
-    free(cipher_buf);
-    if (dec_len < 0) {
-        free(plain_buf);
+    for (size_t i = 0; i < count; i++) {
+        out_plains[i] = NULL;
+        if (!b64_ciphers[i]) {
+            if (first_err == OLKR_OK) first_err = OLKR_ERR_INVALID_ARG;
+            continue;
+        }
+
+        uint8_t *rec = NULL;
+        size_t rec_len = 0;
+        int rc = record_decode(b64_ciphers[i], &rec, &rec_len);
+        if (rc != OLKR_OK) {
+            if (first_err == OLKR_OK) first_err = rc;
+            continue;
+        }
+
+        int aead = record_is_aead(rec, rec_len);
+        if (aead) {
+            int dec_len = record_open_aead(rec, rec_len);
+            if (dec_len >= 0) {
+                rec[dec_len] = '\0';
+                out_plains[i] = (char *)rec;
+                continue;
+            }
+        }
+        // As in record_open(): a failed AEAD record gets no CBC retry
+        // outside a legacy vault
+        if ((aead && !g_ctx.legacy_cbc) || !record_is_cbc(rec_len)) {
+            free(rec);
+            if (first_err == OLKR_OK) first_err = OLKR_ERR_CRYPTO;
+            continue;
+        }
+
+        // Defer to the batch, decrypting in place
+        cbc[ncbc].iv = g_ctx.iv;
+        cbc[ncbc].ciphertext = rec;
+        cbc[ncbc].ciphertext_len = rec_len;
+        cbc[ncbc].plaintext = rec;
+        cbc_index[ncbc++] = i;
+    }
+
+    if (ncbc) aes_256_cbc_decrypt_batch(g_ctx.cipher, cbc, ncbc);
+
+    for (size_t j = 0; j < ncbc; j++) {
+        if (cbc[j].result < 0) {
+            free(cbc[j].plaintext);
+            if (first_err == OLKR_OK) first_err = OLKR_ERR_CRYPTO;
+            continue;
+        }
+        cbc[j].plaintext[cbc[j].result] = '\0';
+        out_plains[cbc_index[j]] = (char *)cbc[j].plaintext;
+    }
+
+    free(cbc);
+    free(cbc_index);
+    return first_err;
+}
+
+/*=============================================================================
+  Streaming API
+=============================================================================*/
+
+#define STREAM_CHUNK  4096   // output buffer; bounds peak memory per stream
+
+struct olkr_stream {
+    aead_state     aead;
+    olkr_sink_fn   sink;
+    void          *user;
+    int            direction;
+    int            status;                        // sticky first error
+    uint8_t        header[RECORD_HEADER_LEN];     // version || nonce
+    size_t         header_len;                    // decrypt: header bytes seen
+    uint8_t        tail[AES_GCM_TAG_LEN];         // decrypt: held back, may be the tag
+    size_t         tail_len;
+    uint8_t        buf[STREAM_CHUNK];
+};
+
+// Run `len` bytes through the AEAD and hand the result to the sink
+static int stream_process(olkr_stream *s, const uint8_t *in, size_t len) {
+    while (len > 0 && s->status == OLKR_OK) {
+        size_t n = len < STREAM_CHUNK ? len : STREAM_CHUNK;
+        if (aead_update(&s->aead, s->header[0], in, n, s->buf) < 0) {
+            s->status = OLKR_ERR_CRYPTO;
+            break;
+        }
+        int rc = s->sink(s->user, s->buf, n);
+        if (rc != OLKR_OK) s->status = rc;
+        in  += n;
+        len -= n;
+    }
+    return s->status;
+}
+
+int olkr_stream_begin(int direction, olkr_sink_fn sink, void *user,
+                      olkr_stream **out_stream) {
+    if (!g_ctx.initialized || !sink || !out_stream ||
+        (direction != OLKR_STREAM_ENCRYPT && direction != OLKR_STREAM_DECRYPT)) {
+        return OLKR_ERR_INVALID_ARG;
+    }
+
+    olkr_stream *s = calloc(1, sizeof(*s));
+    if (!s) return OLKR_ERR_OOM;
+    s->sink = sink;
+    s->user = user;
+    s->direction = direction;
+
+    if (direction == OLKR_STREAM_ENCRYPT) {
+        s->header[0] = g_ctx.aead;
+        if (random_bytes(s->header + 1, AES_GCM_NONCE_LEN) != 0 ||
+            aead_init(&s->aead, s->header, 0) != 0) {
+            secure_wipe(s, sizeof(*s));
+            free(s);
+            return OLKR_ERR_CRYPTO;
+        }
+        int rc = sink(user, s->header, RECORD_HEADER_LEN);
+        if (rc != OLKR_OK) {
+            secure_wipe(s, sizeof(*s));
+            free(s);
+            return rc;
+        }
+    }
+
+    *out_stream = s;
+    return OLKR_OK;
+}
+
+int olkr_stream_update(olkr_stream *s, const uint8_t *data, size_t len) {
+    if (!s || (!data && len)) return OLKR_ERR_INVALID_ARG;
+    if (s->status != OLKR_OK) return s->status;
+
+    if (s->direction == OLKR_STREAM_ENCRYPT) {
+        return stream_process(s, data, len);
+    }
+
+    // Decrypt: collect the header first
+    while (s->header_len < RECORD_HEADER_LEN && len > 0) {
+        s->header[s->header_len++] = *data++;
+        len--;
+        if (s->header_len == RECORD_HEADER_LEN && aead_init(&s->aead, s->header, 1) != 0) {
+            return s->status = OLKR_ERR_CRYPTO;
+        }
+    }
+
+    // Always hold back the last AES_GCM_TAG_LEN bytes seen: they may be the tag
+    if (s->tail_len + len <= AES_GCM_TAG_LEN) {
+        memcpy(s->tail + s->tail_len, data, len);
+        s->tail_len += len;
+        return OLKR_OK;
+    }
+    size_t emit = s->tail_len + len - AES_GCM_TAG_LEN;
+    size_t from_tail = emit < s->tail_len ? emit : s->tail_len;
+    if (stream_process(s, s->tail, from_tail) != OLKR_OK) return s->status;
+    memmove(s->tail, s->tail + from_tail, s->tail_len - from_tail);
+    s->tail_len -= from_tail;
+    emit -= from_tail;
+
+    if (stream_process(s, data, emit) != OLKR_OK) return s->status;
+    memcpy(s->tail + s->tail_len, data + emit, len - emit);
+    s->tail_len += len - emit;
+    return OLKR_OK;
+}
+
+int olkr_stream_finish(olkr_stream *s) {
+    if (!s) return OLKR_ERR_INVALID_ARG;
+
+    int rc = s->status;
+    if (rc == OLKR_OK) {
+        if (s->direction == OLKR_STREAM_ENCRYPT) {
+            uint8_t tag[AES_GCM_TAG_LEN];
+            rc = aead_final(&s->aead, s->header[0], tag) == 0
+               ? s->sink(s->user, tag, AES_GCM_TAG_LEN)
+               : OLKR_ERR_CRYPTO;
+        } else if (s->header_len < RECORD_HEADER_LEN || s->tail_len < AES_GCM_TAG_LEN ||
+                   aead_final(&s->aead, s->header[0], s->tail) != 0) {
+            rc = OLKR_ERR_CRYPTO;
+        }
+    }
+
+    secure_wipe(s, sizeof(*s));
+    free(s);
+    return rc;
+}
+
+/*=============================================================================
+  Chunked attachments
+=============================================================================*/
+
+// Container layout (all integers little-endian):
+//   header: magic "OLKA" | format | aead | chunk_shift | 0 | nonce prefix (8)
+//           | plaintext length (8) | header tag (16)
+//   chunks: ciphertext (chunk_len, the last one shorter) || tag (16), ...
+// Chunk i is sealed under nonce prefix || LE32(i) with the 24 header bytes
+// before the tag as AAD; the header tag seals an empty message under index
+// ATTACH_HEADER_INDEX. Every chunk is therefore bound to its position and to
+// the file's length, so chunks cannot be reordered, spliced or truncated.
+#define ATTACH_MAGIC         "OLKA"
+#define ATTACH_FORMAT        0x01
+#define ATTACH_CHUNK_SHIFT   16                          // 64 KiB chunks
+#define ATTACH_MIN_SHIFT     12
+#define ATTACH_MAX_SHIFT     24
+#define ATTACH_PREFIX_LEN    8
+#define ATTACH_AAD_LEN       24                          // header without its tag
+#define ATTACH_HEADER_LEN    (ATTACH_AAD_LEN + AES_GCM_TAG_LEN)
+#define ATTACH_HEADER_INDEX  UINT32_MAX
+#define ATTACH_MAX_CHUNKS    ((uint64_t)UINT32_MAX)      // indexes 0 .. 2^32 - 2
+#define ATTACH_MAX_BATCH     16                          // chunks sealed per parallel pass
+
+struct olkr_attach_writer {
+    olkr_sink_fn  sink;
+    void         *user;
+    int           status;                  // sticky first error
+    uint8_t       header[ATTACH_AAD_LEN];
+    uint64_t      size;                    // declared plaintext length
+    uint64_t      written;                 // plaintext bytes accepted so far
+    uint32_t      index;                   // first chunk of the current batch
+    size_t        batch;                   // chunk slots in buf
+    size_t        fill;                    // plaintext bytes in the batch
+    uint8_t      *buf;                     // `batch` slots of chunk + tag
+};
+
+struct olkr_attach {
+    int       fd;
+    uint8_t   header[ATTACH_AAD_LEN];
+    size_t    chunk_len;
+    uint64_t  size;
+    uint64_t  cached;                      // chunk held in buf, or UINT64_MAX
+    uint8_t  *buf;                         // one sealed chunk: chunk_len + tag
+};
+
+/**
+ * Seal (decrypt = 0) or open (decrypt = 1) one chunk of an attachment in
+ * place. `header` is the AAD and supplies the AEAD and nonce prefix. A chunk
+ * that fails to open is wiped.
+ * @return 0 on success, -1 on failure.
+ */
+static int attach_chunk_crypt(const uint8_t *header, uint32_t index,
+                              uint8_t *data, size_t len, uint8_t *tag, int decrypt) {
+    uint8_t nonce[AES_GCM_NONCE_LEN];
+    memcpy(nonce, header + 8, ATTACH_PREFIX_LEN);
+    store32_le(nonce + ATTACH_PREFIX_LEN, index);
+
+    aead_state a;
+    uint8_t version = header[5];
+    if (aead_start(&a, version, nonce, header, ATTACH_AAD_LEN, decrypt) != 0 ||
+        aead_update(&a, version, data, len, data) < 0 ||
+        aead_final(&a, version, tag) != 0) {
+        if (decrypt) memset(data, 0, len);
+        return -1;
+    }
+    return 0;
+}
+
+// Plaintext length of chunk `index`
+static size_t attach_chunk_len(uint64_t size, size_t chunk_len, uint64_t index) {
+    uint64_t start = index * chunk_len;
+    return size - start < chunk_len ? (size_t)(size - start) : chunk_len;
+}
+
+// Chunks [first, first + count) of one attachment, for thread_pool_run().
+// Chunk first + i sits at slot i of buf, `stride` bytes apart, with its tag
+// right after its data; only the last chunk may be shorter than chunk_len.
+typedef struct {
+    const uint8_t *header;
+    uint32_t       first;
+    size_t         count;
+    size_t         chunk_len;
+    size_t         last_len;
+    size_t         stride;
+    uint8_t       *buf;
+} attach_batch;
+
+static int attach_seal_task(void *arg, size_t i) {
+    const attach_batch *b = arg;
+    uint8_t *slot = b->buf + i * b->stride;
+    size_t len = i + 1 == b->count ? b->last_len : b->chunk_len;
+    return attach_chunk_crypt(b->header, b->first + (uint32_t)i, slot, len, slot + len, 0) == 0
+         ? OLKR_OK : OLKR_ERR_CRYPTO;
+}
+
+// Seal the buffered chunks on the pool and emit them in order. Every slot
+// but the last is full, so the sealed batch is one contiguous run.
+static int attach_flush(olkr_attach_writer *w) {
+    const size_t chunk_len = (size_t)1 << ATTACH_CHUNK_SHIFT;
+    attach_batch b = {
+        w->header, w->index, (w->fill + chunk_len - 1) / chunk_len, chunk_len,
+        0, chunk_len + AES_GCM_TAG_LEN, w->buf,
+    };
+    b.last_len = w->fill - (b.count - 1) * chunk_len;
+
+    int rc = thread_pool_run(b.count, attach_seal_task, &b);
+    if (rc == OLKR_OK) {
+        rc = w->sink(w->user, w->buf, (b.count - 1) * b.stride + b.last_len + AES_GCM_TAG_LEN);
+    }
+    if (rc != OLKR_OK) return w->status = rc;
+    w->index += (uint32_t)b.count;
+    w->fill = 0;
+    return OLKR_OK;
+}
+
+static void attach_writer_free(olkr_attach_writer *w) {
+    if (w->buf) {
+        secure_wipe(w->buf, w->batch * (((size_t)1 << ATTACH_CHUNK_SHIFT) + AES_GCM_TAG_LEN));
+        free(w->buf);
+    }
+    secure_wipe(w, sizeof(*w));
+    free(w);
+}
+
+int olkr_attach_begin(uint64_t size, olkr_sink_fn sink, void *user,
+                      olkr_attach_writer **out_writer) {
+    const size_t chunk_len = (size_t)1 << ATTACH_CHUNK_SHIFT;
+    if (!g_ctx.initialized || !sink || !out_writer ||
+        size / chunk_len >= ATTACH_MAX_CHUNKS) {
+        return OLKR_ERR_INVALID_ARG;
+    }
+
+    olkr_attach_writer *w = calloc(1, sizeof(*w));
+    if (!w) return OLKR_ERR_OOM;
+    w->sink = sink;
+    w->user = user;
+    w->size = size;
+
+    // Two chunks per thread keeps every core busy while the batch stays small
+    w->batch = 2 * thread_pool_threads();
+    if (w->batch > ATTACH_MAX_BATCH) w->batch = ATTACH_MAX_BATCH;
+    w->buf = malloc(w->batch * (chunk_len + AES_GCM_TAG_LEN));
+    if (!w->buf) {
+        free(w);
+        return OLKR_ERR_OOM;
+    }
+
+    uint8_t header[ATTACH_HEADER_LEN] = ATTACH_MAGIC;
+    header[4] = ATTACH_FORMAT;
+    header[5] = g_ctx.aead;
+    header[6] = ATTACH_CHUNK_SHIFT;
+    store64_le(header + 16, size);
+    memcpy(w->header, header, ATTACH_AAD_LEN);
+
+    int rc = OLKR_ERR_CRYPTO;
+    if (random_bytes(w->header + 8, ATTACH_PREFIX_LEN) == 0 &&
+        attach_chunk_crypt(w->header, ATTACH_HEADER_INDEX, NULL, 0,
+                           header + ATTACH_AAD_LEN, 0) == 0) {
+        memcpy(header + 8, w->header + 8, ATTACH_PREFIX_LEN);
+        rc = sink(user, header, ATTACH_HEADER_LEN);
+    }
+    if (rc != OLKR_OK) {
+        attach_writer_free(w);
+        return rc;
+    }
+
+    *out_writer = w;
+    return OLKR_OK;
+}
+
+int olkr_attach_write(olkr_attach_writer *w, const uint8_t *data, size_t len) {
+    if (!w || (!data && len)) return OLKR_ERR_INVALID_ARG;
+    if (w->status != OLKR_OK) return w->status;
+    if (len > w->size - w->written) return w->status = OLKR_ERR_INVALID_ARG;
+
+    const size_t chunk_len = (size_t)1 << ATTACH_CHUNK_SHIFT;
+    while (len > 0) {
+        size_t slot = w->fill / chunk_len, in_chunk = w->fill % chunk_len;
+        size_t n = chunk_len - in_chunk;
+        if (n > len) n = len;
+        memcpy(w->buf + slot * (chunk_len + AES_GCM_TAG_LEN) + in_chunk, data, n);
+        w->fill += n;
+        w->written += n;
+        data += n;
+        len -= n;
+        if (w->fill == w->batch * chunk_len && attach_flush(w) != OLKR_OK) return w->status;
+    }
+    return OLKR_OK;
+}
+
+int olkr_attach_finish(olkr_attach_writer *w) {
+    if (!w) return OLKR_ERR_INVALID_ARG;
+
+    int rc = w->status;
+    if (rc == OLKR_OK) {
+        if (w->written != w->size) {
+            rc = OLKR_ERR_INVALID_ARG;
+        } else if (w->fill > 0) {
+            rc = attach_flush(w);
+        }
+    }
+
+    attach_writer_free(w);
+    return rc;
+}
+
+// pread() exactly `len` bytes; a short file is reported as corruption
+static int pread_full(int fd, uint8_t *buf, size_t len, uint64_t pos) {
+    while (len > 0) {
+        off_t off = (off_t)pos;
+        if (off < 0 || (uint64_t)off != pos) return OLKR_ERR_STORAGE;
+        ssize_t n = pread(fd, buf, len, off);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return OLKR_ERR_STORAGE;
+        if (n == 0) return OLKR_ERR_CRYPTO;
+        buf += n;
+        len -= (size_t)n;
+        pos += (uint64_t)n;
+    }
+    return OLKR_OK;
+}
+
+// Read chunk `index` and open it into `out`
+static int attach_load_chunk(olkr_attach *a, uint64_t index, uint8_t *out) {
+    size_t len = attach_chunk_len(a->size, a->chunk_len, index);
+    uint64_t pos = ATTACH_HEADER_LEN + index * (a->chunk_len + AES_GCM_TAG_LEN);
+    uint8_t tag[AES_GCM_TAG_LEN];
+
+    int rc = pread_full(a->fd, out, len, pos);
+    if (rc == OLKR_OK) rc = pread_full(a->fd, tag, AES_GCM_TAG_LEN, pos + len);
+    if (rc == OLKR_OK &&
+        attach_chunk_crypt(a->header, (uint32_t)index, out, len, tag, 1) != 0) {
+        rc = OLKR_ERR_CRYPTO;
+    }
+    if (rc != OLKR_OK) memset(out, 0, len);
+    return rc;
+}
+
+// Reader side of attach_batch: chunk first + i is opened into slot i
+typedef struct {
+    olkr_attach *a;
+    uint64_t     first;
+    uint8_t     *out;
+    size_t       chunk_len;
+} attach_read_batch;
+
+static int attach_open_task(void *arg, size_t i) {
+    const attach_read_batch *b = arg;
+    return attach_load_chunk(b->a, b->first + i, b->out + i * b->chunk_len);
+}
+
+int olkr_attach_open(int fd, olkr_attach **out_attach) {
+    if (!g_ctx.initialized || fd < 0 || !out_attach) return OLKR_ERR_INVALID_ARG;
+
+    uint8_t header[ATTACH_HEADER_LEN];
+    int rc = pread_full(fd, header, ATTACH_HEADER_LEN, 0);
+    if (rc != OLKR_OK) return rc;
+
+    uint8_t shift = header[6];
+    uint64_t size = load64_le(header + 16);
+    if (memcmp(header, ATTACH_MAGIC, 4) != 0 || header[4] != ATTACH_FORMAT ||
+        shift < ATTACH_MIN_SHIFT || shift > ATTACH_MAX_SHIFT ||
+        (size >> shift) >= ATTACH_MAX_CHUNKS ||
+        attach_chunk_crypt(header, ATTACH_HEADER_INDEX, NULL, 0,
+                           header + ATTACH_AAD_LEN, 1) != 0) {
         return OLKR_ERR_CRYPTO;
     }
 
-    // Null-terminate and return
-    plain_buf[dec_len] = '\0';
-    *out_plain = (char *)plain_buf;
+    olkr_attach *a = calloc(1, sizeof(*a));
+    if (!a) return OLKR_ERR_OOM;
+    a->chunk_len = (size_t)1 << shift;
+    a->buf = malloc(a->chunk_len);
+    if (!a->buf) {
+        free(a);
+        return OLKR_ERR_OOM;
+    }
+    a->fd = fd;
+    memcpy(a->header, header, ATTACH_AAD_LEN);
+    a->size = size;
+    a->cached = UINT64_MAX;
+
+    *out_attach = a;
+    return OLKR_OK;
+}
+
+uint64_t olkr_attach_size(const olkr_attach *a) {
+    return a ? a->size : 0;
+}
+
+int olkr_attach_read(olkr_attach *a, uint64_t offset, uint8_t *buf, size_t len,
+                     size_t *out_read) {
+    if (!g_ctx.initialized || !a || (!buf && len) || !out_read) return OLKR_ERR_INVALID_ARG;
+
+    *out_read = 0;
+    if (offset >= a->size) return OLKR_OK;
+    if (len > a->size - offset) len = (size_t)(a->size - offset);
+
+    size_t done = 0;
+    while (done < len) {
+        uint64_t pos = offset + done;
+        uint64_t index = pos / a->chunk_len;
+        size_t in_chunk = (size_t)(pos % a->chunk_len);
+        size_t chunk = attach_chunk_len(a->size, a->chunk_len, index);
+        size_t n = chunk - in_chunk;
+        if (n > len - done) n = len - done;
+
+        int rc = OLKR_OK;
+        if (n == chunk && index != a->cached) {
+            // Whole chunks wanted: open the run straight into the caller's
+            // buffer, in parallel; a trailing partial chunk goes through buf
+            size_t run = 1;
+            while (n == run * a->chunk_len && (index + run) * a->chunk_len < a->size) {
+                size_t next = attach_chunk_len(a->size, a->chunk_len, index + run);
+                if (next > len - done - n) break;
+                n += next;
+                run++;
+            }
+            attach_read_batch b = { a, index, buf + done, a->chunk_len };
+            rc = thread_pool_run(run, attach_open_task, &b);
+            if (rc != OLKR_OK) memset(buf + done, 0, n);
+        } else {
+            if (index != a->cached) {
+                a->cached = UINT64_MAX;
+                rc = attach_load_chunk(a, index, a->buf);
+                if (rc == OLKR_OK) a->cached = index;
+            }
+            if (rc == OLKR_OK) memcpy(buf + done, a->buf + in_chunk, n);
+        }
+        if (rc != OLKR_OK) {
+            memset(buf, 0, done);
+            return rc;
+        }
+        done += n;
+    }
+
+    *out_read = len;
+    return OLKR_OK;
+}
+
+void olkr_attach_close(olkr_attach *a) {
+    if (!a) return;
+    if (a->buf) {
+        secure_wipe(a->buf, a->chunk_len);
+        free(a->buf);
+    }
+    secure_wipe(a, sizeof(*a));
+    free(a);
+}
+
+/*=============================================================================
+  Entries and content-addressed blobs
+=============================================================================*/
+
+// Base64 characters at the end of a record that hold its tag: 4-character
+// quanta decode to 3 bytes, so 24 characters give the last 16 to 18 bytes
+#define BLOB_TAIL_CHARS    24
+
+/**
+ * If `b64_cipher` is a GCM-SIV record, write its content id (hex tag) to
+ * `blob_id` and return 1; return 0 for any other record. Only the first
+ * quantum (version byte) and the last BLOB_TAIL_CHARS characters (tag) are
+ * decoded, which is all a record written by lock (padded Base64) needs.
+ */
+static int blob_id_of(const char *b64_cipher, char blob_id[BLOB_ID_LEN + 1]) {
+    static const char hex[] = "0123456789abcdef";
+    size_t b64_len = strlen(b64_cipher);
+    if (b64_len % 4 != 0 || b64_len < base64_encoded_len(RECORD_OVERHEAD)) return 0;
+
+    uint8_t head[3], tail[BLOB_TAIL_CHARS / 4 * 3];
+    if (base64_decode_into(b64_cipher, 4, head, sizeof(head)) != (int)sizeof(head) ||
+        head[0] != RECORD_VERSION_SIV) {
+        return 0;
+    }
+    int n = base64_decode_into(b64_cipher + b64_len - BLOB_TAIL_CHARS, BLOB_TAIL_CHARS,
+                               tail, sizeof(tail));
+    if (n < AES_GCM_TAG_LEN) return 0;
+
+    const uint8_t *tag = tail + n - AES_GCM_TAG_LEN;
+    for (int i = 0; i < AES_GCM_TAG_LEN; i++) {
+        blob_id[2 * i]     = hex[tag[i] >> 4];
+        blob_id[2 * i + 1] = hex[tag[i] & 0x0F];
+    }
+    blob_id[BLOB_ID_LEN] = '\0';
+    return 1;
+}
+
+// Store a deduplicated record once, locally and remotely; `ref` receives the
+// reference string kept in the entry instead of the record. The blob is
+// uploaded until an upload succeeds, so a failed one is retried by the next
+// save of the same record rather than leaving references without a blob.
+static int blob_save(const char *b64_cipher, const char *blob_id,
+                     char ref[BLOB_ID_LEN + 2]) {
+    int inserted = 0;
+    if (localdb_put_blob(blob_id, b64_cipher, &inserted) != 0) return OLKR_ERR_STORAGE;
+    int synced = localdb_blob_synced(blob_id);
+    if (synced < 0) return OLKR_ERR_STORAGE;
+    if (!synced) {
+        char sync_id[sizeof(BLOB_SYNC_PREFIX) + BLOB_ID_LEN];
+        memcpy(sync_id, BLOB_SYNC_PREFIX, sizeof(BLOB_SYNC_PREFIX) - 1);
+        memcpy(sync_id + sizeof(BLOB_SYNC_PREFIX) - 1, blob_id, BLOB_ID_LEN + 1);
+        if (firestore_sync_upload(sync_id, b64_cipher) != 0) return OLKR_ERR_SYNC;
+        if (localdb_set_blob_synced(blob_id) != 0) return OLKR_ERR_STORAGE;
+    }
+    ref[0] = BLOB_REF_PREFIX;
+    memcpy(ref + 1, blob_id, BLOB_ID_LEN + 1);
+    return OLKR_OK;
+}
+
+// Resolve a blob reference to its record, fetching and caching it if needed.
+// A fetched record must carry the referenced content id.
+static int blob_load(const char *ref, char **out_b64) {
+    const char *blob_id = ref + 1;
+    if (strlen(blob_id) != BLOB_ID_LEN) return OLKR_ERR_CRYPTO;
+
+    int rc = localdb_get_blob(blob_id, out_b64);
+    if (rc == 0) return OLKR_OK;
+    if (rc != -2) return OLKR_ERR_STORAGE;
+
+    char sync_id[sizeof(BLOB_SYNC_PREFIX) + BLOB_ID_LEN];
+    memcpy(sync_id, BLOB_SYNC_PREFIX, sizeof(BLOB_SYNC_PREFIX) - 1);
+    memcpy(sync_id + sizeof(BLOB_SYNC_PREFIX) - 1, blob_id, BLOB_ID_LEN + 1);
+    rc = firestore_sync_download(sync_id, out_b64);
+    if (rc != OLKR_OK) return rc;
+
+    // The server is not trusted to return the record the id names; one with
+    // another content id is neither cached nor returned
+    char got_id[BLOB_ID_LEN + 1];
+    if (!blob_id_of(*out_b64, got_id) || strcmp(got_id, blob_id) != 0) {
+        free(*out_b64);
+        *out_b64 = NULL;
+        return OLKR_ERR_CRYPTO;
+    }
+
+    // It came from the server, so it needs no upload
+    int inserted = 0;
+    if (localdb_put_blob(blob_id, *out_b64, &inserted) == 0) localdb_set_blob_synced(blob_id);
     return OLKR_OK;
 }
 
@@ -128,6 +1856,14 @@ int openlockr_unlock(const char *b64_cipher, char **out_plain) {
 int openlockr_save_entry(const char *id, const char *b64_cipher) {
     if (!g_ctx.initialized || !id || !b64_cipher) return OLKR_ERR_INVALID_ARG;
 
+    // Deduplicated records are stored once; the entry keeps a reference
+    char blob_id[BLOB_ID_LEN + 1], ref[BLOB_ID_LEN + 2];
+    if (blob_id_of(b64_cipher, blob_id)) {
+        int rc = blob_save(b64_cipher, blob_id, ref);
+        if (rc != OLKR_OK) return rc;
+        b64_cipher = ref;
+    }
+
     int rc = localdb_put_entry(id, b64_cipher);
     if (rc != 0) return OLKR_ERR_STORAGE;
 
@@ -146,7 +1882,7 @@ int openlockr_load_entry(const char *id, char **out_plain) {
 
     char *b64_cipher = NULL;
     int rc = localdb_get_entry(id, &b64_cipher);
-    if (rc == OLKR_ERR_NOT_FOUND) {
+    if (rc == -2) {
         // Try Firestore
         rc = firestore_sync_download(id, &b64_cipher);
         if (rc != OLKR_OK) return rc;
@@ -156,6 +1892,13 @@ int openlockr_load_entry(const char *id, char **out_plain) {
         return OLKR_ERR_STORAGE;
     }
 
+    if (b64_cipher[0] == BLOB_REF_PREFIX) {
+        char *ref = b64_cipher;
+        rc = blob_load(ref, &b64_cipher);
+        free(ref);
+        if (rc != OLKR_OK) return rc;
+    }
+
     // Decrypt
     rc = openlockr_unlock(b64_cipher, out_plain);
     free(b64_cipher);
@@ -166,8 +1909,12 @@ int openlockr_load_entry(const char *id, char **out_plain) {
  * Clean up resources.
  */
 void openlockr_cleanup() {
+    session_end();
     if (!g_ctx.initialized) return;
     localdb_close();
-    // Zero out key material
+    aes_256_key_free(g_ctx.cipher);
+    // Zero out key material, cached subkeys included
+    pthread_mutex_lock(&g_subkey_lock);
     memset(&g_ctx, 0, sizeof(g_ctx));
+    pthread_mutex_unlock(&g_subkey_lock);
 }
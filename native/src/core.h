@@ -23,13 +23,34 @@ extern "C" {
 #define OLKR_ERR_SYNC         5   ///< Cloud sync (Firestore) error
 #define OLKR_ERR_NOT_FOUND    6   ///< Requested entry not found locally or remotely
 
+#define OLKR_SUBKEY_LEN       32  ///< Length in bytes of openlockr_subkey() keys
+#define OLKR_SESSION_MAX_ATTEMPTS 5 ///< Wrong resume secrets before a session is wiped
+
+/*=============================================================================
+  Key derivation
+=============================================================================*/
+#define OLKR_KDF_PBKDF2       1   ///< PBKDF2-HMAC-SHA256
+#define OLKR_KDF_ARGON2ID     2   ///< Argon2id (RFC 9106), memory-hard and multi-core
+#define OLKR_KDF_TARGET_MS    300 ///< Default unlock time new vaults are calibrated to
+
+/**
+ * KDF that derives the key protecting the vault's data key from the master
+ * password. Stored with the wrapped data key, so every device uses the
+ * vault's own settings.
+ */
+typedef struct {
+    uint32_t algorithm;    ///< OLKR_KDF_*
+    uint32_t iterations;   ///< PBKDF2 iterations (1..2^26), or Argon2id passes (1..64)
+    uint32_t memory_kib;   ///< Argon2id memory in KiB (8 * lanes .. 1 GiB); 0 for PBKDF2
+    uint32_t lanes;        ///< Argon2id lanes, run in parallel (1..64); 0 for PBKDF2
+} olkr_kdf_params;
+
 /*=============================================================================
   Internal helpers (used by core.c; not part of the public API)
 =============================================================================*/
 
 /**
- * Derive key via PBKDF2‑HMAC‑SHA256
- * (wrapper around OpenSSL PKCS5_PBKDF2_HMAC or your own implementation).
+ * Derive key via PBKDF2-HMAC-SHA256 (in-tree, see crypto/pbkdf2.h).
  */
 int pbkdf2_hmac_sha256(
     const char *password, size_t password_len,
@@ -59,25 +80,215 @@ int firestore_sync_download(const char *id, char **out_b64_cipher);
  * Must be called once before any other operations.
  *
  * Internally performs:
- *  - PBKDF2-HMAC-SHA256 key derivation (AES-256 key)
- *  - Zero-initialization of IV (or other IV init)
  *  - Opening/creating local database
+ *  - Unwrapping the vault's random data key with a key derived from the
+ *    password by the vault's KDF (see openlockr_set_kdf). On a new device
+ *    the wrapped key is fetched from Firestore; a new vault gets a fresh
+ *    one, and a vault created before data keys keeps its password-derived
+ *    key as data key. Those two are wrapped with Argon2id calibrated to the
+ *    unlock target (openlockr_set_kdf_target), which adds the calibration
+ *    time to that first call
+ *  - Creation of the keyed cipher shared by lock/unlock
+ *  - Loading the vault's AEAD; a new vault records AES-256-GCM if the CPU
+ *    has AES instructions, ChaCha20-Poly1305 otherwise
  *
  * @param master_password  Null-terminated master password string.
- * @return OLKR_OK on success, or OLKR_ERR_* on failure.
+ * @return OLKR_OK on success, OLKR_ERR_CRYPTO if the password is wrong,
+ *         OLKR_ERR_SYNC if a new vault cannot check Firestore for an existing
+ *         data key, or another OLKR_ERR_* on failure.
  */
 int openlockr_init(const char *master_password);
 
+/** In-flight openlockr_init_start(). */
+typedef struct olkr_init_op olkr_init_op;
+
+/**
+ * Completion callback of openlockr_init_start(). Runs on the init thread;
+ * it must not call openlockr_init_finish() itself.
+ *
+ * @param result  What openlockr_init() would have returned.
+ * @param user    The pointer given to openlockr_init_start().
+ */
+typedef void (*olkr_init_cb)(int result, void *user);
+
+/**
+ * Start openlockr_init() in the background and return at once.
+ *
+ * For an existing vault the master-password KDF runs on its own thread
+ * while the database is opened, its schema checked and its pages read into
+ * cache, so a cold start costs about the longer of the two rather than
+ * their sum. Completion is reported three ways, use any: `cb`, the fd from
+ * openlockr_init_fd() turning readable, or openlockr_init_finish()
+ * returning. No other openlockr_* call may be made until it has finished.
+ *
+ * @param master_password  Null-terminated master password; copied.
+ * @param cb               Called once with the result, or NULL.
+ * @param user             Passed to `cb`.
+ * @param out_op           Receives the handle; release it with
+ *                         openlockr_init_finish().
+ * @return OLKR_OK if started, OLKR_ERR_INVALID_ARG, or OLKR_ERR_OOM if the
+ *         handle, its pipe or its thread could not be created.
+ */
+int openlockr_init_start(const char *master_password, olkr_init_cb cb, void *user,
+                         olkr_init_op **out_op);
+
+/**
+ * File descriptor that becomes readable once the init has finished, for
+ * poll()/epoll or an event loop. Owned by the handle; do not read or close it.
+ *
+ * @return The descriptor, or -1 if `op` is NULL.
+ */
+int openlockr_init_fd(const olkr_init_op *op);
+
+/**
+ * Wait for the init to finish (if it has not) and release the handle.
+ * Must be called exactly once per successful openlockr_init_start().
+ *
+ * @param op  Handle from openlockr_init_start().
+ * @return The openlockr_init() result, or OLKR_ERR_INVALID_ARG if `op` is NULL.
+ */
+int openlockr_init_finish(olkr_init_op *op);
+
+/**
+ * Change the master password. Only the wrapped data key is rewritten (and
+ * synced), so the cost does not depend on the number of entries.
+ *
+ * @param old_password  Current master password.
+ * @param new_password  New master password.
+ * @return OLKR_OK on success, OLKR_ERR_CRYPTO if old_password is wrong,
+ *         OLKR_ERR_SYNC if the change was saved locally but not uploaded
+ *         (it is uploaded at the next openlockr_init()), or another OLKR_ERR_*.
+ */
+int openlockr_change_password(const char *old_password, const char *new_password);
+
+/**
+ * Switch the vault to another KDF (or other costs), e.g. Argon2id with
+ * 64 MiB and 4 lanes, or costs from openlockr_calibrate_kdf(). Only the
+ * wrapped data key is rewritten and synced.
+ *
+ * @param master_password  Current master password.
+ * @param kdf              New KDF and costs.
+ * @return OLKR_OK on success, OLKR_ERR_INVALID_ARG for unsupported costs,
+ *         OLKR_ERR_CRYPTO if the password is wrong, OLKR_ERR_SYNC if the
+ *         change was saved locally but not uploaded, or another OLKR_ERR_*.
+ */
+int openlockr_set_kdf(const char *master_password, const olkr_kdf_params *kdf);
+
+/**
+ * Get the KDF the vault's data key is currently wrapped with.
+ *
+ * @param out_kdf  Receives the KDF and its costs.
+ * @return OLKR_OK, or OLKR_ERR_INVALID_ARG if not initialized.
+ */
+int openlockr_get_kdf(olkr_kdf_params *out_kdf);
+
+/**
+ * Set the unlock time new vaults calibrate their KDF to. Takes effect for
+ * vaults created by later openlockr_init() calls; may be called before it.
+ *
+ * @param target_ms  Target in milliseconds (at most 60000), or 0 for
+ *                   OLKR_KDF_TARGET_MS.
+ * @return OLKR_OK, or OLKR_ERR_INVALID_ARG if the target is too large.
+ */
+int openlockr_set_kdf_target(uint32_t target_ms);
+
+/**
+ * Measure this device and pick KDF costs that take about `target_ms`.
+ * Runs a few short trial derivations, so it takes roughly twice the
+ * target. Costs never go below a floor (PBKDF2: 100000 iterations;
+ * Argon2id: 8 MiB), so slow devices may exceed the target. Pass the result
+ * to openlockr_set_kdf() to recalibrate an existing vault.
+ *
+ * @param algorithm  OLKR_KDF_PBKDF2 or OLKR_KDF_ARGON2ID.
+ * @param target_ms  Target in milliseconds (at most 60000), or 0 for the
+ *                   openlockr_set_kdf_target() value.
+ * @param out_kdf    Receives the chosen costs.
+ * @return OLKR_OK, OLKR_ERR_INVALID_ARG for an unknown algorithm or too
+ *         large a target, or OLKR_ERR_CRYPTO if a trial derivation failed.
+ */
+int openlockr_calibrate_kdf(uint32_t algorithm, uint32_t target_ms, olkr_kdf_params *out_kdf);
+
+/**
+ * Get a purpose-separated subkey (MAC key, search-index key, per-collection
+ * key...) derived from the vault's data key with HKDF-SHA256, using `label`
+ * as HKDF info. Each label yields an independent key that stays the same
+ * across devices and password changes. Derivation takes microseconds, and
+ * recently used subkeys are cached in the core context until
+ * openlockr_cleanup(), so new key purposes add nothing to unlock time.
+ * Thread-safe.
+ *
+ * @param label    Null-terminated label of 1 to 31 bytes, e.g. "search-index".
+ * @param out_key  Receives OLKR_SUBKEY_LEN bytes; wipe it after use.
+ * @return OLKR_OK on success, OLKR_ERR_INVALID_ARG if not initialized or the
+ *         label is empty or too long, OLKR_ERR_CRYPTO on derivation failure.
+ */
+int openlockr_subkey(const char *label, uint8_t out_key[OLKR_SUBKEY_LEN]);
+
 /**
  * Clean up OpenLockr core.
- * Closes local database, wipes key material from memory.
- * After cleanup, openlockr_init() must be called again before reuse.
+ * Closes local database, wipes key material from memory, and ends any
+ * suspended session. After cleanup, openlockr_init() must be called again
+ * before reuse.
  */
 void openlockr_cleanup(void);
 
+/*=============================================================================
+  Session (fast re-unlock)
+=============================================================================*/
+
+/**
+ * Lock the vault but keep it resumable with a short secret, e.g. when the
+ * app goes to the background. The data key is sealed under a random session
+ * key combined with `secret`, in locked memory that is never swapped or
+ * dumped. openlockr_session_resume() then costs one AEAD open instead of
+ * the master-password KDF. The local database stays open meanwhile.
+ *
+ * `secret` is a PIN, or an unlock token the app keeps elsewhere (e.g. a
+ * random value held by the platform keystore behind biometrics). A PIN is
+ * only as strong as the attempt limit: the session is wiped after
+ * OLKR_SESSION_MAX_ATTEMPTS wrong secrets.
+ *
+ * Until resumed, the vault behaves as after openlockr_cleanup(). The
+ * session ends at the first of: a successful resume, the idle timeout,
+ * too many wrong secrets, openlockr_session_end(), openlockr_cleanup() or
+ * openlockr_init().
+ *
+ * @param secret          PIN or token bytes.
+ * @param secret_len      Length in bytes of the secret, at least 1.
+ * @param idle_timeout_s  Seconds after which the session is wiped, at least
+ *                        1. Counts time asleep where the OS allows it.
+ * @return OLKR_OK on success; OLKR_ERR_INVALID_ARG if not initialized or an
+ *         argument is invalid; OLKR_ERR_OOM if locked memory is unavailable
+ *         (the vault then stays unlocked); OLKR_ERR_CRYPTO on failure.
+ */
+int openlockr_session_suspend(const uint8_t *secret, size_t secret_len, uint32_t idle_timeout_s);
+
+/**
+ * Unlock a vault suspended by openlockr_session_suspend().
+ *
+ * @param secret      The PIN or token given to openlockr_session_suspend().
+ * @param secret_len  Length in bytes of the secret.
+ * @return OLKR_OK if the vault is unlocked again; OLKR_ERR_CRYPTO for a
+ *         wrong secret; OLKR_ERR_NOT_FOUND if there is no session (never
+ *         suspended, expired, or wiped), in which case call openlockr_init()
+ *         with the master password; OLKR_ERR_INVALID_ARG if already
+ *         initialized or an argument is invalid.
+ */
+int openlockr_session_resume(const uint8_t *secret, size_t secret_len);
+
+/**
+ * Wipe a suspended session, if any, and close the database it kept open.
+ * The vault, if unlocked, stays unlocked.
+ */
+void openlockr_session_end(void);
+
 /**
  * Encrypt a UTF-8 plaintext string into a Base64-encoded ciphertext.
  *
+ * The ciphertext is a versioned record under the vault's AEAD:
+ *   version byte || 96-bit random nonce || ciphertext || 128-bit tag,
+ * where version 0x02 is AES-256-GCM and 0x03 is ChaCha20-Poly1305.
+ *
  * Allocates a null-terminated output string via malloc(). Caller must free().
  *
  * @param plain      Null-terminated input plaintext.
@@ -86,9 +297,27 @@ void openlockr_cleanup(void);
  */
 int openlockr_lock(const char *plain, char **out_b64);
 
+/**
+ * Encrypt like openlockr_lock(), but deterministically: the record is sealed
+ * with AES-256-GCM-SIV under a fixed nonce, so the same plaintext always
+ * gives the same Base64 string. Passing such a record to
+ * openlockr_save_entry() stores it once in a content-addressed blob shared
+ * by every entry with that secret. This reveals which entries are equal;
+ * use it only where that is acceptable. Dedupe records cannot be streamed.
+ *
+ * @param plain    Null-terminated UTF-8 string to encrypt.
+ * @param out_b64  Pointer to char*; on success *out_b64 = malloc'd Base64 string.
+ * @return OLKR_OK on success, or OLKR_ERR_* on failure.
+ */
+int openlockr_lock_dedupe(const char *plain, char **out_b64);
+
 /**
  * Decrypt a Base64-encoded ciphertext back into a UTF-8 plaintext.
  *
+ * Accepts AES-256-GCM and ChaCha20-Poly1305 records (tag verified; the
+ * algorithm comes from the record's version byte) as well as legacy
+ * AES-256-CBC blobs written by earlier versions.
+ *
  * Allocates a null-terminated output string via malloc(). Caller must free().
  *
  * @param b64_cipher Null-terminated Base64 ciphertext.
@@ -97,8 +326,29 @@ int openlockr_lock(const char *plain, char **out_b64);
  */
 int openlockr_unlock(const char *b64_cipher, char **out_plain);
 
+/**
+ * Decrypt many Base64-encoded ciphertexts in one call (vault open / export).
+ *
+ * AEAD records are verified one by one; legacy AES-256-CBC blobs are pooled
+ * and decrypted together with blocks interleaved across entries, so a vault
+ * still on CBC opens at cipher throughput rather than per-entry latency.
+ *
+ * Each successful output is a malloc’d null-terminated plaintext the caller
+ * must free(); failed entries are set to NULL.
+ *
+ * @param b64_ciphers  Array of `count` null-terminated Base64 ciphertexts.
+ * @param count        Number of entries.
+ * @param out_plains   Array of `count` char* receiving the plaintexts.
+ * @return OLKR_OK if every entry decrypted, otherwise the first OLKR_ERR_*
+ *         encountered (entries that did decrypt are still returned).
+ */
+int openlockr_unlock_batch(const char *const *b64_ciphers, size_t count,
+                           char **out_plains);
+
 /**
  * Save an encrypted entry identified by `id` to both local storage and Firestore.
+ * Records from openlockr_lock_dedupe() are stored once under their content
+ * id, and the entry keeps a reference to it.
  *
  * @param id         Null-terminated unique entry identifier (e.g., UUID).
  * @param b64_cipher Null-terminated Base64 ciphertext for this entry.
@@ -112,7 +362,8 @@ int openlockr_save_entry(const char *id, const char *b64_cipher);
  * Behavior:
  *  1) Attempt to load Base64 ciphertext from local storage.
  *  2) If not found locally, download from Firestore and cache locally.
- *  3) Base64-decode & decrypt.
+ *  3) Resolve a dedupe reference to its blob, the same way.
+ *  4) Base64-decode & decrypt.
  *
  * Allocates a null-terminated output string via malloc(). Caller must free().
  *
@@ -124,6 +375,151 @@ int openlockr_save_entry(const char *id, const char *b64_cipher);
  */
 int openlockr_load_entry(const char *id, char **out_plain);
 
+/*=============================================================================
+  Streaming API
+=============================================================================*/
+
+#define OLKR_STREAM_ENCRYPT   0   ///< plaintext in, sealed record out
+#define OLKR_STREAM_DECRYPT   1   ///< sealed record in, plaintext out
+
+/**
+ * Output callback for the streaming API. Called with each chunk of output
+ * as soon as it is ready; `data` is only valid for the duration of the call.
+ *
+ * @return OLKR_OK to continue, or an OLKR_ERR_* code to abort the stream;
+ *         the code is returned by the olkr_stream_* call that hit it.
+ */
+typedef int (*olkr_sink_fn)(void *user, const uint8_t *data, size_t len);
+
+/** Opaque streaming encryption/decryption handle. */
+typedef struct olkr_stream olkr_stream;
+
+/**
+ * Start a streaming operation for inputs too large to hold in memory
+ * (documents, attachments). Input is arbitrary binary data fed in chunks of
+ * any size; output is passed to `sink` through a fixed few-KB buffer.
+ *
+ * The sealed format is the binary form of an openlockr_lock() record
+ * (version byte || nonce || ciphertext || tag), so Base64 of a streamed
+ * record is also accepted by openlockr_unlock().
+ *
+ * When decrypting, plaintext reaches the sink before the tag is checked;
+ * it must be discarded unless olkr_stream_finish() returns OLKR_OK.
+ * Legacy CBC blobs and dedupe records cannot be streamed.
+ *
+ * @param direction   OLKR_STREAM_ENCRYPT or OLKR_STREAM_DECRYPT.
+ * @param sink        Output callback.
+ * @param user        Opaque pointer passed to `sink`.
+ * @param out_stream  On success, receives the new handle.
+ * @return OLKR_OK on success, or OLKR_ERR_* on failure.
+ */
+int olkr_stream_begin(int direction, olkr_sink_fn sink, void *user,
+                      olkr_stream **out_stream);
+
+/**
+ * Feed the next chunk of input.
+ *
+ * @return OLKR_OK on success, or OLKR_ERR_* on failure. After a failure
+ *         the stream only accepts olkr_stream_finish().
+ */
+int olkr_stream_update(olkr_stream *stream, const uint8_t *data, size_t len);
+
+/**
+ * Finish the stream: emit (encrypt) or verify (decrypt) the tag, then
+ * release the handle. Must be called exactly once, even after an error.
+ *
+ * @return OLKR_OK on success; OLKR_ERR_CRYPTO if decryption failed
+ *         authentication; or the first error the stream hit.
+ */
+int olkr_stream_finish(olkr_stream *stream);
+
+/*=============================================================================
+  Attachments
+=============================================================================*/
+
+/** Opaque attachment writer. */
+typedef struct olkr_attach_writer olkr_attach_writer;
+
+/** Opaque random-access attachment reader. */
+typedef struct olkr_attach olkr_attach;
+
+/**
+ * Start writing a chunked attachment container for `size` bytes of binary
+ * data. The data is cut into 64 KiB chunks, each sealed on its own with the
+ * vault's AEAD, so a reader can later decrypt any byte range by touching
+ * only the chunks it overlaps. The authenticated header is passed to `sink`
+ * before this returns. Chunks are buffered in small batches, sealed in
+ * parallel on the native worker pool and passed to `sink` in order; the
+ * output is identical to sealing them one by one.
+ *
+ * @param size        Exact number of plaintext bytes that will be written.
+ * @param sink        Output callback (e.g. appending to a file).
+ * @param user        Opaque pointer passed to `sink`.
+ * @param out_writer  On success, receives the new handle.
+ * @return OLKR_OK on success, or OLKR_ERR_* on failure.
+ */
+int olkr_attach_begin(uint64_t size, olkr_sink_fn sink, void *user,
+                      olkr_attach_writer **out_writer);
+
+/**
+ * Append plaintext. Writing more than the declared size is an error.
+ *
+ * @return OLKR_OK on success, or OLKR_ERR_* on failure. After a failure
+ *         the writer only accepts olkr_attach_finish().
+ */
+int olkr_attach_write(olkr_attach_writer *writer, const uint8_t *data, size_t len);
+
+/**
+ * Seal the last chunk and release the handle. Must be called exactly once,
+ * even after an error.
+ *
+ * @return OLKR_OK on success; OLKR_ERR_INVALID_ARG if fewer bytes than the
+ *         declared size were written; or the first error the writer hit.
+ */
+int olkr_attach_finish(olkr_attach_writer *writer);
+
+/**
+ * Open an attachment container for random access. Only the header is read
+ * and verified here; chunks are read with pread(2) on demand. The caller
+ * keeps ownership of `fd`, which must stay open until olkr_attach_close(),
+ * and the handle must be closed before openlockr_cleanup().
+ *
+ * @param fd          Readable file descriptor positioned anywhere.
+ * @param out_attach  On success, receives the new handle.
+ * @return OLKR_OK on success, OLKR_ERR_CRYPTO if the header is not a valid
+ *         container for this vault, or OLKR_ERR_* on other failures.
+ */
+int olkr_attach_open(int fd, olkr_attach **out_attach);
+
+/**
+ * Plaintext size of an open attachment, in bytes.
+ */
+uint64_t olkr_attach_size(const olkr_attach *attach);
+
+/**
+ * Decrypt `len` bytes starting at plaintext `offset` into `buf`. Only the
+ * chunks overlapping the range are read and verified. Runs of whole chunks
+ * are opened in parallel on the worker pool; the last partially read chunk
+ * is kept so small sequential reads decrypt each chunk once.
+ * A handle is not safe to use from several threads at once.
+ *
+ * @param attach    Open attachment.
+ * @param offset    Plaintext offset to read from.
+ * @param buf       Output buffer of at least `len` bytes.
+ * @param len       Number of bytes wanted.
+ * @param out_read  Receives the number of bytes read; less than `len` only
+ *                  at the end of the attachment.
+ * @return OLKR_OK on success; OLKR_ERR_CRYPTO if a chunk failed
+ *         authentication (`buf` is wiped); or OLKR_ERR_* on other failures.
+ */
+int olkr_attach_read(olkr_attach *attach, uint64_t offset, uint8_t *buf, size_t len,
+                     size_t *out_read);
+
+/**
+ * Release a reader (does not close its file descriptor). NULL is a no-op.
+ */
+void olkr_attach_close(olkr_attach *attach);
+
 #ifdef __cplusplus
 }
 #endif
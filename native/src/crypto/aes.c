@@ -1,12 +1,250 @@
 // native/src/crypto/aes.c
-// AES-256-CBC encryption/decryption using OpenSSL EVP interface.
+// AES-256-CBC and AES-256-GCM for OpenLockr: the backend registry, the
+// in-tree backends built on the per-ISA kernels, and the keyed API that
+// dispatches to the selected backend.
 
 #include "aes.h"
-#include <openssl/evp.h>
-#include <openssl/err.h>
+#include "aes_impl.h"
+#include "utils/bytes.h"
+#include "utils/cpu.h"
+#include <limits.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Blocks per GCM pass: CTR and GHASH alternate over chunks this size so the
+// data is still in L1 when it is hashed.
+#define GCM_CHUNK_BLOCKS  32
+
+#define MAX_BACKENDS      8
+
+struct aes_256_key {
+    const aes_backend    *backend;
+    void                 *ctx;      // backend's keyed context
+    aes_intree_key       *intree;   // == ctx for in-tree backends
+};
+
+static int  intree_cbc_encrypt(const void *ctx, const uint8_t *iv,
+                               const uint8_t *in, size_t len, uint8_t *out);
+static int  intree_cbc_decrypt(const void *ctx, const uint8_t *iv,
+                               const uint8_t *in, size_t len, uint8_t *out);
+static int  intree_gcm_seal(const void *ctx, const uint8_t *nonce,
+                            const uint8_t *aad, size_t aad_len,
+                            const uint8_t *in, size_t len,
+                            uint8_t *out, uint8_t *tag);
+static int  intree_gcm_open(const void *ctx, const uint8_t *nonce,
+                            const uint8_t *aad, size_t aad_len,
+                            const uint8_t *in, size_t len,
+                            const uint8_t *tag, uint8_t *out);
+static void *intree_key_new(const aes_backend *self, const uint8_t *key);
+static void intree_key_free(void *ctx);
+
+/*=============================================================================
+  Backend registry
+=============================================================================*/
+
+static pthread_once_t     g_registry_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t    g_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static aes_backend        g_intree[3];
+static const aes_backend *g_backends[MAX_BACKENDS];
+static size_t             g_backend_count = 0;
+static const aes_backend *g_selected = NULL;
+
+static void add_intree(const aes_kernels *kern, int hardware) {
+    aes_backend *b = &g_intree[g_backend_count];
+    b->name        = kern->name;
+    b->impl        = kern;
+    b->hardware    = hardware;
+    b->key_new     = intree_key_new;
+    b->key_free    = intree_key_free;
+    b->cbc_encrypt = intree_cbc_encrypt;
+    b->cbc_decrypt = intree_cbc_decrypt;
+    b->gcm_seal    = intree_gcm_seal;
+    b->gcm_open    = intree_gcm_open;
+    g_backends[g_backend_count++] = b;
+}
+
+static void registry_init(void) {
+    const aes_kernels *k;
+    if (cpu_has(CPU_X86_AESNI | CPU_X86_PCLMUL | CPU_X86_SSSE3) &&
+        (k = aes_kernels_x86()) != NULL) {
+        add_intree(k, 1);
+    }
+    if (cpu_has(CPU_ARM_AES | CPU_ARM_PMULL) && (k = aes_kernels_armv8()) != NULL) {
+        add_intree(k, 1);
+    }
+    add_intree(aes_kernels_portable(), 0);
+
+    const aes_backend *ossl = aes_backend_openssl();
+    if (ossl) g_backends[g_backend_count++] = ossl;
+
+    g_selected = g_backends[0];
+}
+
+static void registry(void) {
+    pthread_once(&g_registry_once, registry_init);
+}
+
+// Fastest in-tree kernels; they back streaming GCM and batch CBC
+static const aes_kernels *kernels(void) {
+    registry();
+    return g_intree[0].impl;
+}
+
+size_t aes_backend_count(void) {
+    registry();
+    pthread_mutex_lock(&g_registry_lock);
+    size_t n = g_backend_count;
+    pthread_mutex_unlock(&g_registry_lock);
+    return n;
+}
+
+const aes_backend *aes_backend_get(size_t index) {
+    registry();
+    pthread_mutex_lock(&g_registry_lock);
+    const aes_backend *b = index < g_backend_count ? g_backends[index] : NULL;
+    pthread_mutex_unlock(&g_registry_lock);
+    return b;
+}
+
+const aes_backend *aes_backend_selected(void) {
+    registry();
+    pthread_mutex_lock(&g_registry_lock);
+    const aes_backend *b = g_selected;
+    pthread_mutex_unlock(&g_registry_lock);
+    return b;
+}
+
+int aes_backend_select(const char *name) {
+    if (!name) return -1;
+    registry();
+
+    int rc = -1;
+    pthread_mutex_lock(&g_registry_lock);
+    for (size_t i = 0; i < g_backend_count; i++) {
+        if (strcmp(g_backends[i]->name, name) == 0) {
+            g_selected = g_backends[i];
+            rc = 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_registry_lock);
+    return rc;
+}
+
+int aes_backend_register(const aes_backend *b) {
+    if (!b || !b->name || !b->key_new || !b->key_free || !b->cbc_encrypt ||
+        !b->cbc_decrypt || !b->gcm_seal || !b->gcm_open) {
+        return -1;
+    }
+    registry();
+
+    int rc = -1;
+    pthread_mutex_lock(&g_registry_lock);
+    if (g_backend_count < MAX_BACKENDS) {
+        g_backends[g_backend_count++] = b;
+        rc = 0;
+    }
+    pthread_mutex_unlock(&g_registry_lock);
+    return rc;
+}
+
+const char *aes_implementation(void) {
+    return aes_backend_selected()->name;
+}
+
+int aes_hardware_accelerated(void) {
+    return kernels() != aes_kernels_portable();
+}
+
+/*=============================================================================
+  In-tree backends
+=============================================================================*/
+
+static void intree_setup(aes_intree_key *k, const aes_kernels *kern, const uint8_t *key) {
+    uint8_t h[AES_BLOCK_LEN] = {0};
+
+    k->kern = kern;
+    aes_expand_key(&k->sched, key);
+    kern->encrypt_blocks(&k->sched, h, h, 1);
+    kern->ghash_init(&k->ghash, h);
+    secure_wipe(h, sizeof(h));
+}
+
+static void *intree_key_new(const aes_backend *self, const uint8_t *key) {
+    aes_intree_key *k = malloc(sizeof(*k));
+    if (!k) return NULL;
+    intree_setup(k, self->impl, key);
+    return k;
+}
+
+static void intree_key_free(void *ctx) {
+    if (!ctx) return;
+    secure_wipe(ctx, sizeof(aes_intree_key));
+    free(ctx);
+}
+
+// Strip PKCS#7 padding in constant time; returns plaintext length or -1
+static int pkcs7_unpad(const uint8_t *plaintext, size_t len) {
+    uint32_t pad = plaintext[len - 1];
+    uint32_t bad = ((pad - 1) >> 8) & 1;             // pad == 0
+    bad |= ((AES_BLOCK_LEN - pad) >> 8) & 1;         // pad > 16
+    for (uint32_t i = 0; i < AES_BLOCK_LEN; i++) {
+        uint32_t in_pad = ((i - pad) >> 31) & 1;     // i < pad
+        uint32_t diff = plaintext[len - 1 - i] ^ pad;
+        bad |= in_pad & ((diff + 0xFF) >> 8);
+    }
+    return bad ? -1 : (int)(len - pad);
+}
+
+static int intree_cbc_encrypt(const void *ctx, const uint8_t *iv,
+                              const uint8_t *plaintext, size_t plaintext_len,
+                              uint8_t *ciphertext)
+{
+    if (!ctx || !iv || !plaintext || !ciphertext ||
+        plaintext_len > (size_t)INT_MAX - AES_BLOCK_LEN) {
+        return -1;
+    }
+
+    const aes_intree_key *k = ctx;
+    uint8_t chain[AES_BLOCK_LEN], last[AES_BLOCK_LEN];
+    size_t full = plaintext_len / AES_BLOCK_LEN;
+    size_t rem  = plaintext_len % AES_BLOCK_LEN;
+
+    memcpy(chain, iv, AES_BLOCK_LEN);
+    k->kern->cbc_encrypt(&k->sched, chain, plaintext, ciphertext, full);
+
+    memcpy(last, plaintext + full * AES_BLOCK_LEN, rem);
+    memset(last + rem, (int)(AES_BLOCK_LEN - rem), AES_BLOCK_LEN - rem);
+    k->kern->cbc_encrypt(&k->sched, chain, last, ciphertext + full * AES_BLOCK_LEN, 1);
+    secure_wipe(last, sizeof(last));
+
+    return (int)((full + 1) * AES_BLOCK_LEN);
+}
+
+static int intree_cbc_decrypt(const void *ctx, const uint8_t *iv,
+                              const uint8_t *ciphertext, size_t ciphertext_len,
+                              uint8_t *plaintext)
+{
+    if (!ctx || !iv || !ciphertext || !plaintext ||
+        ciphertext_len == 0 || ciphertext_len % AES_BLOCK_LEN != 0 ||
+        ciphertext_len > (size_t)INT_MAX) {
+        return -1;
+    }
+
+    const aes_intree_key *k = ctx;
+    uint8_t chain[AES_BLOCK_LEN];
+    memcpy(chain, iv, AES_BLOCK_LEN);
+    k->kern->cbc_decrypt(&k->sched, chain, ciphertext, plaintext,
+                         ciphertext_len / AES_BLOCK_LEN);
+
+    return pkcs7_unpad(plaintext, ciphertext_len);
+}
+
+/*=============================================================================
+  One-shot API
+=============================================================================*/
+
 /**
  * Encrypt plaintext using AES-256-CBC.
  *
@@ -27,33 +265,11 @@ int aes_256_cbc_encrypt(const uint8_t *key, size_t key_len,
         return -1;
     }
 
-    int len = 0, ciphertext_len = 0;
-    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
-    if (!ctx) {
-        return -1;
-    }
-
-    if (1 != EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key, iv)) {
-        EVP_CIPHER_CTX_free(ctx);
-        return -1;
-    }
-
-    // EVP_EncryptUpdate can be called multiple times if needed
-    if (1 != EVP_EncryptUpdate(ctx, ciphertext, &len, plaintext, (int)plaintext_len)) {
-        EVP_CIPHER_CTX_free(ctx);
-        return -1;
-    }
-    ciphertext_len = len;
-
-    // Finalize encryption (writes any remaining bytes)
-    if (1 != EVP_EncryptFinal_ex(ctx, ciphertext + len, &len)) {
-        EVP_CIPHER_CTX_free(ctx);
-        return -1;
-    }
-    ciphertext_len += len;
-
-    EVP_CIPHER_CTX_free(ctx);
-    return ciphertext_len;
+    aes_256_key *k = aes_256_key_new(key, key_len);
+    if (!k) return -1;
+    int rc = aes_256_cbc_encrypt_keyed(k, iv, plaintext, plaintext_len, ciphertext);
+    aes_256_key_free(k);
+    return rc;
 }
 
 /**
@@ -76,29 +292,562 @@ int aes_256_cbc_decrypt(const uint8_t *key, size_t key_len,
         return -1;
     }
 
-    int len = 0, plaintext_len = 0;
-    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
-    if (!ctx) {
+    aes_256_key *k = aes_256_key_new(key, key_len);
+    if (!k) return -1;
+    int rc = aes_256_cbc_decrypt_keyed(k, iv, ciphertext, ciphertext_len, plaintext);
+    aes_256_key_free(k);
+    return rc;
+}
+
+/*=============================================================================
+  Keyed cipher object
+=============================================================================*/
+
+aes_256_key *aes_256_key_new(const uint8_t *key, size_t key_len) {
+    if (!key || key_len != 32) return NULL;
+
+    aes_256_key *k = calloc(1, sizeof(*k));
+    if (!k) return NULL;
+
+    k->backend = aes_backend_selected();
+    k->ctx = k->backend->key_new(k->backend, key);
+    if (k->backend->key_new == intree_key_new) {
+        k->intree = k->ctx;
+    } else {
+        k->intree = intree_key_new(&g_intree[0], key);
+    }
+    if (!k->ctx || !k->intree) {
+        aes_256_key_free(k);
+        return NULL;
+    }
+    return k;
+}
+
+void aes_256_key_free(aes_256_key *k) {
+    if (!k) return;
+    if (k->intree != k->ctx) intree_key_free(k->intree);
+    if (k->ctx) k->backend->key_free(k->ctx);
+    secure_wipe(k, sizeof(*k));
+    free(k);
+}
+
+/**
+ * Encrypt plaintext using AES-256-CBC with PKCS#7 padding.
+ */
+int aes_256_cbc_encrypt_keyed(const aes_256_key *k,
+                              const uint8_t *iv,
+                              const uint8_t *plaintext, size_t plaintext_len,
+                              uint8_t *ciphertext)
+{
+    if (!k) return -1;
+    return k->backend->cbc_encrypt(k->ctx, iv, plaintext, plaintext_len, ciphertext);
+}
+
+/**
+ * Decrypt ciphertext using AES-256-CBC and strip PKCS#7 padding.
+ * The in-tree padding check runs in constant time.
+ */
+int aes_256_cbc_decrypt_keyed(const aes_256_key *k,
+                              const uint8_t *iv,
+                              const uint8_t *ciphertext, size_t ciphertext_len,
+                              uint8_t *plaintext)
+{
+    if (!k) return -1;
+    return k->backend->cbc_decrypt(k->ctx, iv, ciphertext, ciphertext_len, plaintext);
+}
+
+/**
+ * Encrypt in place. The kernels read each block before writing it and the
+ * padded tail is staged on the stack, so aliasing is safe; runs in-tree so
+ * that guarantee holds whichever backend is selected.
+ */
+int aes_256_cbc_encrypt_inplace(const aes_256_key *k,
+                                const uint8_t *iv,
+                                uint8_t *buf, size_t len,
+                                size_t buf_cap)
+{
+    if (!k || !buf || len > (size_t)INT_MAX - AES_BLOCK_LEN ||
+        buf_cap < AES_CBC_PADDED_LEN(len)) {
         return -1;
     }
+    return intree_cbc_encrypt(k->intree, iv, buf, len, buf);
+}
+
+/**
+ * Decrypt in place; every CBC kernel saves a ciphertext block as the next
+ * chaining value before overwriting it.
+ */
+int aes_256_cbc_decrypt_inplace(const aes_256_key *k,
+                                const uint8_t *iv,
+                                uint8_t *buf, size_t len)
+{
+    if (!k) return -1;
+    return intree_cbc_decrypt(k->intree, iv, buf, len, buf);
+}
+
+/*=============================================================================
+  Batch CBC decryption
+=============================================================================*/
+
+#define BATCH_LANES  8
+
+// Blocks gathered from any mix of entries, decrypted together
+typedef struct {
+    uint8_t  in[BATCH_LANES][AES_BLOCK_LEN];    // ciphertext blocks
+    uint8_t  prev[BATCH_LANES][AES_BLOCK_LEN];  // CBC chaining value of each
+    uint8_t *dst[BATCH_LANES];
+    size_t   n;
+} cbc_gather;
+
+static void gather_flush(const aes_intree_key *k, cbc_gather *g) {
+    if (g->n == 0) return;
+    k->kern->decrypt_blocks(&k->sched, g->in[0], g->in[0], g->n);
+    for (size_t j = 0; j < g->n; j++)
+        for (int i = 0; i < AES_BLOCK_LEN; i++)
+            g->dst[j][i] = g->in[j][i] ^ g->prev[j][i];
+    g->n = 0;
+}
 
-    if (1 != EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key, iv)) {
-        EVP_CIPHER_CTX_free(ctx);
+/**
+ * Decrypt many AES-256-CBC ciphertexts, interleaving blocks across entries.
+ * Runs of eight or more blocks within one entry go straight to the kernel's
+ * own pipelined CBC path; the remaining tail blocks of every entry are pooled.
+ */
+int aes_256_cbc_decrypt_batch(const aes_256_key *key,
+                              aes_cbc_batch_item *items,
+                              size_t count)
+{
+    if (!key || (!items && count)) {
+        return -1;
+    }
+
+    const aes_intree_key *k = key->intree;
+    const aes_kernels *kern = k->kern;
+    cbc_gather g;
+    g.n = 0;
+
+    for (size_t e = 0; e < count; e++) {
+        aes_cbc_batch_item *it = &items[e];
+        if (!it->iv || !it->ciphertext || !it->plaintext ||
+            it->ciphertext_len == 0 || it->ciphertext_len % AES_BLOCK_LEN != 0 ||
+            it->ciphertext_len > (size_t)INT_MAX) {
+            it->result = -1;
+            continue;
+        }
+        it->result = 0;
+
+        size_t nblocks = it->ciphertext_len / AES_BLOCK_LEN;
+        size_t bulk = nblocks - nblocks % BATCH_LANES;
+        uint8_t chain[AES_BLOCK_LEN];
+        memcpy(chain, it->iv, AES_BLOCK_LEN);
+        if (bulk) kern->cbc_decrypt(&k->sched, chain, it->ciphertext, it->plaintext, bulk);
+
+        for (size_t b = bulk; b < nblocks; b++) {
+            memcpy(g.in[g.n], it->ciphertext + b * AES_BLOCK_LEN, AES_BLOCK_LEN);
+            memcpy(g.prev[g.n], chain, AES_BLOCK_LEN);
+            memcpy(chain, g.in[g.n], AES_BLOCK_LEN);
+            g.dst[g.n] = it->plaintext + b * AES_BLOCK_LEN;
+            if (++g.n == BATCH_LANES) gather_flush(k, &g);
+        }
+    }
+    gather_flush(k, &g);
+    secure_wipe(&g, sizeof(g));
+
+    int failed = 0;
+    for (size_t e = 0; e < count; e++) {
+        aes_cbc_batch_item *it = &items[e];
+        if (it->result == 0) it->result = pkcs7_unpad(it->plaintext, it->ciphertext_len);
+        if (it->result < 0) failed++;
+    }
+    return failed;
+}
+
+/*=============================================================================
+  GCM
+=============================================================================*/
+
+// Fold `len` bytes into the GHASH state, zero-padding the final block
+static void ghash_padded(const aes_kernels *kern, const ghash_key *g, uint8_t *x,
+                         const uint8_t *data, size_t len) {
+    size_t full = len / AES_BLOCK_LEN;
+    size_t rem  = len % AES_BLOCK_LEN;
+    if (full) kern->ghash(g, x, data, full);
+    if (rem) {
+        uint8_t block[AES_BLOCK_LEN] = {0};
+        memcpy(block, data + full * AES_BLOCK_LEN, rem);
+        kern->ghash(g, x, block, 1);
+    }
+}
+
+// NIST SP 800-38D limit on plaintext per invocation: 2^39 - 256 bits
+#define GCM_MAX_MSG_LEN  ((UINT64_C(1) << 36) - 32)
+
+static int gcm_init(aes_gcm_stream *st, const aes_intree_key *k,
+                    const uint8_t *nonce,
+                    const uint8_t *aad, size_t aad_len,
+                    int decrypt)
+{
+    if (!st || !k || !nonce || (!aad && aad_len)) {
+        return -1;
+    }
+
+    const aes_kernels *kern = k->kern;
+    memset(st, 0, sizeof(*st));
+    st->key = k;
+    st->decrypt = decrypt;
+    st->aad_len = aad_len;
+
+    memcpy(st->ek_j0, nonce, AES_GCM_NONCE_LEN);
+    st->ek_j0[15] = 1;
+    memcpy(st->ctr, st->ek_j0, AES_BLOCK_LEN);
+    st->ctr[15] = 2;
+    kern->encrypt_blocks(&k->sched, st->ek_j0, st->ek_j0, 1);   // E(K, J0) masks the tag
+
+    ghash_padded(kern, &k->ghash, st->x, aad, aad_len);
+    return 0;
+}
+
+int aes_256_gcm_stream_init(aes_gcm_stream *st, const aes_256_key *k,
+                            const uint8_t *nonce,
+                            const uint8_t *aad, size_t aad_len,
+                            int decrypt)
+{
+    return gcm_init(st, k ? k->intree : NULL, nonce, aad, aad_len, decrypt);
+}
+
+/**
+ * CTR and GHASH alternate chunk by chunk; when decrypting, each chunk is
+ * hashed before it is decrypted so in == out is allowed. Bytes that do not
+ * fill a block are carried in `part` until the next call or final.
+ */
+int aes_256_gcm_stream_update(aes_gcm_stream *st,
+                              const uint8_t *in, size_t len,
+                              uint8_t *out)
+{
+    if (!st || !st->key || (len && (!in || !out)) ||
+        len > GCM_MAX_MSG_LEN - st->msg_len) {
+        return -1;
+    }
+
+    const aes_intree_key *k = st->key;
+    const aes_kernels *kern = k->kern;
+    size_t done = len;
+    st->msg_len += len;
+
+    // Finish a block left partial by the previous call
+    if (st->part_len) {
+        while (len && st->part_len < AES_BLOCK_LEN) {
+            uint8_t c = *in++;
+            uint8_t o = c ^ st->ks[st->part_len];
+            st->part[st->part_len++] = st->decrypt ? c : o;
+            *out++ = o;
+            len--;
+        }
+        if (st->part_len < AES_BLOCK_LEN) return (int)done;
+        kern->ghash(&k->ghash, st->x, st->part, 1);
+        st->part_len = 0;
+    }
+
+    size_t blocks = len / AES_BLOCK_LEN;
+    while (blocks > 0) {
+        size_t n = blocks < GCM_CHUNK_BLOCKS ? blocks : GCM_CHUNK_BLOCKS;
+        if (st->decrypt) kern->ghash(&k->ghash, st->x, in, n);
+        kern->ctr32(&k->sched, st->ctr, in, out, n);
+        if (!st->decrypt) kern->ghash(&k->ghash, st->x, out, n);
+        in  += n * AES_BLOCK_LEN;
+        out += n * AES_BLOCK_LEN;
+        blocks -= n;
+    }
+
+    size_t rem = len % AES_BLOCK_LEN;
+    if (rem) {
+        memset(st->ks, 0, AES_BLOCK_LEN);
+        kern->ctr32(&k->sched, st->ctr, st->ks, st->ks, 1);
+        for (size_t i = 0; i < rem; i++) {
+            uint8_t c = in[i];
+            uint8_t o = c ^ st->ks[i];
+            st->part[i] = st->decrypt ? c : o;
+            out[i] = o;
+        }
+        st->part_len = rem;
+    }
+    return done > (size_t)INT_MAX ? INT_MAX : (int)done;
+}
+
+int aes_256_gcm_stream_final(aes_gcm_stream *st, uint8_t *tag) {
+    if (!st || !st->key || !tag) {
+        return -1;
+    }
+
+    const aes_intree_key *k = st->key;
+    const aes_kernels *kern = k->kern;
+    if (st->part_len) {
+        memset(st->part + st->part_len, 0, AES_BLOCK_LEN - st->part_len);
+        kern->ghash(&k->ghash, st->x, st->part, 1);
+    }
+
+    uint8_t lens[AES_BLOCK_LEN], expect[AES_GCM_TAG_LEN];
+    store64_be(lens, st->aad_len * 8);
+    store64_be(lens + 8, st->msg_len * 8);
+    kern->ghash(&k->ghash, st->x, lens, 1);
+    for (int i = 0; i < AES_GCM_TAG_LEN; i++) expect[i] = st->x[i] ^ st->ek_j0[i];
+
+    int rc = 0;
+    if (st->decrypt) {
+        uint8_t diff = 0;
+        for (int i = 0; i < AES_GCM_TAG_LEN; i++) diff |= expect[i] ^ tag[i];
+        rc = diff ? -1 : 0;
+    } else {
+        memcpy(tag, expect, AES_GCM_TAG_LEN);
+    }
+    secure_wipe(st, sizeof(*st));
+    return rc;
+}
+
+static int intree_gcm_seal(const void *ctx, const uint8_t *nonce,
+                           const uint8_t *aad, size_t aad_len,
+                           const uint8_t *plaintext, size_t plaintext_len,
+                           uint8_t *ciphertext, uint8_t *tag)
+{
+    if (!ctx || !nonce || (!aad && aad_len) || !plaintext || !ciphertext || !tag ||
+        plaintext_len > (size_t)INT_MAX) {
+        return -1;
+    }
+
+    aes_gcm_stream st;
+    if (gcm_init(&st, ctx, nonce, aad, aad_len, 0) != 0 ||
+        aes_256_gcm_stream_update(&st, plaintext, plaintext_len, ciphertext) < 0 ||
+        aes_256_gcm_stream_final(&st, tag) != 0) {
+        return -1;
+    }
+    return (int)plaintext_len;
+}
+
+static int intree_gcm_open(const void *ctx, const uint8_t *nonce,
+                           const uint8_t *aad, size_t aad_len,
+                           const uint8_t *ciphertext, size_t ciphertext_len,
+                           const uint8_t *tag, uint8_t *plaintext)
+{
+    if (!ctx || !nonce || (!aad && aad_len) || !ciphertext || !tag || !plaintext ||
+        ciphertext_len > (size_t)INT_MAX) {
+        return -1;
+    }
+
+    aes_gcm_stream st;
+    uint8_t expected[AES_GCM_TAG_LEN];
+    memcpy(expected, tag, AES_GCM_TAG_LEN);
+    if (gcm_init(&st, ctx, nonce, aad, aad_len, 1) != 0 ||
+        aes_256_gcm_stream_update(&st, ciphertext, ciphertext_len, plaintext) < 0) {
+        return -1;
+    }
+    if (aes_256_gcm_stream_final(&st, expected) != 0) {
+        secure_wipe(plaintext, ciphertext_len);
         return -1;
     }
+    return (int)ciphertext_len;
+}
+
+/**
+ * Encrypt and authenticate plaintext using AES-256-GCM.
+ */
+int aes_256_gcm_encrypt_keyed(const aes_256_key *k,
+                              const uint8_t *nonce,
+                              const uint8_t *aad, size_t aad_len,
+                              const uint8_t *plaintext, size_t plaintext_len,
+                              uint8_t *ciphertext,
+                              uint8_t *tag)
+{
+    if (!k) return -1;
+    return k->backend->gcm_seal(k->ctx, nonce, aad, aad_len,
+                                plaintext, plaintext_len, ciphertext, tag);
+}
+
+/**
+ * Verify and decrypt ciphertext using AES-256-GCM.
+ * On tag mismatch the output buffer is wiped (in-tree) and -1 is returned.
+ */
+int aes_256_gcm_decrypt_keyed(const aes_256_key *k,
+                              const uint8_t *nonce,
+                              const uint8_t *aad, size_t aad_len,
+                              const uint8_t *ciphertext, size_t ciphertext_len,
+                              const uint8_t *tag,
+                              uint8_t *plaintext)
+{
+    if (!k) return -1;
+    return k->backend->gcm_open(k->ctx, nonce, aad, aad_len,
+                                ciphertext, ciphertext_len, tag, plaintext);
+}
+
+/*=============================================================================
+  AES-GCM-SIV (RFC 8452)
+=============================================================================*/
+
+// RFC 8452 limit on plaintext and AAD: 2^36 bytes
+#define SIV_MAX_LEN  ((uint64_t)1 << 36)
+
+// Per-nonce keys derived from the key-generating key
+typedef struct {
+    aes_schedule enc;
+    ghash_key    auth;
+} siv_keys;
+
+static void reverse16(uint8_t *dst, const uint8_t *src) {
+    for (int i = 0; i < AES_BLOCK_LEN; i++) dst[i] = src[AES_BLOCK_LEN - 1 - i];
+}
+
+/**
+ * POLYVAL runs on the GHASH kernels (RFC 8452, appendix A): GHASH keyed
+ * with mulX_GHASH(ByteReverse(H)) over byte-reversed blocks, with the
+ * accumulator byte-reversed on the way out.
+ */
+static void polyval_init(const aes_kernels *kern, ghash_key *g, const uint8_t *h) {
+    uint8_t v[AES_BLOCK_LEN];
+    reverse16(v, h);
+    uint8_t carry = v[15] & 1;
+    for (int i = 15; i > 0; i--) v[i] = (uint8_t)((v[i] >> 1) | (v[i - 1] << 7));
+    v[0] = (uint8_t)((v[0] >> 1) ^ (0xE1 & -carry));
+    kern->ghash_init(g, v);
+    secure_wipe(v, sizeof(v));
+}
+
+// Fold `len` bytes into the (GHASH-order) accumulator, zero-padding the end
+static void polyval_padded(const aes_kernels *kern, const ghash_key *g, uint8_t *x,
+                           const uint8_t *data, size_t len) {
+    uint8_t buf[GCM_CHUNK_BLOCKS * AES_BLOCK_LEN], block[AES_BLOCK_LEN];
+    while (len > 0) {
+        size_t n = len < sizeof(buf) ? len : sizeof(buf);
+        size_t nblocks = (n + AES_BLOCK_LEN - 1) / AES_BLOCK_LEN;
+        for (size_t j = 0; j < nblocks; j++) {
+            size_t take = n - j * AES_BLOCK_LEN < AES_BLOCK_LEN ? n - j * AES_BLOCK_LEN : AES_BLOCK_LEN;
+            memset(block, 0, sizeof(block));
+            memcpy(block, data + j * AES_BLOCK_LEN, take);
+            reverse16(buf + j * AES_BLOCK_LEN, block);
+        }
+        kern->ghash(g, x, buf, nblocks);
+        data += n;
+        len -= n;
+    }
+    secure_wipe(buf, sizeof(buf));
+    secure_wipe(block, sizeof(block));
+}
+
+// Message keys: the first halves of E(K, LE32(i) || nonce) for i = 0..5
+static void siv_derive(const aes_intree_key *k, const uint8_t *nonce, siv_keys *out) {
+    uint8_t blocks[6 * AES_BLOCK_LEN], auth[16], enc[32];
+    for (int i = 0; i < 6; i++) {
+        store32_le(blocks + i * AES_BLOCK_LEN, (uint32_t)i);
+        memcpy(blocks + i * AES_BLOCK_LEN + 4, nonce, AES_GCM_SIV_NONCE_LEN);
+    }
+    k->kern->encrypt_blocks(&k->sched, blocks, blocks, 6);
+    for (int i = 0; i < 2; i++) memcpy(auth + 8 * i, blocks + i * AES_BLOCK_LEN, 8);
+    for (int i = 0; i < 4; i++) memcpy(enc + 8 * i, blocks + (i + 2) * AES_BLOCK_LEN, 8);
+
+    aes_expand_key(&out->enc, enc);
+    polyval_init(k->kern, &out->auth, auth);
+    secure_wipe(blocks, sizeof(blocks));
+    secure_wipe(auth, sizeof(auth));
+    secure_wipe(enc, sizeof(enc));
+}
+
+static void siv_tag(const aes_kernels *kern, const siv_keys *sk, const uint8_t *nonce,
+                    const uint8_t *aad, size_t aad_len,
+                    const uint8_t *plaintext, size_t len, uint8_t *tag) {
+    uint8_t x[AES_BLOCK_LEN] = {0}, lens[AES_BLOCK_LEN], s[AES_BLOCK_LEN];
+    polyval_padded(kern, &sk->auth, x, aad, aad_len);
+    polyval_padded(kern, &sk->auth, x, plaintext, len);
+    store64_le(lens, (uint64_t)aad_len * 8);
+    store64_le(lens + 8, (uint64_t)len * 8);
+    polyval_padded(kern, &sk->auth, x, lens, sizeof(lens));
+
+    reverse16(s, x);
+    for (int i = 0; i < AES_GCM_SIV_NONCE_LEN; i++) s[i] ^= nonce[i];
+    s[15] &= 0x7F;
+    kern->encrypt_blocks(&sk->enc, s, tag, 1);
+    secure_wipe(x, sizeof(x));
+    secure_wipe(s, sizeof(s));
+}
+
+// CTR keyed by the tag, with a 32-bit little-endian counter in bytes 0..3
+static void siv_ctr(const aes_kernels *kern, const siv_keys *sk, const uint8_t *tag,
+                    const uint8_t *in, size_t len, uint8_t *out) {
+    uint8_t ctr[AES_BLOCK_LEN], ks[GCM_CHUNK_BLOCKS * AES_BLOCK_LEN];
+    memcpy(ctr, tag, AES_BLOCK_LEN);
+    ctr[15] |= 0x80;
+    uint32_t c = load32_le(ctr);
+
+    while (len > 0) {
+        size_t n = len < sizeof(ks) ? len : sizeof(ks);
+        size_t nblocks = (n + AES_BLOCK_LEN - 1) / AES_BLOCK_LEN;
+        for (size_t j = 0; j < nblocks; j++) {
+            memcpy(ks + j * AES_BLOCK_LEN, ctr, AES_BLOCK_LEN);
+            store32_le(ks + j * AES_BLOCK_LEN, c++);
+        }
+        kern->encrypt_blocks(&sk->enc, ks, ks, nblocks);
+        for (size_t i = 0; i < n; i++) out[i] = in[i] ^ ks[i];
+        in  += n;
+        out += n;
+        len -= n;
+    }
+    secure_wipe(ks, sizeof(ks));
+}
 
-    if (1 != EVP_DecryptUpdate(ctx, plaintext, &len, ciphertext, (int)ciphertext_len)) {
-        EVP_CIPHER_CTX_free(ctx);
+/**
+ * Encrypt with AES-256-GCM-SIV: the tag is computed over the plaintext
+ * first and then keys the CTR pass, so in == out is allowed.
+ */
+int aes_256_gcm_siv_encrypt_keyed(const aes_256_key *key,
+                                  const uint8_t *nonce,
+                                  const uint8_t *aad, size_t aad_len,
+                                  const uint8_t *plaintext, size_t plaintext_len,
+                                  uint8_t *ciphertext,
+                                  uint8_t *tag)
+{
+    if (!key || !nonce || (!aad && aad_len) || (!plaintext && plaintext_len) ||
+        (!ciphertext && plaintext_len) || !tag ||
+        plaintext_len > (size_t)INT_MAX || aad_len > SIV_MAX_LEN) {
         return -1;
     }
-    plaintext_len = len;
 
-    if (1 != EVP_DecryptFinal_ex(ctx, plaintext + len, &len)) {
-        EVP_CIPHER_CTX_free(ctx);
+    const aes_intree_key *k = key->intree;
+    siv_keys sk;
+    siv_derive(k, nonce, &sk);
+    siv_tag(k->kern, &sk, nonce, aad, aad_len, plaintext, plaintext_len, tag);
+    siv_ctr(k->kern, &sk, tag, plaintext, plaintext_len, ciphertext);
+    secure_wipe(&sk, sizeof(sk));
+    return (int)plaintext_len;
+}
+
+/**
+ * Decrypt and verify with AES-256-GCM-SIV. On tag mismatch the keystream is
+ * applied a second time, so `plaintext` ends up holding the ciphertext
+ * rather than unauthenticated plaintext; in place, the input is restored.
+ */
+int aes_256_gcm_siv_decrypt_keyed(const aes_256_key *key,
+                                  const uint8_t *nonce,
+                                  const uint8_t *aad, size_t aad_len,
+                                  const uint8_t *ciphertext, size_t ciphertext_len,
+                                  const uint8_t *tag,
+                                  uint8_t *plaintext)
+{
+    if (!key || !nonce || (!aad && aad_len) || (!ciphertext && ciphertext_len) ||
+        (!plaintext && ciphertext_len) || !tag ||
+        ciphertext_len > (size_t)INT_MAX || aad_len > SIV_MAX_LEN) {
         return -1;
     }
-    plaintext_len += len;
 
-    EVP_CIPHER_CTX_free(ctx);
-    return plaintext_len;
-}
\ No newline at end of file
+    const aes_intree_key *k = key->intree;
+    uint8_t received[AES_GCM_TAG_LEN], expect[AES_GCM_TAG_LEN];
+    memcpy(received, tag, AES_GCM_TAG_LEN);   // `tag` may lie inside `plaintext`
+
+    siv_keys sk;
+    siv_derive(k, nonce, &sk);
+    siv_ctr(k->kern, &sk, received, ciphertext, ciphertext_len, plaintext);
+    siv_tag(k->kern, &sk, nonce, aad, aad_len, plaintext, ciphertext_len, expect);
+
+    uint8_t diff = 0;
+    for (int i = 0; i < AES_GCM_TAG_LEN; i++) diff |= expect[i] ^ received[i];
+    if (diff) siv_ctr(k->kern, &sk, received, plaintext, ciphertext_len, plaintext);
+    secure_wipe(&sk, sizeof(sk));
+    secure_wipe(expect, sizeof(expect));
+    return diff ? -1 : (int)ciphertext_len;
+}
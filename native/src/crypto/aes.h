@@ -1,8 +1,15 @@
 // native/src/crypto/aes.h
-// AES-256-CBC encryption/decryption interface for OpenLockr.
-// Uses OpenSSL EVP under the hood.
+// AES-256-CBC and AES-256-GCM encryption/decryption interface for OpenLockr.
+// The keyed operations run on a pluggable backend. The in-tree backends are
+// AES-NI+PCLMULQDQ on x86, ARMv8 Crypto Extensions on arm64 and a
+// constant-time portable fallback; OpenSSL EVP is added when built with
+// OPENLOCKR_WITH_OPENSSL. By default the fastest in-tree backend the CPU
+// supports is selected.
 //
 // Functions return the number of bytes written on success, or -1 on error.
+//
+// The one-shot functions expand the key schedule on every call.  Hot paths
+// should create an aes_256_key once and use the *_keyed variants instead.
 
 #ifndef OPENLOCKR_AES_H
 #define OPENLOCKR_AES_H
@@ -14,6 +21,91 @@
 extern "C" {
 #endif
 
+#define AES_GCM_NONCE_LEN      12   ///< GCM nonce (IV) length in bytes
+#define AES_GCM_TAG_LEN        16   ///< GCM authentication tag length in bytes
+#define AES_GCM_SIV_NONCE_LEN  12   ///< GCM-SIV nonce length in bytes
+
+/*=============================================================================
+  Backends
+=============================================================================*/
+
+/**
+ * AES-256 backend: a keyed-context constructor plus the keyed CBC and GCM
+ * operations. Each operation has the contract of the matching
+ * aes_256_*_keyed() function below, with the backend's context in place of
+ * the key object. A context must be usable from several threads at once.
+ */
+typedef struct aes_backend {
+    const char *name;       ///< e.g. "aesni", "armv8-ce", "portable", "openssl"
+    const void *impl;       ///< backend-private data, passed back through `self`
+    int         hardware;   ///< non-zero if AES runs on dedicated instructions
+
+    void *(*key_new)(const struct aes_backend *self, const uint8_t *key);
+    void  (*key_free)(void *ctx);
+
+    int (*cbc_encrypt)(const void *ctx, const uint8_t *iv,
+                       const uint8_t *in, size_t len, uint8_t *out);
+    int (*cbc_decrypt)(const void *ctx, const uint8_t *iv,
+                       const uint8_t *in, size_t len, uint8_t *out);
+    int (*gcm_seal)(const void *ctx, const uint8_t *nonce,
+                    const uint8_t *aad, size_t aad_len,
+                    const uint8_t *in, size_t len,
+                    uint8_t *out, uint8_t *tag);
+    int (*gcm_open)(const void *ctx, const uint8_t *nonce,
+                    const uint8_t *aad, size_t aad_len,
+                    const uint8_t *in, size_t len,
+                    const uint8_t *tag, uint8_t *out);
+} aes_backend;
+
+/**
+ * Number of registered backends. The in-tree backends this CPU supports
+ * come first, fastest first, followed by OpenSSL and any added with
+ * aes_backend_register().
+ */
+size_t aes_backend_count(void);
+
+/**
+ * Backend at `index`, or NULL if out of range.
+ */
+const aes_backend *aes_backend_get(size_t index);
+
+/**
+ * Backend used by keys created from now on.
+ */
+const aes_backend *aes_backend_selected(void);
+
+/**
+ * Select the backend named `name` for keys created from now on; existing
+ * keys keep the backend they were created with.
+ *
+ * @return 0 on success, or -1 if no registered backend has that name.
+ */
+int aes_backend_select(const char *name);
+
+/**
+ * Register an additional backend. `b` must stay valid for the life of the
+ * process. It is not selected automatically.
+ *
+ * @return 0 on success, or -1 if the table is full or `b` is incomplete.
+ */
+int aes_backend_register(const aes_backend *b);
+
+/*=============================================================================
+  AES-256
+=============================================================================*/
+
+/**
+ * Name of the selected backend ("aesni", "armv8-ce", "portable", ...).
+ * Triggers CPU detection on first call.
+ */
+const char *aes_implementation(void);
+
+/**
+ * Non-zero if AES runs on dedicated instructions (AES-NI or ARMv8 Crypto
+ * Extensions) on this device, zero if the portable fallback is in use.
+ */
+int aes_hardware_accelerated(void);
+
 /**
  * Encrypt plaintext using AES-256-CBC.
  *
@@ -52,6 +144,300 @@ int aes_256_cbc_decrypt(const uint8_t *key,
                         size_t ciphertext_len,
                         uint8_t *plaintext);
 
+/**
+ * Opaque keyed AES-256 cipher object.
+ *
+ * Holds the selected backend's keyed context. Streaming GCM and batch CBC
+ * always run on the in-tree kernels, so for an external backend the object
+ * also carries an in-tree key schedule. It is never written after creation,
+ * so one object may be shared by any number of threads; per-call cipher
+ * state lives on the caller's stack.
+ */
+typedef struct aes_256_key aes_256_key;
+
+/**
+ * Create a keyed AES-256 cipher object.
+ *
+ * @param key      Pointer to a 32-byte (256‑bit) AES key.
+ * @param key_len  Length of the key; must be 32.
+ * @return New object (free with aes_256_key_free()), or NULL on error.
+ */
+aes_256_key *aes_256_key_new(const uint8_t *key, size_t key_len);
+
+/**
+ * Destroy a keyed cipher object, wiping the key schedule.
+ * No thread may be using the object when this is called.
+ *
+ * @param k  Object returned by aes_256_key_new(); NULL is ignored.
+ */
+void aes_256_key_free(aes_256_key *k);
+
+/**
+ * Encrypt plaintext using AES-256-CBC with a keyed cipher object.
+ *
+ * @param k               Keyed cipher object.
+ * @param iv              Pointer to a 16-byte (128‑bit) initialization vector.
+ * @param plaintext       Pointer to the input data to encrypt.
+ * @param plaintext_len   Length in bytes of the input data.
+ * @param ciphertext      Pointer to an output buffer to receive ciphertext.
+ *                        Must be at least plaintext_len + AES_BLOCK_SIZE bytes.
+ * @return The number of bytes written to ciphertext (≥ 1), or -1 on error.
+ */
+int aes_256_cbc_encrypt_keyed(const aes_256_key *k,
+                              const uint8_t *iv,
+                              const uint8_t *plaintext,
+                              size_t plaintext_len,
+                              uint8_t *ciphertext);
+
+/**
+ * Decrypt ciphertext using AES-256-CBC with a keyed cipher object.
+ *
+ * @param k                Keyed cipher object.
+ * @param iv               Pointer to a 16-byte (128‑bit) initialization vector.
+ * @param ciphertext       Pointer to the input data to decrypt.
+ * @param ciphertext_len   Length in bytes of the input data.
+ * @param plaintext        Pointer to an output buffer to receive plaintext.
+ *                         Must be at least ciphertext_len bytes.
+ * @return The number of bytes written to plaintext (≥ 0), or -1 on error.
+ */
+int aes_256_cbc_decrypt_keyed(const aes_256_key *k,
+                              const uint8_t *iv,
+                              const uint8_t *ciphertext,
+                              size_t ciphertext_len,
+                              uint8_t *plaintext);
+
+/**
+ * Ciphertext size of AES-256-CBC with PKCS#7 padding for `n` plaintext bytes
+ * (always at least one byte of padding).
+ */
+#define AES_CBC_PADDED_LEN(n)  (((n) / 16 + 1) * 16)
+
+/**
+ * Encrypt using AES-256-CBC in place.
+ *
+ * The first `len` bytes of `buf` are replaced by the ciphertext, which grows
+ * by up to 16 bytes of padding; the caller reserves that headroom.
+ *
+ * @param k        Keyed cipher object.
+ * @param iv       Pointer to a 16-byte (128‑bit) initialization vector.
+ * @param buf      Buffer holding the plaintext; receives the ciphertext.
+ * @param len      Length in bytes of the plaintext.
+ * @param buf_cap  Total size of `buf`; at least AES_CBC_PADDED_LEN(len).
+ * @return The ciphertext length (≥ 16), or -1 on error.
+ */
+int aes_256_cbc_encrypt_inplace(const aes_256_key *k,
+                                const uint8_t *iv,
+                                uint8_t *buf,
+                                size_t len,
+                                size_t buf_cap);
+
+/**
+ * Decrypt using AES-256-CBC in place and strip the padding.
+ *
+ * @param k        Keyed cipher object.
+ * @param iv       Pointer to a 16-byte (128‑bit) initialization vector.
+ * @param buf      Buffer holding the ciphertext; receives the plaintext.
+ * @param len      Length in bytes of the ciphertext.
+ * @return The plaintext length (≥ 0), or -1 on error.
+ */
+int aes_256_cbc_decrypt_inplace(const aes_256_key *k,
+                                const uint8_t *iv,
+                                uint8_t *buf,
+                                size_t len);
+
+/**
+ * One entry of a batch CBC decryption (see aes_256_cbc_decrypt_batch()).
+ */
+typedef struct {
+    const uint8_t *iv;              ///< 16-byte IV for this entry
+    const uint8_t *ciphertext;      ///< Input ciphertext
+    size_t         ciphertext_len;  ///< Multiple of 16, non-zero
+    uint8_t       *plaintext;       ///< Output, at least ciphertext_len bytes;
+                                    ///< may equal ciphertext (in place)
+    int            result;          ///< Out: plaintext length, or -1 on error
+} aes_cbc_batch_item;
+
+/**
+ * Decrypt many independent AES-256-CBC ciphertexts under one key.
+ *
+ * CBC decryption has no serial dependency, so blocks from different entries
+ * are gathered into groups of eight and fed through the cipher together.
+ * Entries of only a block or two (typical vault rows) then run at pipelined
+ * throughput instead of one latency-bound block at a time.
+ *
+ * @param k      Keyed cipher object.
+ * @param items  Array of `count` descriptors; each `result` is filled in.
+ *               Entries must not overlap one another.
+ * @param count  Number of descriptors.
+ * @return The number of entries that failed (0 if all succeeded), or -1 if
+ *         the arguments are invalid.
+ */
+int aes_256_cbc_decrypt_batch(const aes_256_key *k,
+                              aes_cbc_batch_item *items,
+                              size_t count);
+
+/**
+ * Encrypt and authenticate plaintext using AES-256-GCM in a single pass.
+ *
+ * A nonce must never be reused with the same key.
+ *
+ * @param k               Keyed cipher object.
+ * @param nonce           Pointer to a 12-byte (96‑bit) nonce.
+ * @param aad             Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len         Length in bytes of the additional data.
+ * @param plaintext       Pointer to the input data to encrypt.
+ * @param plaintext_len   Length in bytes of the input data.
+ * @param ciphertext      Pointer to an output buffer of at least plaintext_len bytes.
+ * @param tag             Pointer to a 16-byte buffer to receive the tag.
+ * @return The number of bytes written to ciphertext (= plaintext_len), or -1 on error.
+ */
+int aes_256_gcm_encrypt_keyed(const aes_256_key *k,
+                              const uint8_t *nonce,
+                              const uint8_t *aad,
+                              size_t aad_len,
+                              const uint8_t *plaintext,
+                              size_t plaintext_len,
+                              uint8_t *ciphertext,
+                              uint8_t *tag);
+
+/**
+ * Verify and decrypt ciphertext using AES-256-GCM.
+ *
+ * @param k                Keyed cipher object.
+ * @param nonce            Pointer to the 12-byte (96‑bit) nonce used to encrypt.
+ * @param aad              Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len          Length in bytes of the additional data.
+ * @param ciphertext       Pointer to the input data to decrypt.
+ * @param ciphertext_len   Length in bytes of the input data.
+ * @param tag              Pointer to the 16-byte tag to verify.
+ * @param plaintext        Pointer to an output buffer of at least ciphertext_len bytes.
+ *                         Its contents are unspecified if verification fails.
+ * @return The number of bytes written to plaintext (≥ 0), or -1 on error or
+ *         authentication failure.
+ */
+int aes_256_gcm_decrypt_keyed(const aes_256_key *k,
+                              const uint8_t *nonce,
+                              const uint8_t *aad,
+                              size_t aad_len,
+                              const uint8_t *ciphertext,
+                              size_t ciphertext_len,
+                              const uint8_t *tag,
+                              uint8_t *plaintext);
+
+/**
+ * Incremental AES-256-GCM state for data that arrives in pieces.
+ *
+ * The struct is public so it can live on the caller's stack; its fields are
+ * private. Output of an init/update.../final sequence is byte-identical to
+ * the one-shot functions for the same key, nonce and AAD.
+ */
+typedef struct {
+    const void *key;
+    uint8_t  ctr[16];      // next counter block
+    uint8_t  ek_j0[16];    // E(K, J0), masks the tag
+    uint8_t  x[16];        // GHASH accumulator
+    uint8_t  ks[16];       // keystream of the current partial block
+    uint8_t  part[16];     // ciphertext of the current partial block
+    size_t   part_len;
+    uint64_t aad_len;
+    uint64_t msg_len;
+    int      decrypt;
+} aes_gcm_stream;
+
+/**
+ * Start a streaming GCM operation.
+ *
+ * @param st       State to initialize.
+ * @param k        Keyed cipher object; must outlive the stream.
+ * @param nonce    Pointer to a 12-byte (96‑bit) nonce.
+ * @param aad      Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len  Length in bytes of the additional data.
+ * @param decrypt  0 to encrypt, non-zero to decrypt.
+ * @return 0 on success, or -1 on error.
+ */
+int aes_256_gcm_stream_init(aes_gcm_stream *st, const aes_256_key *k,
+                            const uint8_t *nonce,
+                            const uint8_t *aad, size_t aad_len,
+                            int decrypt);
+
+/**
+ * Process the next `len` bytes. Any length is accepted; exactly `len` bytes
+ * are written to `out` (in and out may alias).
+ *
+ * When decrypting, the output is unauthenticated until
+ * aes_256_gcm_stream_final() succeeds and must be discarded otherwise.
+ *
+ * @return `len` (clamped to INT_MAX) on success, or -1 on error.
+ */
+int aes_256_gcm_stream_update(aes_gcm_stream *st,
+                              const uint8_t *in, size_t len,
+                              uint8_t *out);
+
+/**
+ * Finish the stream and wipe the state.
+ * Encrypting: writes the 16-byte tag to `tag`.
+ * Decrypting: compares `tag` against the computed one in constant time.
+ *
+ * @return 0 on success, or -1 on error or tag mismatch.
+ */
+int aes_256_gcm_stream_final(aes_gcm_stream *st, uint8_t *tag);
+
+/**
+ * Encrypt and authenticate plaintext using AES-256-GCM-SIV (RFC 8452).
+ *
+ * Nonce-misuse resistant: repeating a nonce only reveals whether two
+ * messages are identical. With a fixed nonce the mode is deterministic, so
+ * equal (aad, plaintext) pairs give equal ciphertext and tag, and the tag
+ * (the synthetic IV) can serve as a content address for deduplication.
+ *
+ * Two passes over the data, always on the in-tree kernels; in and out may
+ * alias.
+ *
+ * @param k               Keyed cipher object (the key-generating key).
+ * @param nonce           Pointer to a 12-byte (96‑bit) nonce.
+ * @param aad             Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len         Length in bytes of the additional data.
+ * @param plaintext       Pointer to the input data to encrypt.
+ * @param plaintext_len   Length in bytes of the input data.
+ * @param ciphertext      Pointer to an output buffer of at least plaintext_len bytes.
+ * @param tag             Pointer to a 16-byte buffer to receive the tag.
+ * @return The number of bytes written to ciphertext (= plaintext_len), or -1 on error.
+ */
+int aes_256_gcm_siv_encrypt_keyed(const aes_256_key *k,
+                                  const uint8_t *nonce,
+                                  const uint8_t *aad,
+                                  size_t aad_len,
+                                  const uint8_t *plaintext,
+                                  size_t plaintext_len,
+                                  uint8_t *ciphertext,
+                                  uint8_t *tag);
+
+/**
+ * Decrypt and verify ciphertext using AES-256-GCM-SIV (RFC 8452).
+ *
+ * @param k                Keyed cipher object (the key-generating key).
+ * @param nonce            Pointer to the 12-byte (96‑bit) nonce used to encrypt.
+ * @param aad              Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len          Length in bytes of the additional data.
+ * @param ciphertext       Pointer to the input data to decrypt.
+ * @param ciphertext_len   Length in bytes of the input data.
+ * @param tag              Pointer to the 16-byte tag to verify.
+ * @param plaintext        Pointer to an output buffer of at least ciphertext_len
+ *                         bytes; may equal ciphertext. If verification fails
+ *                         it holds a copy of the ciphertext, so decrypting in
+ *                         place leaves the input unchanged.
+ * @return The number of bytes written to plaintext (≥ 0), or -1 on error or
+ *         authentication failure.
+ */
+int aes_256_gcm_siv_decrypt_keyed(const aes_256_key *k,
+                                  const uint8_t *nonce,
+                                  const uint8_t *aad,
+                                  size_t aad_len,
+                                  const uint8_t *ciphertext,
+                                  size_t ciphertext_len,
+                                  const uint8_t *tag,
+                                  uint8_t *plaintext);
+
 #ifdef __cplusplus
 }
 #endif
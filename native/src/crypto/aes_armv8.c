@@ -0,0 +1,227 @@
+// native/src/crypto/aes_armv8.c
+// AES-256 and GHASH kernels using the ARMv8 Crypto Extensions (arm64).
+//
+// Built with -march=armv8-a+crypto (see CMakeLists.txt); only reached after
+// cpu_features() reports AES and PMULL.
+
+#include "aes_impl.h"
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+
+#include <arm_neon.h>
+
+static void load_keys(uint8x16_t *k, const uint8_t (*rk)[AES_BLOCK_LEN]) {
+    for (int r = 0; r <= AES_256_ROUNDS; r++) k[r] = vld1q_u8(rk[r]);
+}
+
+// AESE = AddRoundKey + SubBytes + ShiftRows, so the key is folded in first
+static inline uint8x16_t enc1(const uint8x16_t *k, uint8x16_t b) {
+    for (int r = 0; r < AES_256_ROUNDS - 1; r++) b = vaesmcq_u8(vaeseq_u8(b, k[r]));
+    b = vaeseq_u8(b, k[AES_256_ROUNDS - 1]);
+    return veorq_u8(b, k[AES_256_ROUNDS]);
+}
+
+static inline uint8x16_t dec1(const uint8x16_t *k, uint8x16_t b) {
+    for (int r = 0; r < AES_256_ROUNDS - 1; r++) b = vaesimcq_u8(vaesdq_u8(b, k[r]));
+    b = vaesdq_u8(b, k[AES_256_ROUNDS - 1]);
+    return veorq_u8(b, k[AES_256_ROUNDS]);
+}
+
+static inline void enc8(const uint8x16_t *k, uint8x16_t *b) {
+    for (int r = 0; r < AES_256_ROUNDS - 1; r++)
+        for (int j = 0; j < 8; j++) b[j] = vaesmcq_u8(vaeseq_u8(b[j], k[r]));
+    for (int j = 0; j < 8; j++)
+        b[j] = veorq_u8(vaeseq_u8(b[j], k[AES_256_ROUNDS - 1]), k[AES_256_ROUNDS]);
+}
+
+static inline void dec8(const uint8x16_t *k, uint8x16_t *b) {
+    for (int r = 0; r < AES_256_ROUNDS - 1; r++)
+        for (int j = 0; j < 8; j++) b[j] = vaesimcq_u8(vaesdq_u8(b[j], k[r]));
+    for (int j = 0; j < 8; j++)
+        b[j] = veorq_u8(vaesdq_u8(b[j], k[AES_256_ROUNDS - 1]), k[AES_256_ROUNDS]);
+}
+
+static void armv8_encrypt_blocks(const aes_schedule *s, const uint8_t *in,
+                                 uint8_t *out, size_t nblocks) {
+    uint8x16_t k[AES_256_ROUNDS + 1], b[8];
+    load_keys(k, s->rk);
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) b[j] = vld1q_u8(in + 16 * j);
+        enc8(k, b);
+        for (int j = 0; j < 8; j++) vst1q_u8(out + 16 * j, b[j]);
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16)
+        vst1q_u8(out, enc1(k, vld1q_u8(in)));
+}
+
+static void armv8_decrypt_blocks(const aes_schedule *s, const uint8_t *in,
+                                 uint8_t *out, size_t nblocks) {
+    uint8x16_t k[AES_256_ROUNDS + 1], b[8];
+    load_keys(k, s->drk);
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) b[j] = vld1q_u8(in + 16 * j);
+        dec8(k, b);
+        for (int j = 0; j < 8; j++) vst1q_u8(out + 16 * j, b[j]);
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16)
+        vst1q_u8(out, dec1(k, vld1q_u8(in)));
+}
+
+static void armv8_cbc_encrypt(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                              uint8_t *out, size_t nblocks) {
+    uint8x16_t k[AES_256_ROUNDS + 1];
+    load_keys(k, s->rk);
+    uint8x16_t c = vld1q_u8(iv);
+    for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+        c = enc1(k, veorq_u8(c, vld1q_u8(in)));
+        vst1q_u8(out, c);
+    }
+    vst1q_u8(iv, c);
+}
+
+static void armv8_cbc_decrypt(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                              uint8_t *out, size_t nblocks) {
+    uint8x16_t k[AES_256_ROUNDS + 1], c[8], b[8];
+    load_keys(k, s->drk);
+    uint8x16_t prev = vld1q_u8(iv);
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) b[j] = c[j] = vld1q_u8(in + 16 * j);
+        dec8(k, b);
+        vst1q_u8(out, veorq_u8(b[0], prev));
+        for (int j = 1; j < 8; j++) vst1q_u8(out + 16 * j, veorq_u8(b[j], c[j - 1]));
+        prev = c[7];
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+        uint8x16_t ct = vld1q_u8(in);
+        vst1q_u8(out, veorq_u8(dec1(k, ct), prev));
+        prev = ct;
+    }
+    vst1q_u8(iv, prev);
+}
+
+static void armv8_ctr32(const aes_schedule *s, uint8_t *ctr, const uint8_t *in,
+                        uint8_t *out, size_t nblocks) {
+    // Reverse bytes within each 32-bit lane so lane 3 holds the counter
+    // natively and vaddq_u32 gives inc32 semantics.
+    static const uint32_t one_lanes[4] = { 0, 0, 0, 1 };
+    const uint32x4_t one = vld1q_u32(one_lanes);
+    uint8x16_t k[AES_256_ROUNDS + 1], b[8];
+    load_keys(k, s->rk);
+    uint32x4_t c = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(ctr)));
+
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) {
+            b[j] = vrev32q_u8(vreinterpretq_u8_u32(c));
+            c = vaddq_u32(c, one);
+        }
+        enc8(k, b);
+        for (int j = 0; j < 8; j++)
+            vst1q_u8(out + 16 * j, veorq_u8(b[j], vld1q_u8(in + 16 * j)));
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+        uint8x16_t ks = enc1(k, vrev32q_u8(vreinterpretq_u8_u32(c)));
+        vst1q_u8(out, veorq_u8(ks, vld1q_u8(in)));
+        c = vaddq_u32(c, one);
+    }
+    vst1q_u8(ctr, vrev32q_u8(vreinterpretq_u8_u32(c)));
+}
+
+/*=============================================================================
+  GHASH with PMULL. Bits are reversed within each byte on load, which turns
+  GCM's reflected field elements into ordinary little-endian polynomials.
+=============================================================================*/
+
+static inline uint64x2_t pmull(uint64_t a, uint64_t b) {
+    return vreinterpretq_u64_p128(vmull_p64((poly64_t)a, (poly64_t)b));
+}
+
+static inline uint64x2_t load_elem(const uint8_t *p) {
+    return vreinterpretq_u64_u8(vrbitq_u8(vld1q_u8(p)));
+}
+
+static inline void store_elem(uint8_t *p, uint64x2_t v) {
+    vst1q_u8(p, vrbitq_u8(vreinterpretq_u8_u64(v)));
+}
+
+// Accumulate the unreduced product a*b as lo + mid·x^64 + hi·x^128
+static inline void clmul_acc(uint64x2_t a, uint64x2_t b,
+                             uint64x2_t *lo, uint64x2_t *mid, uint64x2_t *hi) {
+    uint64_t a0 = vgetq_lane_u64(a, 0), a1 = vgetq_lane_u64(a, 1);
+    uint64_t b0 = vgetq_lane_u64(b, 0), b1 = vgetq_lane_u64(b, 1);
+    *lo  = veorq_u64(*lo, pmull(a0, b0));
+    *hi  = veorq_u64(*hi, pmull(a1, b1));
+    *mid = veorq_u64(*mid, veorq_u64(pmull(a0, b1), pmull(a1, b0)));
+}
+
+// Reduce modulo x^128 + x^7 + x^2 + x + 1 by folding the top words twice
+static inline uint64x2_t gf_reduce(uint64x2_t lo, uint64x2_t mid, uint64x2_t hi) {
+    uint64_t r0 = vgetq_lane_u64(lo, 0);
+    uint64_t r1 = vgetq_lane_u64(lo, 1) ^ vgetq_lane_u64(mid, 0);
+    uint64_t r2 = vgetq_lane_u64(hi, 0) ^ vgetq_lane_u64(mid, 1);
+    uint64_t r3 = vgetq_lane_u64(hi, 1);
+
+    uint64x2_t t = pmull(r3, 0x87);
+    r1 ^= vgetq_lane_u64(t, 0);
+    r2 ^= vgetq_lane_u64(t, 1);
+    t = pmull(r2, 0x87);
+    r0 ^= vgetq_lane_u64(t, 0);
+    r1 ^= vgetq_lane_u64(t, 1);
+
+    return vcombine_u64(vcreate_u64(r0), vcreate_u64(r1));
+}
+
+static inline uint64x2_t gf_mul(uint64x2_t a, uint64x2_t b) {
+    uint64x2_t lo = vdupq_n_u64(0), mid = vdupq_n_u64(0), hi = vdupq_n_u64(0);
+    clmul_acc(a, b, &lo, &mid, &hi);
+    return gf_reduce(lo, mid, hi);
+}
+
+// g->w holds H, H^2, H^3, H^4 (bit-reversed per byte)
+static void armv8_ghash_init(ghash_key *g, const uint8_t *h) {
+    uint64x2_t p[4];
+    p[0] = load_elem(h);
+    for (int i = 1; i < 4; i++) p[i] = gf_mul(p[i - 1], p[0]);
+    for (int i = 0; i < 4; i++) vst1q_u64(&g->w[2 * i], p[i]);
+}
+
+static void armv8_ghash(const ghash_key *g, uint8_t *x, const uint8_t *in, size_t nblocks) {
+    uint64x2_t h1 = vld1q_u64(&g->w[0]), h2 = vld1q_u64(&g->w[2]);
+    uint64x2_t h3 = vld1q_u64(&g->w[4]), h4 = vld1q_u64(&g->w[6]);
+    uint64x2_t y = load_elem(x);
+
+    for (; nblocks >= 4; nblocks -= 4, in += 64) {
+        uint64x2_t lo = vdupq_n_u64(0), mid = vdupq_n_u64(0), hi = vdupq_n_u64(0);
+        clmul_acc(veorq_u64(y, load_elem(in)), h4, &lo, &mid, &hi);
+        clmul_acc(load_elem(in + 16), h3, &lo, &mid, &hi);
+        clmul_acc(load_elem(in + 32), h2, &lo, &mid, &hi);
+        clmul_acc(load_elem(in + 48), h1, &lo, &mid, &hi);
+        y = gf_reduce(lo, mid, hi);
+    }
+    for (; nblocks > 0; nblocks--, in += 16)
+        y = gf_mul(veorq_u64(y, load_elem(in)), h1);
+
+    store_elem(x, y);
+}
+
+static const aes_kernels k_armv8 = {
+    "armv8-ce",
+    armv8_encrypt_blocks,
+    armv8_decrypt_blocks,
+    armv8_cbc_encrypt,
+    armv8_cbc_decrypt,
+    armv8_ctr32,
+    armv8_ghash_init,
+    armv8_ghash,
+};
+
+const aes_kernels *aes_kernels_armv8(void) {
+    return &k_armv8;
+}
+
+#else
+
+const aes_kernels *aes_kernels_armv8(void) {
+    return NULL;
+}
+
+#endif
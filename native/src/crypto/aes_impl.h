@@ -0,0 +1,82 @@
+// native/src/crypto/aes_impl.h
+// Internal AES-256 kernel interface shared by aes.c and the per-ISA kernels.
+// Not part of the public API.
+//
+// Every kernel consumes the same byte-order key schedule (FIPS-197 round keys
+// plus the "equivalent inverse cipher" decryption keys), so the schedule is
+// expanded once in portable code regardless of which kernel runs.
+
+#ifndef OPENLOCKR_AES_IMPL_H
+#define OPENLOCKR_AES_IMPL_H
+
+#include "aes.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define AES_BLOCK_LEN   16
+#define AES_256_ROUNDS  14
+
+// Expanded AES-256 key schedule
+typedef struct {
+    uint8_t  rk[AES_256_ROUNDS + 1][AES_BLOCK_LEN];   // encryption round keys
+    uint8_t  drk[AES_256_ROUNDS + 1][AES_BLOCK_LEN];  // decryption keys, in use order
+    uint64_t bs_rk[AES_256_ROUNDS + 1][8];            // rk as bit-planes (portable)
+} aes_schedule;
+
+// Kernel-specific precomputed GHASH key (powers of H, tables, ...)
+typedef struct {
+    uint64_t w[16];
+} ghash_key;
+
+typedef struct {
+    const char *name;
+
+    // ECB over `nblocks` 16-byte blocks; in and out may alias.
+    void (*encrypt_blocks)(const aes_schedule *s, const uint8_t *in,
+                           uint8_t *out, size_t nblocks);
+    void (*decrypt_blocks)(const aes_schedule *s, const uint8_t *in,
+                           uint8_t *out, size_t nblocks);
+
+    // CBC over whole blocks; `iv` is updated to the last ciphertext block.
+    void (*cbc_encrypt)(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                        uint8_t *out, size_t nblocks);
+    void (*cbc_decrypt)(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                        uint8_t *out, size_t nblocks);
+
+    // CTR with a 32-bit big-endian counter in the last four bytes of `ctr`
+    // (GCM inc32); `ctr` is advanced by `nblocks`.
+    void (*ctr32)(const aes_schedule *s, uint8_t *ctr, const uint8_t *in,
+                  uint8_t *out, size_t nblocks);
+
+    // GHASH: precompute from H = E(K, 0^128), then fold whole blocks into X.
+    void (*ghash_init)(ghash_key *g, const uint8_t *h);
+    void (*ghash)(const ghash_key *g, uint8_t *x, const uint8_t *in, size_t nblocks);
+} aes_kernels;
+
+/**
+ * Expand a 32-byte key into `s` (portable, constant-time).
+ */
+void aes_expand_key(aes_schedule *s, const uint8_t *key);
+
+/**
+ * Kernel tables. The hardware getters return NULL when the kernel was not
+ * compiled for this ABI; callers must still check CPU features before use.
+ */
+const aes_kernels *aes_kernels_portable(void);
+const aes_kernels *aes_kernels_x86(void);    // AES-NI + PCLMULQDQ
+const aes_kernels *aes_kernels_armv8(void);  // ARMv8 Crypto Extensions
+
+// Keyed context of the in-tree backends; also drives streaming GCM and batch
+// CBC whichever backend is selected.
+typedef struct {
+    const aes_kernels *kern;
+    aes_schedule       sched;
+    ghash_key          ghash;
+} aes_intree_key;
+
+/**
+ * OpenSSL EVP backend, or NULL when built without OPENLOCKR_WITH_OPENSSL.
+ */
+const aes_backend *aes_backend_openssl(void);
+
+#endif // OPENLOCKR_AES_IMPL_H
@@ -0,0 +1,166 @@
+// native/src/crypto/aes_openssl.c
+// AES backend on OpenSSL's EVP interface (libcrypto).
+//
+// Compiled in only with -DOPENLOCKR_WITH_OPENSSL (see CMakeLists.txt).
+// EVP contexts are not safe to share between threads, so the keyed context
+// holds read-only template contexts, keyed once in ossl_key_new(); each call
+// copies one (EVP_CIPHER_CTX_copy, which keeps the expanded key) and only
+// sets the IV or nonce.
+
+#include "aes_impl.h"
+#include "utils/cpu.h"
+
+#ifdef OPENLOCKR_WITH_OPENSSL
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+
+typedef struct {
+    EVP_CIPHER_CTX *cbc_enc;   // templates: keyed, never used directly
+    EVP_CIPHER_CTX *cbc_dec;   // (CBC decryption has its own key schedule)
+    EVP_CIPHER_CTX *gcm;
+} ossl_key;
+
+static void ossl_key_free(void *ctx) {
+    if (!ctx) return;
+    ossl_key *k = ctx;
+    EVP_CIPHER_CTX_free(k->cbc_enc);   // frees wipe the key schedules
+    EVP_CIPHER_CTX_free(k->cbc_dec);
+    EVP_CIPHER_CTX_free(k->gcm);
+    free(k);
+}
+
+static void *ossl_key_new(const aes_backend *self, const uint8_t *key) {
+    (void)self;
+    ossl_key *k = calloc(1, sizeof(*k));
+    if (!k) return NULL;
+    k->cbc_enc = EVP_CIPHER_CTX_new();
+    k->cbc_dec = EVP_CIPHER_CTX_new();
+    k->gcm = EVP_CIPHER_CTX_new();
+    if (!k->cbc_enc || !k->cbc_dec || !k->gcm ||
+        EVP_CipherInit_ex(k->cbc_enc, EVP_aes_256_cbc(), NULL, key, NULL, 1) != 1 ||
+        EVP_CipherInit_ex(k->cbc_dec, EVP_aes_256_cbc(), NULL, key, NULL, 0) != 1 ||
+        EVP_CipherInit_ex(k->gcm, EVP_aes_256_gcm(), NULL, NULL, NULL, 1) != 1 ||
+        EVP_CIPHER_CTX_ctrl(k->gcm, EVP_CTRL_GCM_SET_IVLEN, AES_GCM_NONCE_LEN, NULL) != 1 ||
+        EVP_CipherInit_ex(k->gcm, NULL, NULL, key, NULL, 1) != 1) {
+        ossl_key_free(k);
+        return NULL;
+    }
+    return k;
+}
+
+// Fresh per-call context from a template, with `iv` set
+static EVP_CIPHER_CTX *ossl_ctx_from(const EVP_CIPHER_CTX *tmpl, const uint8_t *iv, int enc) {
+    EVP_CIPHER_CTX *c = EVP_CIPHER_CTX_new();
+    if (c && (EVP_CIPHER_CTX_copy(c, tmpl) != 1 ||
+              EVP_CipherInit_ex(c, NULL, NULL, NULL, iv, enc) != 1)) {
+        EVP_CIPHER_CTX_free(c);
+        c = NULL;
+    }
+    return c;
+}
+
+static int ossl_cbc(const void *ctx, const uint8_t *iv,
+                    const uint8_t *in, size_t len, uint8_t *out, int enc) {
+    if (!ctx || !iv || !in || !out || len > (size_t)INT_MAX - AES_BLOCK_LEN) {
+        return -1;
+    }
+    if (!enc && (len == 0 || len % AES_BLOCK_LEN != 0)) {
+        return -1;
+    }
+
+    const ossl_key *k = ctx;
+    EVP_CIPHER_CTX *c = ossl_ctx_from(enc ? k->cbc_enc : k->cbc_dec, iv, enc);
+    int n = 0, fin = 0, ok = 0;
+    if (c) {
+        ok = EVP_CipherUpdate(c, out, &n, in, (int)len) == 1 &&
+             EVP_CipherFinal_ex(c, out + n, &fin) == 1;
+        EVP_CIPHER_CTX_free(c);
+    }
+    return ok ? n + fin : -1;
+}
+
+static int ossl_cbc_encrypt(const void *ctx, const uint8_t *iv,
+                            const uint8_t *in, size_t len, uint8_t *out) {
+    return ossl_cbc(ctx, iv, in, len, out, 1);
+}
+
+static int ossl_cbc_decrypt(const void *ctx, const uint8_t *iv,
+                            const uint8_t *in, size_t len, uint8_t *out) {
+    return ossl_cbc(ctx, iv, in, len, out, 0);
+}
+
+static int ossl_gcm(const void *ctx, const uint8_t *nonce,
+                    const uint8_t *aad, size_t aad_len,
+                    const uint8_t *in, size_t len,
+                    uint8_t *out, uint8_t *tag, int enc) {
+    if (!ctx || !nonce || (!aad && aad_len) || !in || !out || !tag ||
+        len > (size_t)INT_MAX || aad_len > (size_t)INT_MAX) {
+        return -1;
+    }
+
+    const ossl_key *k = ctx;
+    EVP_CIPHER_CTX *c = ossl_ctx_from(k->gcm, nonce, enc);
+    int n = 0, fin = 0, ok = 0;
+    if (c) {
+        ok = (aad_len == 0 || EVP_CipherUpdate(c, NULL, &n, aad, (int)aad_len) == 1) &&
+             EVP_CipherUpdate(c, out, &n, in, (int)len) == 1 &&
+             (enc || EVP_CIPHER_CTX_ctrl(c, EVP_CTRL_GCM_SET_TAG, AES_GCM_TAG_LEN, tag) == 1) &&
+             EVP_CipherFinal_ex(c, out + n, &fin) == 1 &&
+             (!enc || EVP_CIPHER_CTX_ctrl(c, EVP_CTRL_GCM_GET_TAG, AES_GCM_TAG_LEN, tag) == 1);
+        EVP_CIPHER_CTX_free(c);
+    }
+    if (!ok) {
+        if (!enc) OPENSSL_cleanse(out, len);
+        return -1;
+    }
+    return n + fin;
+}
+
+static int ossl_gcm_seal(const void *ctx, const uint8_t *nonce,
+                         const uint8_t *aad, size_t aad_len,
+                         const uint8_t *in, size_t len,
+                         uint8_t *out, uint8_t *tag) {
+    return ossl_gcm(ctx, nonce, aad, aad_len, in, len, out, tag, 1);
+}
+
+static int ossl_gcm_open(const void *ctx, const uint8_t *nonce,
+                         const uint8_t *aad, size_t aad_len,
+                         const uint8_t *in, size_t len,
+                         const uint8_t *tag, uint8_t *out) {
+    // EVP_CTRL_GCM_SET_TAG takes a non-const pointer but only reads it
+    uint8_t expected[AES_GCM_TAG_LEN];
+    if (!tag) return -1;
+    memcpy(expected, tag, AES_GCM_TAG_LEN);
+    return ossl_gcm(ctx, nonce, aad, aad_len, in, len, out, expected, 0);
+}
+
+static aes_backend b_openssl = {
+    "openssl",
+    NULL,
+    0,
+    ossl_key_new,
+    ossl_key_free,
+    ossl_cbc_encrypt,
+    ossl_cbc_decrypt,
+    ossl_gcm_seal,
+    ossl_gcm_open,
+};
+
+// Called once, from the registry's one-time init
+const aes_backend *aes_backend_openssl(void) {
+    // libcrypto does its own CPU dispatch onto the same instructions
+    b_openssl.hardware = cpu_has(CPU_X86_AESNI) || cpu_has(CPU_ARM_AES);
+    return &b_openssl;
+}
+
+#else
+
+const aes_backend *aes_backend_openssl(void) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,651 @@
+// native/src/crypto/aes_portable.c
+// Portable constant-time AES-256 and GHASH kernels for OpenLockr.
+//
+// No lookup tables are indexed by secret data. The cipher is fully
+// bitsliced: eight blocks are transposed into bit-planes and every round
+// runs on 64-bit words, with SubBytes as the Boyar–Peralta boolean circuit.
+// GHASH uses integer multiplications with masked-out carry bits. Also hosts
+// the shared key expansion used by every kernel.
+
+#include "aes_impl.h"
+#include "utils/bytes.h"
+#include <string.h>
+
+/*=============================================================================
+  Bitsliced S-box
+=============================================================================*/
+
+/**
+ * AES S-box on eight bit-planes (q[i] holds bit i of every byte).
+ * Straight transcription of the Boyar–Peralta circuit
+ * ("A new combinational logic minimization technique with applications
+ * to cryptology", https://eprint.iacr.org/2009/191).
+ */
+static void sbox_planes(uint64_t *q) {
+    uint64_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint64_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint64_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint64_t y20, y21;
+    uint64_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint64_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint64_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint64_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint64_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint64_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint64_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint64_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint64_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    // The circuit numbers bits from the most significant one
+    x0 = q[7]; x1 = q[6]; x2 = q[5]; x3 = q[4];
+    x4 = q[3]; x5 = q[2]; x6 = q[1]; x7 = q[0];
+
+    // Top linear transformation
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9  = x0 ^ x3;
+    y8  = x0 ^ x5;
+    t0  = x1 ^ x2;
+    y1  = t0 ^ x7;
+    y4  = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2  = y1 ^ x0;
+    y5  = y1 ^ x6;
+    y3  = y5 ^ y8;
+    t1  = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6  = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7  = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // Non-linear section
+    t2  = y12 & y15;
+    t3  = y3 & y6;
+    t4  = t3 ^ t2;
+    t5  = y4 & x7;
+    t6  = t5 ^ t2;
+    t7  = y13 & y16;
+    t8  = y5 & y1;
+    t9  = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0  = t44 & y15;
+    z1  = t37 & y6;
+    z2  = t33 & x7;
+    z3  = t43 & y16;
+    z4  = t40 & y1;
+    z5  = t29 & y7;
+    z6  = t42 & y11;
+    z7  = t45 & y17;
+    z8  = t41 & y10;
+    z9  = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // Bottom linear transformation
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0  = t59 ^ t63;
+    s6  = t56 ^ ~t62;
+    s7  = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3  = t53 ^ t66;
+    s4  = t51 ^ t66;
+    s5  = t47 ^ t65;
+    s1  = t64 ^ ~s3;
+    s2  = t55 ^ ~t67;
+
+    q[7] = s0; q[6] = s1; q[5] = s2; q[4] = s3;
+    q[3] = s4; q[2] = s5; q[1] = s6; q[0] = s7;
+}
+
+// Inverse affine transform of the S-box, on bit-planes
+static void inv_affine_planes(uint64_t *q) {
+    uint64_t q0 = ~q[0], q1 = ~q[1], q2 = q[2], q3 = q[3];
+    uint64_t q4 = q[4], q5 = ~q[5], q6 = ~q[6], q7 = q[7];
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+// InvSbox(x) = A^-1(Sbox(A^-1(x))), since Sbox = A ∘ inverse
+static void inv_sbox_planes(uint64_t *q) {
+    inv_affine_planes(q);
+    sbox_planes(q);
+    inv_affine_planes(q);
+}
+
+// Transpose an 8x8 bit matrix held one row per byte
+static uint64_t transpose8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL; x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x ^= t ^ (t << 28);
+    return x;
+}
+
+// Substitute 16 bytes through the S-box in constant time (key expansion)
+static void sub_bytes16(uint8_t *b) {
+    uint64_t lo = transpose8(load64_le(b));
+    uint64_t hi = transpose8(load64_le(b + 8));
+    uint64_t q[8];
+
+    for (int j = 0; j < 8; j++) {
+        q[j] = ((lo >> (8 * j)) & 0xFF) | ((hi >> (8 * j)) & 0xFF) << 8;
+    }
+    sbox_planes(q);
+
+    lo = hi = 0;
+    for (int j = 0; j < 8; j++) {
+        lo |= (uint64_t)(q[j] & 0xFF) << (8 * j);
+        hi |= (uint64_t)((q[j] >> 8) & 0xFF) << (8 * j);
+    }
+    store64_le(b, transpose8(lo));
+    store64_le(b + 8, transpose8(hi));
+}
+
+/*=============================================================================
+  Bitsliced rounds
+
+  Four blocks are packed into eight 64-bit words: after ortho(), q[i] holds
+  bit i of all 64 state bytes, each block's bytes interleaved so that rows
+  become 16-bit lanes and ShiftRows/MixColumns are shifts and rotations
+  (the layout of T. Pornin's BearSSL aes_ct64). Eight blocks are two such
+  groups sharing one round-key set.
+=============================================================================*/
+
+#define BS_LANES   8   // blocks per bitsliced call
+#define BS_GROUP   4   // blocks per group of eight planes
+
+#define SWAPN(cl, ch, s, x, y) do {                                    \
+        uint64_t a_ = (x), b_ = (y);                                   \
+        (x) = (a_ & (uint64_t)(cl)) | ((b_ & (uint64_t)(cl)) << (s));  \
+        (y) = ((a_ & (uint64_t)(ch)) >> (s)) | (b_ & (uint64_t)(ch));  \
+    } while (0)
+
+// Transpose between byte-interleaved words and bit-planes (an involution)
+static void ortho(uint64_t *q) {
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[0], q[1]);
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[2], q[3]);
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[4], q[5]);
+    SWAPN(0x5555555555555555ULL, 0xAAAAAAAAAAAAAAAAULL, 1, q[6], q[7]);
+
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[0], q[2]);
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[1], q[3]);
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[4], q[6]);
+    SWAPN(0x3333333333333333ULL, 0xCCCCCCCCCCCCCCCCULL, 2, q[5], q[7]);
+
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[0], q[4]);
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[1], q[5]);
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[2], q[6]);
+    SWAPN(0x0F0F0F0F0F0F0F0FULL, 0xF0F0F0F0F0F0F0F0ULL, 4, q[3], q[7]);
+}
+
+// Spread one 16-byte block over two words (q0: columns 0/2, q1: columns 1/3)
+static void interleave_in(uint64_t *q0, uint64_t *q1, const uint8_t *b) {
+    uint64_t x0 = load32_le(b), x1 = load32_le(b + 4);
+    uint64_t x2 = load32_le(b + 8), x3 = load32_le(b + 12);
+    x0 |= x0 << 16; x1 |= x1 << 16; x2 |= x2 << 16; x3 |= x3 << 16;
+    x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+    x0 |= x0 << 8; x1 |= x1 << 8; x2 |= x2 << 8; x3 |= x3 << 8;
+    x0 &= 0x00FF00FF00FF00FFULL; x1 &= 0x00FF00FF00FF00FFULL;
+    x2 &= 0x00FF00FF00FF00FFULL; x3 &= 0x00FF00FF00FF00FFULL;
+    *q0 = x0 | (x2 << 8);
+    *q1 = x1 | (x3 << 8);
+}
+
+static void interleave_out(uint8_t *b, uint64_t q0, uint64_t q1) {
+    uint64_t x0 = q0 & 0x00FF00FF00FF00FFULL, x1 = q1 & 0x00FF00FF00FF00FFULL;
+    uint64_t x2 = (q0 >> 8) & 0x00FF00FF00FF00FFULL, x3 = (q1 >> 8) & 0x00FF00FF00FF00FFULL;
+    x0 |= x0 >> 8; x1 |= x1 >> 8; x2 |= x2 >> 8; x3 |= x3 >> 8;
+    x0 &= 0x0000FFFF0000FFFFULL; x1 &= 0x0000FFFF0000FFFFULL;
+    x2 &= 0x0000FFFF0000FFFFULL; x3 &= 0x0000FFFF0000FFFFULL;
+    store32_le(b,      (uint32_t)x0 | (uint32_t)(x0 >> 16));
+    store32_le(b + 4,  (uint32_t)x1 | (uint32_t)(x1 >> 16));
+    store32_le(b + 8,  (uint32_t)x2 | (uint32_t)(x2 >> 16));
+    store32_le(b + 12, (uint32_t)x3 | (uint32_t)(x3 >> 16));
+}
+
+// Load up to eight blocks into `ngroups` groups; unused lanes are zero
+static void bs_load(uint64_t *q, const uint8_t *in, size_t nblocks, size_t ngroups) {
+    memset(q, 0, ngroups * 8 * sizeof(*q));
+    for (size_t i = 0; i < nblocks; i++) {
+        uint64_t *g = q + 8 * (i / BS_GROUP);
+        size_t j = i % BS_GROUP;
+        interleave_in(&g[j], &g[j + 4], in + 16 * i);
+    }
+    for (size_t g = 0; g < ngroups; g++) ortho(q + 8 * g);
+}
+
+static void bs_store(uint8_t *out, uint64_t *q, size_t nblocks, size_t ngroups) {
+    for (size_t g = 0; g < ngroups; g++) ortho(q + 8 * g);
+    for (size_t i = 0; i < nblocks; i++) {
+        const uint64_t *g = q + 8 * (i / BS_GROUP);
+        size_t j = i % BS_GROUP;
+        interleave_out(out + 16 * i, g[j], g[j + 4]);
+    }
+}
+
+static void add_round_key(uint64_t *q, const uint64_t *sk) {
+    for (int i = 0; i < 8; i++) q[i] ^= sk[i];
+}
+
+static void shift_rows(uint64_t *q) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFFULL)
+             | ((x & 0x00000000FFF00000ULL) >> 4)
+             | ((x & 0x00000000000F0000ULL) << 12)
+             | ((x & 0x0000FF0000000000ULL) >> 8)
+             | ((x & 0x000000FF00000000ULL) << 8)
+             | ((x & 0xF000000000000000ULL) >> 12)
+             | ((x & 0x0FFF000000000000ULL) << 4);
+    }
+}
+
+static void inv_shift_rows(uint64_t *q) {
+    for (int i = 0; i < 8; i++) {
+        uint64_t x = q[i];
+        q[i] = (x & 0x000000000000FFFFULL)
+             | ((x & 0x000000000FFF0000ULL) << 4)
+             | ((x & 0x00000000F0000000ULL) >> 12)
+             | ((x & 0x000000FF00000000ULL) << 8)
+             | ((x & 0x0000FF0000000000ULL) >> 8)
+             | ((x & 0x000F000000000000ULL) << 12)
+             | ((x & 0xFFF0000000000000ULL) >> 4);
+    }
+}
+
+// Rotate each column by two rows
+static uint64_t rotr32(uint64_t x) {
+    return (x << 32) | (x >> 32);
+}
+
+static void mix_columns(uint64_t *q) {
+    uint64_t q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    uint64_t q4 = q[4], q5 = q[5], q6 = q[6], q7 = q[7];
+    // r = the next row down in each column
+    uint64_t r0 = (q0 >> 16) | (q0 << 48), r1 = (q1 >> 16) | (q1 << 48);
+    uint64_t r2 = (q2 >> 16) | (q2 << 48), r3 = (q3 >> 16) | (q3 << 48);
+    uint64_t r4 = (q4 >> 16) | (q4 << 48), r5 = (q5 >> 16) | (q5 << 48);
+    uint64_t r6 = (q6 >> 16) | (q6 << 48), r7 = (q7 >> 16) | (q7 << 48);
+
+    q[0] = q7 ^ r7 ^ r0 ^ rotr32(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr32(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ rotr32(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr32(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr32(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ rotr32(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ rotr32(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ rotr32(q7 ^ r7);
+}
+
+// InvMixColumns = MixColumns after a0 ^= 4(a0^a2), a1 ^= 4(a1^a3), ...
+static void inv_mix_columns(uint64_t *q) {
+    uint64_t t[8], u[8];
+    for (int i = 0; i < 8; i++) t[i] = q[i] ^ rotr32(q[i]);
+    for (int n = 0; n < 2; n++) {   // multiply by x, twice
+        u[0] = t[7];        u[1] = t[0] ^ t[7]; u[2] = t[1];        u[3] = t[2] ^ t[7];
+        u[4] = t[3] ^ t[7]; u[5] = t[4];        u[6] = t[5];        u[7] = t[6];
+        memcpy(t, u, sizeof(t));
+    }
+    for (int i = 0; i < 8; i++) q[i] ^= t[i];
+    mix_columns(q);
+}
+
+static void bs_encrypt(const aes_schedule *s, uint64_t *q, size_t ngroups) {
+    for (size_t g = 0; g < ngroups; g++) {
+        uint64_t *p = q + 8 * g;
+        add_round_key(p, s->bs_rk[0]);
+        for (int r = 1; r < AES_256_ROUNDS; r++) {
+            sbox_planes(p);
+            shift_rows(p);
+            mix_columns(p);
+            add_round_key(p, s->bs_rk[r]);
+        }
+        sbox_planes(p);
+        shift_rows(p);
+        add_round_key(p, s->bs_rk[AES_256_ROUNDS]);
+    }
+}
+
+// Straight inverse cipher; the bitsliced path needs no pre-mixed keys
+static void bs_decrypt(const aes_schedule *s, uint64_t *q, size_t ngroups) {
+    for (size_t g = 0; g < ngroups; g++) {
+        uint64_t *p = q + 8 * g;
+        add_round_key(p, s->bs_rk[AES_256_ROUNDS]);
+        for (int r = AES_256_ROUNDS - 1; r > 0; r--) {
+            inv_shift_rows(p);
+            inv_sbox_planes(p);
+            add_round_key(p, s->bs_rk[r]);
+            inv_mix_columns(p);
+        }
+        inv_shift_rows(p);
+        inv_sbox_planes(p);
+        add_round_key(p, s->bs_rk[0]);
+    }
+}
+
+static size_t groups_for(size_t nblocks) {
+    return (nblocks + BS_GROUP - 1) / BS_GROUP;
+}
+
+// ECB over at most BS_LANES blocks; in and out may alias
+static void encrypt_lanes(const aes_schedule *s, const uint8_t *in, uint8_t *out,
+                          size_t nblocks) {
+    uint64_t q[16];
+    size_t ng = groups_for(nblocks);
+    bs_load(q, in, nblocks, ng);
+    bs_encrypt(s, q, ng);
+    bs_store(out, q, nblocks, ng);
+}
+
+static void decrypt_lanes(const aes_schedule *s, const uint8_t *in, uint8_t *out,
+                          size_t nblocks) {
+    uint64_t q[16];
+    size_t ng = groups_for(nblocks);
+    bs_load(q, in, nblocks, ng);
+    bs_decrypt(s, q, ng);
+    bs_store(out, q, nblocks, ng);
+}
+
+/*=============================================================================
+  Byte-oriented helpers for key expansion (state is column-major, FIPS-197)
+=============================================================================*/
+
+static uint8_t xtime(uint8_t b) {
+    return (uint8_t)((b << 1) ^ (0x1B & (uint8_t)-(b >> 7)));
+}
+
+static void mix_columns_bytes(uint8_t *s) {
+    for (int c = 0; c < 4; c++) {
+        uint8_t *a = s + 4 * c;
+        uint8_t a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3];
+        uint8_t t = a0 ^ a1 ^ a2 ^ a3;
+        a[0] = a0 ^ t ^ xtime(a0 ^ a1);
+        a[1] = a1 ^ t ^ xtime(a1 ^ a2);
+        a[2] = a2 ^ t ^ xtime(a2 ^ a3);
+        a[3] = a3 ^ t ^ xtime(a3 ^ a0);
+    }
+}
+
+static void inv_mix_columns_bytes(uint8_t *s) {
+    for (int c = 0; c < 4; c++) {
+        uint8_t *a = s + 4 * c;
+        uint8_t u = xtime(xtime(a[0] ^ a[2]));
+        uint8_t v = xtime(xtime(a[1] ^ a[3]));
+        a[0] ^= u; a[1] ^= v; a[2] ^= u; a[3] ^= v;
+    }
+    mix_columns_bytes(s);
+}
+
+/*=============================================================================
+  Key expansion (shared by all kernels)
+=============================================================================*/
+
+void aes_expand_key(aes_schedule *s, const uint8_t *key) {
+    static const uint8_t rcon[7] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40 };
+    uint8_t *w = &s->rk[0][0];   // 60 words of 4 bytes
+
+    memcpy(w, key, 32);
+    for (int i = 8; i < 4 * (AES_256_ROUNDS + 1); i++) {
+        uint8_t t[16] = {0};
+        memcpy(t, w + 4 * (i - 1), 4);
+        if (i % 8 == 0) {
+            uint8_t b0 = t[0];
+            t[0] = t[1]; t[1] = t[2]; t[2] = t[3]; t[3] = b0;
+            sub_bytes16(t);
+            t[0] ^= rcon[i / 8 - 1];
+        } else if (i % 8 == 4) {
+            sub_bytes16(t);
+        }
+        for (int j = 0; j < 4; j++) w[4 * i + j] = w[4 * (i - 8) + j] ^ t[j];
+    }
+
+    memcpy(s->drk[0], s->rk[AES_256_ROUNDS], 16);
+    for (int r = 1; r < AES_256_ROUNDS; r++) {
+        memcpy(s->drk[r], s->rk[AES_256_ROUNDS - r], 16);
+        inv_mix_columns_bytes(s->drk[r]);
+    }
+    memcpy(s->drk[AES_256_ROUNDS], s->rk[0], 16);
+
+    // Bitsliced copy for the portable kernel: each round key spread over
+    // four identical blocks, i.e. the same planes for every lane
+    for (int r = 0; r <= AES_256_ROUNDS; r++) {
+        uint8_t rep[BS_GROUP * AES_BLOCK_LEN];
+        for (int i = 0; i < BS_GROUP; i++) memcpy(rep + 16 * i, s->rk[r], 16);
+        bs_load(s->bs_rk[r], rep, BS_GROUP, 1);
+    }
+}
+
+/*=============================================================================
+  Block kernels
+=============================================================================*/
+
+static void portable_encrypt_blocks(const aes_schedule *s, const uint8_t *in,
+                                    uint8_t *out, size_t nblocks) {
+    for (; nblocks >= BS_LANES; nblocks -= BS_LANES, in += 16 * BS_LANES, out += 16 * BS_LANES)
+        encrypt_lanes(s, in, out, BS_LANES);
+    if (nblocks) encrypt_lanes(s, in, out, nblocks);
+}
+
+static void portable_decrypt_blocks(const aes_schedule *s, const uint8_t *in,
+                                    uint8_t *out, size_t nblocks) {
+    for (; nblocks >= BS_LANES; nblocks -= BS_LANES, in += 16 * BS_LANES, out += 16 * BS_LANES)
+        decrypt_lanes(s, in, out, BS_LANES);
+    if (nblocks) decrypt_lanes(s, in, out, nblocks);
+}
+
+// Serial by nature: one lane of one group per block
+static void portable_cbc_encrypt(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                                 uint8_t *out, size_t nblocks) {
+    for (size_t i = 0; i < nblocks; i++) {
+        for (int j = 0; j < 16; j++) iv[j] ^= in[16 * i + j];
+        encrypt_lanes(s, iv, iv, 1);
+        memcpy(out + 16 * i, iv, 16);
+    }
+}
+
+static void portable_cbc_decrypt(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                                 uint8_t *out, size_t nblocks) {
+    uint8_t c[16 * BS_LANES], p[16 * BS_LANES];
+    while (nblocks > 0) {
+        size_t n = nblocks < BS_LANES ? nblocks : BS_LANES;
+        memcpy(c, in, 16 * n);
+        decrypt_lanes(s, c, p, n);
+        for (int j = 0; j < 16; j++) out[j] = p[j] ^ iv[j];
+        for (size_t j = 16; j < 16 * n; j++) out[j] = p[j] ^ c[j - 16];
+        memcpy(iv, c + 16 * (n - 1), 16);
+        in += 16 * n;
+        out += 16 * n;
+        nblocks -= n;
+    }
+}
+
+static void ctr32_inc(uint8_t *ctr) {
+    for (int i = 15; i >= 12; i--)
+        if (++ctr[i] != 0) break;
+}
+
+static void portable_ctr32(const aes_schedule *s, uint8_t *ctr, const uint8_t *in,
+                           uint8_t *out, size_t nblocks) {
+    uint8_t ks[16 * BS_LANES];
+    while (nblocks > 0) {
+        size_t n = nblocks < BS_LANES ? nblocks : BS_LANES;
+        for (size_t i = 0; i < n; i++) {
+            memcpy(ks + 16 * i, ctr, 16);
+            ctr32_inc(ctr);
+        }
+        encrypt_lanes(s, ks, ks, n);
+        for (size_t j = 0; j < 16 * n; j++) out[j] = in[j] ^ ks[j];
+        in += 16 * n;
+        out += 16 * n;
+        nblocks -= n;
+    }
+}
+
+/*=============================================================================
+  GHASH (constant-time 64-bit multiply-based)
+=============================================================================*/
+
+// Carry-less 64x64 multiply, low 64 bits. Bits are split into four classes
+// spaced four apart so that integer carries never reach a kept bit.
+static uint64_t bmul64(uint64_t x, uint64_t y) {
+    uint64_t x0 = x & 0x1111111111111111ULL, y0 = y & 0x1111111111111111ULL;
+    uint64_t x1 = x & 0x2222222222222222ULL, y1 = y & 0x2222222222222222ULL;
+    uint64_t x2 = x & 0x4444444444444444ULL, y2 = y & 0x4444444444444444ULL;
+    uint64_t x3 = x & 0x8888888888888888ULL, y3 = y & 0x8888888888888888ULL;
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    return (z0 & 0x1111111111111111ULL) | (z1 & 0x2222222222222222ULL)
+         | (z2 & 0x4444444444444444ULL) | (z3 & 0x8888888888888888ULL);
+}
+
+static uint64_t rev64(uint64_t x) {
+    x = ((x & 0x5555555555555555ULL) << 1)  | ((x >> 1)  & 0x5555555555555555ULL);
+    x = ((x & 0x3333333333333333ULL) << 2)  | ((x >> 2)  & 0x3333333333333333ULL);
+    x = ((x & 0x0F0F0F0F0F0F0F0FULL) << 4)  | ((x >> 4)  & 0x0F0F0F0F0F0F0F0FULL);
+    x = ((x & 0x00FF00FF00FF00FFULL) << 8)  | ((x >> 8)  & 0x00FF00FF00FF00FFULL);
+    x = ((x & 0x0000FFFF0000FFFFULL) << 16) | ((x >> 16) & 0x0000FFFF0000FFFFULL);
+    return (x << 32) | (x >> 32);
+}
+
+static void portable_ghash_init(ghash_key *g, const uint8_t *h) {
+    memset(g, 0, sizeof(*g));
+    g->w[0] = load64_be(h);
+    g->w[1] = load64_be(h + 8);
+}
+
+static void portable_ghash(const ghash_key *g, uint8_t *x, const uint8_t *in, size_t nblocks) {
+    uint64_t h1 = g->w[0], h0 = g->w[1];
+    uint64_t h0r = rev64(h0), h1r = rev64(h1);
+    uint64_t h2 = h0 ^ h1, h2r = h0r ^ h1r;
+    uint64_t y1 = load64_be(x), y0 = load64_be(x + 8);
+
+    for (size_t i = 0; i < nblocks; i++, in += 16) {
+        y1 ^= load64_be(in);
+        y0 ^= load64_be(in + 8);
+
+        // Karatsuba: the low halves come from bmul64 directly, the high
+        // halves from bit-reversed operands.
+        uint64_t y0r = rev64(y0), y1r = rev64(y1);
+        uint64_t y2 = y0 ^ y1, y2r = y0r ^ y1r;
+        uint64_t z0 = bmul64(y0, h0), z1 = bmul64(y1, h1), z2 = bmul64(y2, h2);
+        uint64_t z0h = bmul64(y0r, h0r), z1h = bmul64(y1r, h1r), z2h = bmul64(y2r, h2r);
+        z2 ^= z0 ^ z1;
+        z2h ^= z0h ^ z1h;
+        z0h = rev64(z0h) >> 1;
+        z1h = rev64(z1h) >> 1;
+        z2h = rev64(z2h) >> 1;
+
+        uint64_t v0 = z0, v1 = z0h ^ z2, v2 = z1 ^ z2h, v3 = z1h;
+
+        // Bit-reflected representation: shift left once, then reduce
+        // modulo x^128 + x^7 + x^2 + x + 1.
+        v3 = (v3 << 1) | (v2 >> 63);
+        v2 = (v2 << 1) | (v1 >> 63);
+        v1 = (v1 << 1) | (v0 >> 63);
+        v0 = (v0 << 1);
+        v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+        v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+        v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+        v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+        y0 = v2;
+        y1 = v3;
+    }
+
+    store64_be(x, y1);
+    store64_be(x + 8, y0);
+}
+
+static const aes_kernels k_portable = {
+    "portable",
+    portable_encrypt_blocks,
+    portable_decrypt_blocks,
+    portable_cbc_encrypt,
+    portable_cbc_decrypt,
+    portable_ctr32,
+    portable_ghash_init,
+    portable_ghash,
+};
+
+const aes_kernels *aes_kernels_portable(void) {
+    return &k_portable;
+}
@@ -0,0 +1,228 @@
+// native/src/crypto/aes_x86.c
+// AES-256 and GHASH kernels using AES-NI and PCLMULQDQ (x86 / x86_64).
+//
+// Built with -maes -mpclmul -mssse3 (see CMakeLists.txt); only reached after
+// cpu_features() reports AES-NI, PCLMULQDQ and SSSE3.
+
+#include "aes_impl.h"
+
+#if defined(__AES__) && defined(__PCLMUL__) && defined(__SSSE3__)
+
+#include <immintrin.h>
+
+#define LOADU(p)     _mm_loadu_si128((const __m128i *)(p))
+#define STOREU(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+#define XOR(a, b)    _mm_xor_si128((a), (b))
+
+static void load_keys(__m128i *k, const uint8_t (*rk)[AES_BLOCK_LEN]) {
+    for (int r = 0; r <= AES_256_ROUNDS; r++) k[r] = LOADU(rk[r]);
+}
+
+static inline __m128i enc1(const __m128i *k, __m128i b) {
+    b = XOR(b, k[0]);
+    for (int r = 1; r < AES_256_ROUNDS; r++) b = _mm_aesenc_si128(b, k[r]);
+    return _mm_aesenclast_si128(b, k[AES_256_ROUNDS]);
+}
+
+static inline __m128i dec1(const __m128i *k, __m128i b) {
+    b = XOR(b, k[0]);
+    for (int r = 1; r < AES_256_ROUNDS; r++) b = _mm_aesdec_si128(b, k[r]);
+    return _mm_aesdeclast_si128(b, k[AES_256_ROUNDS]);
+}
+
+// Eight independent blocks in flight hide the AESENC/AESDEC latency
+static inline void enc8(const __m128i *k, __m128i *b) {
+    for (int j = 0; j < 8; j++) b[j] = XOR(b[j], k[0]);
+    for (int r = 1; r < AES_256_ROUNDS; r++)
+        for (int j = 0; j < 8; j++) b[j] = _mm_aesenc_si128(b[j], k[r]);
+    for (int j = 0; j < 8; j++) b[j] = _mm_aesenclast_si128(b[j], k[AES_256_ROUNDS]);
+}
+
+static inline void dec8(const __m128i *k, __m128i *b) {
+    for (int j = 0; j < 8; j++) b[j] = XOR(b[j], k[0]);
+    for (int r = 1; r < AES_256_ROUNDS; r++)
+        for (int j = 0; j < 8; j++) b[j] = _mm_aesdec_si128(b[j], k[r]);
+    for (int j = 0; j < 8; j++) b[j] = _mm_aesdeclast_si128(b[j], k[AES_256_ROUNDS]);
+}
+
+static void x86_encrypt_blocks(const aes_schedule *s, const uint8_t *in,
+                               uint8_t *out, size_t nblocks) {
+    __m128i k[AES_256_ROUNDS + 1], b[8];
+    load_keys(k, s->rk);
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) b[j] = LOADU(in + 16 * j);
+        enc8(k, b);
+        for (int j = 0; j < 8; j++) STOREU(out + 16 * j, b[j]);
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16)
+        STOREU(out, enc1(k, LOADU(in)));
+}
+
+static void x86_decrypt_blocks(const aes_schedule *s, const uint8_t *in,
+                               uint8_t *out, size_t nblocks) {
+    __m128i k[AES_256_ROUNDS + 1], b[8];
+    load_keys(k, s->drk);
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) b[j] = LOADU(in + 16 * j);
+        dec8(k, b);
+        for (int j = 0; j < 8; j++) STOREU(out + 16 * j, b[j]);
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16)
+        STOREU(out, dec1(k, LOADU(in)));
+}
+
+static void x86_cbc_encrypt(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                            uint8_t *out, size_t nblocks) {
+    __m128i k[AES_256_ROUNDS + 1];
+    load_keys(k, s->rk);
+    __m128i c = LOADU(iv);
+    for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+        c = enc1(k, XOR(c, LOADU(in)));
+        STOREU(out, c);
+    }
+    STOREU(iv, c);
+}
+
+static void x86_cbc_decrypt(const aes_schedule *s, uint8_t *iv, const uint8_t *in,
+                            uint8_t *out, size_t nblocks) {
+    __m128i k[AES_256_ROUNDS + 1], c[8], b[8];
+    load_keys(k, s->drk);
+    __m128i prev = LOADU(iv);
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) b[j] = c[j] = LOADU(in + 16 * j);
+        dec8(k, b);
+        STOREU(out, XOR(b[0], prev));
+        for (int j = 1; j < 8; j++) STOREU(out + 16 * j, XOR(b[j], c[j - 1]));
+        prev = c[7];
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+        __m128i ct = LOADU(in);
+        STOREU(out, XOR(dec1(k, ct), prev));
+        prev = ct;
+    }
+    STOREU(iv, prev);
+}
+
+static void x86_ctr32(const aes_schedule *s, uint8_t *ctr, const uint8_t *in,
+                      uint8_t *out, size_t nblocks) {
+    // Byte-swap only the counter word so _mm_add_epi32 gives inc32 semantics
+    const __m128i swap_ctr = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11,
+                                           15, 14, 13, 12);
+    const __m128i one = _mm_setr_epi32(0, 0, 0, 1);
+    __m128i k[AES_256_ROUNDS + 1], b[8];
+    load_keys(k, s->rk);
+    __m128i c = _mm_shuffle_epi8(LOADU(ctr), swap_ctr);
+
+    for (; nblocks >= 8; nblocks -= 8, in += 128, out += 128) {
+        for (int j = 0; j < 8; j++) {
+            b[j] = _mm_shuffle_epi8(c, swap_ctr);
+            c = _mm_add_epi32(c, one);
+        }
+        enc8(k, b);
+        for (int j = 0; j < 8; j++) STOREU(out + 16 * j, XOR(b[j], LOADU(in + 16 * j)));
+    }
+    for (; nblocks > 0; nblocks--, in += 16, out += 16) {
+        STOREU(out, XOR(enc1(k, _mm_shuffle_epi8(c, swap_ctr)), LOADU(in)));
+        c = _mm_add_epi32(c, one);
+    }
+    STOREU(ctr, _mm_shuffle_epi8(c, swap_ctr));
+}
+
+/*=============================================================================
+  GHASH with PCLMULQDQ (byte-reflected representation, Intel white paper
+  "Intel Carry-Less Multiplication Instruction and its Usage for Computing
+  the GCM Mode")
+=============================================================================*/
+
+static inline __m128i bswap128(__m128i v) {
+    return _mm_shuffle_epi8(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// Accumulate the unreduced 256-bit product a*b into (lo, hi)
+static inline void clmul_acc(__m128i a, __m128i b, __m128i *lo, __m128i *hi) {
+    __m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t1 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t2 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x11);
+    t1 = XOR(t1, t2);
+    *lo = XOR(*lo, XOR(t0, _mm_slli_si128(t1, 8)));
+    *hi = XOR(*hi, XOR(t3, _mm_srli_si128(t1, 8)));
+}
+
+// Shift the 256-bit product left by one and reduce modulo the GCM polynomial
+static inline __m128i gf_reduce(__m128i lo, __m128i hi) {
+    __m128i t7 = _mm_srli_epi32(lo, 31);
+    __m128i t8 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    __m128i t9 = _mm_srli_si128(t7, 12);
+    t8 = _mm_slli_si128(t8, 4);
+    t7 = _mm_slli_si128(t7, 4);
+    lo = _mm_or_si128(lo, t7);
+    hi = _mm_or_si128(_mm_or_si128(hi, t8), t9);
+
+    t7 = XOR(XOR(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    t8 = _mm_srli_si128(t7, 4);
+    lo = XOR(lo, _mm_slli_si128(t7, 12));
+    __m128i t2 = XOR(XOR(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    lo = XOR(lo, XOR(t2, t8));
+    return XOR(hi, lo);
+}
+
+static inline __m128i gf_mul(__m128i a, __m128i b) {
+    __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+    clmul_acc(a, b, &lo, &hi);
+    return gf_reduce(lo, hi);
+}
+
+// g->w holds H, H^2, H^3, H^4 (byte-reflected)
+static void x86_ghash_init(ghash_key *g, const uint8_t *h) {
+    __m128i p[4];
+    p[0] = bswap128(LOADU(h));
+    for (int i = 1; i < 4; i++) p[i] = gf_mul(p[i - 1], p[0]);
+    for (int i = 0; i < 4; i++) STOREU(&g->w[2 * i], p[i]);
+}
+
+static void x86_ghash(const ghash_key *g, uint8_t *x, const uint8_t *in, size_t nblocks) {
+    __m128i h1 = LOADU(&g->w[0]), h2 = LOADU(&g->w[2]);
+    __m128i h3 = LOADU(&g->w[4]), h4 = LOADU(&g->w[6]);
+    __m128i y = bswap128(LOADU(x));
+
+    // Four blocks per reduction: Y' = (Y^C0)H^4 + C1 H^3 + C2 H^2 + C3 H
+    for (; nblocks >= 4; nblocks -= 4, in += 64) {
+        __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+        clmul_acc(XOR(y, bswap128(LOADU(in))), h4, &lo, &hi);
+        clmul_acc(bswap128(LOADU(in + 16)), h3, &lo, &hi);
+        clmul_acc(bswap128(LOADU(in + 32)), h2, &lo, &hi);
+        clmul_acc(bswap128(LOADU(in + 48)), h1, &lo, &hi);
+        y = gf_reduce(lo, hi);
+    }
+    for (; nblocks > 0; nblocks--, in += 16)
+        y = gf_mul(XOR(y, bswap128(LOADU(in))), h1);
+
+    STOREU(x, bswap128(y));
+}
+
+static const aes_kernels k_x86 = {
+    "aesni",
+    x86_encrypt_blocks,
+    x86_decrypt_blocks,
+    x86_cbc_encrypt,
+    x86_cbc_decrypt,
+    x86_ctr32,
+    x86_ghash_init,
+    x86_ghash,
+};
+
+const aes_kernels *aes_kernels_x86(void) {
+    return &k_x86;
+}
+
+#else
+
+const aes_kernels *aes_kernels_x86(void) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,293 @@
+// native/src/crypto/argon2.c
+// Argon2id for OpenLockr: hashing, block indexing and the lane scheduler.
+//
+// Memory is a grid of `lanes` rows of `lane_len` blocks, each row cut into
+// four segments (slices). Segments of one slice depend only on earlier
+// slices, so every slice is one thread_pool_run() over the lanes, and the
+// pool's return is the synchronisation point between slices.
+
+#include "argon2.h"
+#include "argon2_impl.h"
+#include "blake2b.h"
+#include "utils/bytes.h"
+#include "utils/cpu.h"
+#include "utils/thread_pool.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARGON2_VERSION        0x13
+#define ARGON2_TYPE_ID        2     // Argon2id
+#define ARGON2_SYNC_POINTS    4     // slices per lane
+#define ARGON2_PREHASH_LEN    64
+#define ARGON2_ADDRESSES      ARGON2_BLOCK_WORDS   // addresses per address block
+
+static pthread_once_t        g_kernels_once = PTHREAD_ONCE_INIT;
+static const argon2_kernels *g_kernels = NULL;
+
+static void kernels_select(void) {
+    const argon2_kernels *k = NULL;
+    if (cpu_has(CPU_X86_AVX2)) {
+        k = argon2_kernels_avx2();
+    }
+    if (!k && cpu_has(CPU_X86_SSE2)) {
+        k = argon2_kernels_sse2();
+    }
+    if (!k && cpu_has(CPU_ARM_NEON)) {
+        k = argon2_kernels_neon();
+    }
+    g_kernels = k ? k : argon2_kernels_portable();
+}
+
+static const argon2_kernels *kernels(void) {
+    pthread_once(&g_kernels_once, kernels_select);
+    return g_kernels;
+}
+
+const char *argon2_implementation(void) {
+    return kernels()->name;
+}
+
+static void wipe_blocks(argon2_block *b, size_t n) {
+    secure_wipe(b, n * sizeof(*b));
+}
+
+/*=============================================================================
+  Hashing
+=============================================================================*/
+
+// BLAKE2b of LE32(len) || data, for the length-prefixed inputs of H0
+static void update_prefixed(blake2b_ctx *ctx, const uint8_t *data, size_t len) {
+    uint8_t le[4];
+    store32_le(le, (uint32_t)len);
+    blake2b_update(ctx, le, sizeof(le));
+    blake2b_update(ctx, data, len);
+}
+
+// Variable-length hash H'(in) of out_len bytes; `in` is hashed as given
+// after the LE32(out_len) prefix
+static void hash_long(uint8_t *out, size_t out_len, const uint8_t *in, size_t in_len) {
+    uint8_t le[4], v[BLAKE2B_OUT_MAX];
+    blake2b_ctx ctx;
+    store32_le(le, (uint32_t)out_len);
+
+    blake2b_init(&ctx, out_len <= BLAKE2B_OUT_MAX ? out_len : BLAKE2B_OUT_MAX);
+    blake2b_update(&ctx, le, sizeof(le));
+    blake2b_update(&ctx, in, in_len);
+    if (out_len <= BLAKE2B_OUT_MAX) {
+        blake2b_final(&ctx, out);
+        return;
+    }
+
+    // First half of V_1..V_r, then all of V_{r+1}
+    blake2b_final(&ctx, v);
+    memcpy(out, v, BLAKE2B_OUT_MAX / 2);
+    out += BLAKE2B_OUT_MAX / 2;
+    out_len -= BLAKE2B_OUT_MAX / 2;
+    while (out_len > BLAKE2B_OUT_MAX) {
+        blake2b(v, sizeof(v), v, sizeof(v));
+        memcpy(out, v, BLAKE2B_OUT_MAX / 2);
+        out += BLAKE2B_OUT_MAX / 2;
+        out_len -= BLAKE2B_OUT_MAX / 2;
+    }
+    blake2b(v, sizeof(v), out, out_len);
+    secure_wipe(v, sizeof(v));
+}
+
+/*=============================================================================
+  Memory filling
+=============================================================================*/
+
+typedef struct {
+    const argon2_kernels *kernels;
+    argon2_block         *memory;
+    uint32_t              passes;
+    uint32_t              lanes;
+    uint32_t              lane_len;
+    uint32_t              segment_len;
+    uint32_t              memory_blocks;
+
+    // Slice being filled by the current thread_pool_run()
+    uint32_t              pass;
+    uint32_t              slice;
+} argon2_instance;
+
+// Next block of data-independent addresses (Argon2i indexing)
+static void next_addresses(const argon2_kernels *k, argon2_block *address,
+                           argon2_block *input, const argon2_block *zero) {
+    input->v[6]++;
+    k->fill_block(zero, input, address, 0);
+    k->fill_block(zero, address, address + 1, 0);
+    *address = address[1];
+}
+
+// Position within the reference lane of the block `index` refers to
+static uint32_t index_alpha(const argon2_instance *in, uint32_t index,
+                            uint32_t pseudo_rand, int same_lane) {
+    uint32_t area;
+    if (in->pass == 0) {
+        if (in->slice == 0) {
+            area = index - 1;
+        } else if (same_lane) {
+            area = in->slice * in->segment_len + index - 1;
+        } else {
+            area = in->slice * in->segment_len - (index == 0 ? 1 : 0);
+        }
+    } else if (same_lane) {
+        area = in->lane_len - in->segment_len + index - 1;
+    } else {
+        area = in->lane_len - in->segment_len - (index == 0 ? 1 : 0);
+    }
+
+    uint64_t rel = pseudo_rand;
+    rel = rel * rel >> 32;
+    rel = area - 1 - ((uint64_t)area * rel >> 32);
+
+    uint32_t start = 0;
+    if (in->pass != 0 && in->slice != ARGON2_SYNC_POINTS - 1) {
+        start = (in->slice + 1) * in->segment_len;
+    }
+    return (uint32_t)((start + rel) % in->lane_len);
+}
+
+// Fill one segment of the current slice; `lane` is the pool item index
+static int fill_segment(void *arg, size_t lane) {
+    const argon2_instance *in = arg;
+    const argon2_kernels *k = in->kernels;
+    argon2_block *mem = in->memory;
+
+    // Argon2id: the first half of the first pass uses data-independent
+    // addresses, the rest are taken from the previous block
+    int independent = in->pass == 0 && in->slice < ARGON2_SYNC_POINTS / 2;
+    argon2_block address[2], input, zero;
+    if (independent) {
+        memset(&zero, 0, sizeof(zero));
+        memset(&input, 0, sizeof(input));
+        input.v[0] = in->pass;
+        input.v[1] = lane;
+        input.v[2] = in->slice;
+        input.v[3] = in->memory_blocks;
+        input.v[4] = in->passes;
+        input.v[5] = ARGON2_TYPE_ID;
+    }
+
+    uint32_t start = 0;
+    if (in->pass == 0 && in->slice == 0) {
+        start = 2;   // the first two blocks come from H0
+        if (independent) next_addresses(k, address, &input, &zero);
+    }
+
+    size_t cur = lane * in->lane_len + in->slice * in->segment_len + start;
+    size_t prev = cur % in->lane_len == 0 ? cur + in->lane_len - 1 : cur - 1;
+
+    for (uint32_t i = start; i < in->segment_len; i++, cur++, prev++) {
+        if (cur % in->lane_len == 1) prev = cur - 1;
+
+        uint64_t pseudo_rand;
+        if (independent) {
+            if (i % ARGON2_ADDRESSES == 0) next_addresses(k, address, &input, &zero);
+            pseudo_rand = address[0].v[i % ARGON2_ADDRESSES];
+        } else {
+            pseudo_rand = mem[prev].v[0];
+        }
+
+        uint32_t ref_lane = (uint32_t)((pseudo_rand >> 32) % in->lanes);
+        if (in->pass == 0 && in->slice == 0) ref_lane = (uint32_t)lane;
+        uint32_t ref_index = index_alpha(in, i, (uint32_t)pseudo_rand, ref_lane == lane);
+
+        k->fill_block(&mem[prev], &mem[(size_t)ref_lane * in->lane_len + ref_index],
+                      &mem[cur], in->pass != 0);
+    }
+    return 0;
+}
+
+/*=============================================================================
+  Argon2id
+=============================================================================*/
+
+int argon2id(const argon2_params *params,
+             const uint8_t *password, size_t password_len,
+             const uint8_t *salt, size_t salt_len,
+             const uint8_t *secret, size_t secret_len,
+             const uint8_t *ad, size_t ad_len,
+             uint8_t *out, size_t out_len) {
+    if (!params || params->t_cost == 0 || params->lanes == 0 ||
+        params->lanes > ARGON2_MAX_LANES ||
+        params->m_cost_kib / 8 < params->lanes ||
+        (!password && password_len) || (!secret && secret_len) || (!ad && ad_len) ||
+        !salt || salt_len < ARGON2_MIN_SALT_LEN || !out || out_len < ARGON2_MIN_OUT_LEN ||
+        password_len > UINT32_MAX || salt_len > UINT32_MAX ||
+        secret_len > UINT32_MAX || ad_len > UINT32_MAX || out_len > UINT32_MAX) {
+        return -1;
+    }
+
+    argon2_instance in;
+    in.kernels = kernels();
+    in.passes = params->t_cost;
+    in.lanes = params->lanes;
+    in.segment_len = params->m_cost_kib / (ARGON2_SYNC_POINTS * params->lanes);
+    in.lane_len = in.segment_len * ARGON2_SYNC_POINTS;
+    in.memory_blocks = in.lane_len * in.lanes;
+
+    size_t mem_len = (size_t)in.memory_blocks * sizeof(argon2_block);
+    void *mem = NULL;
+    if (mem_len / sizeof(argon2_block) != in.memory_blocks ||
+        posix_memalign(&mem, 64, mem_len) != 0) {
+        return -1;
+    }
+    in.memory = mem;
+
+    // H0 over the parameters and inputs
+    uint8_t h0[ARGON2_PREHASH_LEN + 8], le[4];
+    blake2b_ctx ctx;
+    blake2b_init(&ctx, ARGON2_PREHASH_LEN);
+    const uint32_t header[6] = {
+        in.lanes, (uint32_t)out_len, params->m_cost_kib, in.passes, ARGON2_VERSION, ARGON2_TYPE_ID,
+    };
+    for (int i = 0; i < 6; i++) {
+        store32_le(le, header[i]);
+        blake2b_update(&ctx, le, sizeof(le));
+    }
+    update_prefixed(&ctx, password, password_len);
+    update_prefixed(&ctx, salt, salt_len);
+    update_prefixed(&ctx, secret, secret_len);
+    update_prefixed(&ctx, ad, ad_len);
+    blake2b_final(&ctx, h0);
+
+    // B[l][0] = H'(H0 || LE32(0) || LE32(l)), B[l][1] likewise with 1
+    uint8_t bytes[ARGON2_BLOCK_LEN];
+    for (uint32_t l = 0; l < in.lanes; l++) {
+        for (uint32_t j = 0; j < 2; j++) {
+            store32_le(h0 + ARGON2_PREHASH_LEN, j);
+            store32_le(h0 + ARGON2_PREHASH_LEN + 4, l);
+            hash_long(bytes, sizeof(bytes), h0, sizeof(h0));
+            argon2_block *b = &in.memory[(size_t)l * in.lane_len + j];
+            for (int w = 0; w < ARGON2_BLOCK_WORDS; w++) b->v[w] = load64_le(bytes + 8 * w);
+        }
+    }
+    secure_wipe(h0, sizeof(h0));
+
+    int rc = 0;
+    for (in.pass = 0; in.pass < in.passes && rc == 0; in.pass++) {
+        for (in.slice = 0; in.slice < ARGON2_SYNC_POINTS && rc == 0; in.slice++) {
+            rc = thread_pool_run(in.lanes, fill_segment, &in);
+        }
+    }
+
+    if (rc == 0) {
+        // Tag = H'(XOR of the last block of every lane)
+        argon2_block *last = &in.memory[in.lane_len - 1];
+        for (uint32_t l = 1; l < in.lanes; l++) {
+            const argon2_block *b = &in.memory[(size_t)l * in.lane_len + in.lane_len - 1];
+            for (int w = 0; w < ARGON2_BLOCK_WORDS; w++) last->v[w] ^= b->v[w];
+        }
+        for (int w = 0; w < ARGON2_BLOCK_WORDS; w++) store64_le(bytes + 8 * w, last->v[w]);
+        hash_long(out, out_len, bytes, sizeof(bytes));
+    }
+
+    secure_wipe(bytes, sizeof(bytes));
+    wipe_blocks(in.memory, in.memory_blocks);
+    free(mem);
+    return rc == 0 ? 0 : -1;
+}
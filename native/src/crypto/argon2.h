@@ -0,0 +1,66 @@
+// native/src/crypto/argon2.h
+// Argon2id (RFC 9106, version 0x13) password hashing for OpenLockr.
+//
+// Memory-hard key derivation: every pass fills `m_cost_kib` KiB, split into
+// `lanes` independent lanes that are computed in parallel on the thread
+// pool (utils/thread_pool.h). Block compression runs on AVX2, SSE2 or NEON,
+// picked once by runtime CPU detection, with a portable fallback.
+//
+// Functions returning int return 0 on success, or -1 on error.
+
+#ifndef OPENLOCKR_ARGON2_H
+#define OPENLOCKR_ARGON2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARGON2_MAX_LANES     0xFFFFFF   ///< RFC 9106 upper bound on parallelism
+#define ARGON2_MIN_SALT_LEN  8          ///< shortest salt RFC 9106 allows
+#define ARGON2_MIN_OUT_LEN   4          ///< shortest tag RFC 9106 allows
+
+/** Cost parameters. */
+typedef struct {
+    uint32_t t_cost;       ///< passes over memory, at least 1
+    uint32_t m_cost_kib;   ///< memory in KiB, at least 8 * lanes
+    uint32_t lanes;        ///< degree of parallelism, 1..ARGON2_MAX_LANES
+} argon2_params;
+
+/**
+ * Argon2id tag of a password.
+ *
+ * @param params        Cost parameters. Memory is rounded down to a
+ *                      multiple of 4 * lanes KiB, as RFC 9106 specifies.
+ * @param password      Password bytes (may be NULL if password_len is 0).
+ * @param password_len  Length in bytes of the password.
+ * @param salt          Salt of at least ARGON2_MIN_SALT_LEN bytes.
+ * @param salt_len      Length in bytes of the salt.
+ * @param secret        Optional secret value K (NULL if secret_len is 0).
+ * @param secret_len    Length in bytes of the secret.
+ * @param ad            Optional associated data X (NULL if ad_len is 0).
+ * @param ad_len        Length in bytes of the associated data.
+ * @param out           Receives the tag.
+ * @param out_len       Tag length, at least ARGON2_MIN_OUT_LEN bytes.
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int argon2id(const argon2_params *params,
+             const uint8_t *password, size_t password_len,
+             const uint8_t *salt, size_t salt_len,
+             const uint8_t *secret, size_t secret_len,
+             const uint8_t *ad, size_t ad_len,
+             uint8_t *out, size_t out_len);
+
+/**
+ * Name of the block compression kernel selected for this CPU
+ * ("avx2", "sse2", "neon" or "portable"). Triggers CPU detection on first call.
+ */
+const char *argon2_implementation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_ARGON2_H
@@ -0,0 +1,104 @@
+// native/src/crypto/argon2_avx2.c
+// Argon2 block compression kernel using AVX2 (x86_64).
+//
+// A row of the permutation is four registers of four words and runs all
+// four quarter-rounds at once, with lane rotations for the diagonals. A
+// column's word pairs are 128 bytes apart, so each column register is
+// assembled from two 128-bit halves. Built with -mavx2 (see
+// CMakeLists.txt); only reached after cpu_features() reports AVX2.
+
+#include "argon2_impl.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#define REGS (ARGON2_BLOCK_LEN / 32)
+
+#define XOR(a, b)   _mm256_xor_si256((a), (b))
+#define ROTR(x, n)  XOR(_mm256_srli_epi64((x), (n)), _mm256_slli_epi64((x), 64 - (n)))
+#define ROTR32(x)   _mm256_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define ROTR63(x)   XOR(_mm256_srli_epi64((x), 63), _mm256_add_epi64((x), (x)))
+
+// x + y + 2 * lo32(x) * lo32(y), per 64-bit lane
+static inline __m256i fblamka(__m256i x, __m256i y) {
+    __m256i xy = _mm256_mul_epu32(x, y);
+    return _mm256_add_epi64(_mm256_add_epi64(x, y), _mm256_add_epi64(xy, xy));
+}
+
+#define G(a, b, c, d) do {                                             \
+    a = fblamka(a, b); d = ROTR32(XOR(d, a));                          \
+    c = fblamka(c, d); b = ROTR(XOR(b, c), 24);                        \
+    a = fblamka(a, b); d = ROTR(XOR(d, a), 16);                        \
+    c = fblamka(c, d); b = ROTR63(XOR(b, c));                          \
+} while (0)
+
+// P over 16 words held as four registers of four
+#define ROUND(a, b, c, d) do {                                         \
+    G(a, b, c, d);                                                     \
+    b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));          \
+    c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));          \
+    d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));          \
+    G(a, b, c, d);                                                     \
+    b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));          \
+    c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));          \
+    d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));          \
+} while (0)
+
+// Two 128-bit halves to one register and back
+#define JOIN(lo, hi)  _mm256_inserti128_si256(_mm256_castsi128_si256(lo), (hi), 1)
+#define SPLIT(x, lo, hi) do {                                          \
+    (lo) = _mm256_castsi256_si128(x);                                  \
+    (hi) = _mm256_extracti128_si256((x), 1);                           \
+} while (0)
+
+static void avx2_fill_block(const argon2_block *prev, const argon2_block *ref,
+                            argon2_block *next, int with_xor) {
+    const __m256i *p = (const __m256i *)prev->v;
+    const __m256i *q = (const __m256i *)ref->v;
+    __m256i *out = (__m256i *)next->v;
+    __m256i s[REGS], z[REGS];
+
+    for (int i = 0; i < REGS; i++) {
+        s[i] = XOR(_mm256_loadu_si256(p + i), _mm256_loadu_si256(q + i));
+        z[i] = with_xor ? XOR(s[i], _mm256_loadu_si256(out + i)) : s[i];
+    }
+
+    for (int i = 0; i < 8; i++) {
+        __m256i *r = s + 4 * i;
+        ROUND(r[0], r[1], r[2], r[3]);
+    }
+
+    // Half k holds words 2k, 2k + 1; column i is halves i, i + 8, ..., i + 56
+    __m128i *h = (__m128i *)s;
+    for (int i = 0; i < 8; i++) {
+        __m256i a = JOIN(h[i],      h[i + 8]);
+        __m256i b = JOIN(h[i + 16], h[i + 24]);
+        __m256i c = JOIN(h[i + 32], h[i + 40]);
+        __m256i d = JOIN(h[i + 48], h[i + 56]);
+        ROUND(a, b, c, d);
+        SPLIT(a, h[i],      h[i + 8]);
+        SPLIT(b, h[i + 16], h[i + 24]);
+        SPLIT(c, h[i + 32], h[i + 40]);
+        SPLIT(d, h[i + 48], h[i + 56]);
+    }
+
+    for (int i = 0; i < REGS; i++) _mm256_storeu_si256(out + i, XOR(z[i], s[i]));
+}
+
+static const argon2_kernels k_avx2 = {
+    "avx2",
+    avx2_fill_block,
+};
+
+const argon2_kernels *argon2_kernels_avx2(void) {
+    return &k_avx2;
+}
+
+#else
+
+const argon2_kernels *argon2_kernels_avx2(void) {
+    return NULL;
+}
+
+#endif
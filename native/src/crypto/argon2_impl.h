@@ -0,0 +1,42 @@
+// native/src/crypto/argon2_impl.h
+// Internal Argon2 kernel interface shared by argon2.c and the per-ISA
+// block compression kernels. Not part of the public API.
+//
+// A block is 128 little-endian 64-bit words. The compression G(X, Y)
+// applies the BLAKE2b-based permutation P (with the BlaMka multiply-add)
+// to the eight 16-word rows of R = X ^ Y, then to the eight columns of
+// 2-word pairs, and returns the result XORed with R. Indexing, threading
+// and hashing are handled in portable code.
+
+#ifndef OPENLOCKR_ARGON2_IMPL_H
+#define OPENLOCKR_ARGON2_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARGON2_BLOCK_LEN     1024
+#define ARGON2_BLOCK_WORDS   (ARGON2_BLOCK_LEN / 8)
+
+typedef struct {
+    uint64_t v[ARGON2_BLOCK_WORDS];
+} argon2_block;
+
+typedef struct {
+    const char *name;
+
+    // next = G(prev, ref), or next ^= G(prev, ref) when `with_xor` (passes
+    // after the first). next may not alias prev or ref.
+    void (*fill_block)(const argon2_block *prev, const argon2_block *ref,
+                       argon2_block *next, int with_xor);
+} argon2_kernels;
+
+/**
+ * Kernel tables. The vector getters return NULL when the kernel was not
+ * compiled for this ABI; callers must still check CPU features before use.
+ */
+const argon2_kernels *argon2_kernels_portable(void);
+const argon2_kernels *argon2_kernels_sse2(void);
+const argon2_kernels *argon2_kernels_avx2(void);
+const argon2_kernels *argon2_kernels_neon(void);
+
+#endif // OPENLOCKR_ARGON2_IMPL_H
@@ -0,0 +1,98 @@
+// native/src/crypto/argon2_neon.c
+// Argon2 block compression kernel using NEON / Advanced SIMD
+// (armeabi-v7a and arm64).
+//
+// Same layout as the SSE2 kernel: 64 registers of two words, rows are
+// registers 8i..8i+7 and columns registers i, i+8, ..., i+56. Built with
+// -mfpu=neon on 32-bit ARM (see CMakeLists.txt); only reached after
+// cpu_features() reports NEON.
+
+#include "argon2_impl.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+#define REGS (ARGON2_BLOCK_LEN / 16)
+
+#define XOR(a, b)   veorq_u64((a), (b))
+#define ROTR(x, n)  vsriq_n_u64(vshlq_n_u64((x), 64 - (n)), (x), (n))
+#define ROTR32(x)   vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(x)))
+
+// x + y + 2 * lo32(x) * lo32(y), per 64-bit lane
+static inline uint64x2_t fblamka(uint64x2_t x, uint64x2_t y) {
+    uint64x2_t xy = vmull_u32(vmovn_u64(x), vmovn_u64(y));
+    return vaddq_u64(vaddq_u64(x, y), vaddq_u64(xy, xy));
+}
+
+#define G(a0, b0, c0, d0, a1, b1, c1, d1) do {                         \
+    a0 = fblamka(a0, b0);       a1 = fblamka(a1, b1);                  \
+    d0 = ROTR32(XOR(d0, a0));   d1 = ROTR32(XOR(d1, a1));              \
+    c0 = fblamka(c0, d0);       c1 = fblamka(c1, d1);                  \
+    b0 = ROTR(XOR(b0, c0), 24); b1 = ROTR(XOR(b1, c1), 24);            \
+    a0 = fblamka(a0, b0);       a1 = fblamka(a1, b1);                  \
+    d0 = ROTR(XOR(d0, a0), 16); d1 = ROTR(XOR(d1, a1), 16);            \
+    c0 = fblamka(c0, d0);       c1 = fblamka(c1, d1);                  \
+    b0 = ROTR(XOR(b0, c0), 63); b1 = ROTR(XOR(b1, c1), 63);            \
+} while (0)
+
+// Move words so the diagonal quarter-rounds line up as columns, and back
+#define DIAGONALIZE(b0, b1, c0, c1, d0, d1) do {                       \
+    uint64x2_t t0_ = b0, t1_ = c0, t2_ = d0;                           \
+    b0 = vextq_u64(t0_, b1, 1);  b1 = vextq_u64(b1, t0_, 1);           \
+    c0 = c1;                     c1 = t1_;                             \
+    d0 = vextq_u64(d1, t2_, 1);  d1 = vextq_u64(t2_, d1, 1);           \
+} while (0)
+
+#define UNDIAGONALIZE(b0, b1, c0, c1, d0, d1) do {                     \
+    uint64x2_t t0_ = b0, t1_ = c0, t2_ = d0;                           \
+    b0 = vextq_u64(b1, t0_, 1);  b1 = vextq_u64(t0_, b1, 1);           \
+    c0 = c1;                     c1 = t1_;                             \
+    d0 = vextq_u64(t2_, d1, 1);  d1 = vextq_u64(d1, t2_, 1);           \
+} while (0)
+
+// P over 16 words held as eight registers of two
+#define ROUND(x0, x1, x2, x3, x4, x5, x6, x7) do {                     \
+    G(x0, x2, x4, x6, x1, x3, x5, x7);                                 \
+    DIAGONALIZE(x2, x3, x4, x5, x6, x7);                               \
+    G(x0, x2, x4, x6, x1, x3, x5, x7);                                 \
+    UNDIAGONALIZE(x2, x3, x4, x5, x6, x7);                             \
+} while (0)
+
+static void neon_fill_block(const argon2_block *prev, const argon2_block *ref,
+                            argon2_block *next, int with_xor) {
+    uint64x2_t s[REGS], z[REGS];
+
+    for (int i = 0; i < REGS; i++) {
+        s[i] = XOR(vld1q_u64(prev->v + 2 * i), vld1q_u64(ref->v + 2 * i));
+        z[i] = with_xor ? XOR(s[i], vld1q_u64(next->v + 2 * i)) : s[i];
+    }
+
+    for (int i = 0; i < 8; i++) {
+        uint64x2_t *r = s + 8 * i;
+        ROUND(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+    }
+    for (int i = 0; i < 8; i++) {
+        uint64x2_t *c = s + i;
+        ROUND(c[0], c[8], c[16], c[24], c[32], c[40], c[48], c[56]);
+    }
+
+    for (int i = 0; i < REGS; i++) vst1q_u64(next->v + 2 * i, XOR(z[i], s[i]));
+}
+
+static const argon2_kernels k_neon = {
+    "neon",
+    neon_fill_block,
+};
+
+const argon2_kernels *argon2_kernels_neon(void) {
+    return &k_neon;
+}
+
+#else
+
+const argon2_kernels *argon2_kernels_neon(void) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,66 @@
+// native/src/crypto/argon2_portable.c
+// Portable Argon2 block compression kernel for OpenLockr.
+
+#include "argon2_impl.h"
+#include <string.h>
+
+#define ROTR64(v, n)  (((v) >> (n)) | ((v) << (64 - (n))))
+
+// BLAKE2b G with the BlaMka multiply-add: a + b + 2 * lo32(a) * lo32(b)
+static inline uint64_t fblamka(uint64_t x, uint64_t y) {
+    return x + y + 2 * (uint64_t)(uint32_t)x * (uint32_t)y;
+}
+
+#define GB(a, b, c, d) do {                             \
+    a = fblamka(a, b); d = ROTR64(d ^ a, 32);           \
+    c = fblamka(c, d); b = ROTR64(b ^ c, 24);           \
+    a = fblamka(a, b); d = ROTR64(d ^ a, 16);           \
+    c = fblamka(c, d); b = ROTR64(b ^ c, 63);           \
+} while (0)
+
+// P on 16 words at v[i[0]] .. v[i[15]]
+#define P(v, i0, i1, i2, i3, i4, i5, i6, i7, i8, i9, i10, i11, i12, i13, i14, i15) do { \
+    GB(v[i0], v[i4], v[i8],  v[i12]);                   \
+    GB(v[i1], v[i5], v[i9],  v[i13]);                   \
+    GB(v[i2], v[i6], v[i10], v[i14]);                   \
+    GB(v[i3], v[i7], v[i11], v[i15]);                   \
+    GB(v[i0], v[i5], v[i10], v[i15]);                   \
+    GB(v[i1], v[i6], v[i11], v[i12]);                   \
+    GB(v[i2], v[i7], v[i8],  v[i13]);                   \
+    GB(v[i3], v[i4], v[i9],  v[i14]);                   \
+} while (0)
+
+static void portable_fill_block(const argon2_block *prev, const argon2_block *ref,
+                                argon2_block *next, int with_xor) {
+    uint64_t r[ARGON2_BLOCK_WORDS], z[ARGON2_BLOCK_WORDS];
+
+    for (int i = 0; i < ARGON2_BLOCK_WORDS; i++) {
+        r[i] = prev->v[i] ^ ref->v[i];
+        z[i] = with_xor ? r[i] ^ next->v[i] : r[i];
+    }
+
+    // Rows: 16 consecutive words
+    for (int i = 0; i < 8; i++) {
+        int o = 16 * i;
+        P(r, o, o + 1, o + 2, o + 3, o + 4, o + 5, o + 6, o + 7,
+          o + 8, o + 9, o + 10, o + 11, o + 12, o + 13, o + 14, o + 15);
+    }
+
+    // Columns: word pair 2i, 2i + 1 of every row
+    for (int i = 0; i < 8; i++) {
+        int o = 2 * i;
+        P(r, o, o + 1, o + 16, o + 17, o + 32, o + 33, o + 48, o + 49,
+          o + 64, o + 65, o + 80, o + 81, o + 96, o + 97, o + 112, o + 113);
+    }
+
+    for (int i = 0; i < ARGON2_BLOCK_WORDS; i++) next->v[i] = z[i] ^ r[i];
+}
+
+static const argon2_kernels k_portable = {
+    "portable",
+    portable_fill_block,
+};
+
+const argon2_kernels *argon2_kernels_portable(void) {
+    return &k_portable;
+}
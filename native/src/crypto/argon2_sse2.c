@@ -0,0 +1,105 @@
+// native/src/crypto/argon2_sse2.c
+// Argon2 block compression kernel using SSE2 (x86 / x86_64).
+//
+// A block is 64 registers of two words. Row i of the permutation is
+// registers 8i..8i+7 and column i is registers i, i+8, ..., i+56, so both
+// passes run the same two-way BLAKE2b round. Built with -msse2 (see
+// CMakeLists.txt); only reached after cpu_features() reports SSE2.
+
+#include "argon2_impl.h"
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define REGS (ARGON2_BLOCK_LEN / 16)
+
+#define XOR(a, b)   _mm_xor_si128((a), (b))
+#define ROTR(x, n)  XOR(_mm_srli_epi64((x), (n)), _mm_slli_epi64((x), 64 - (n)))
+#define ROTR32(x)   _mm_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define ROTR63(x)   XOR(_mm_srli_epi64((x), 63), _mm_add_epi64((x), (x)))
+
+// x + y + 2 * lo32(x) * lo32(y), per 64-bit lane
+static inline __m128i fblamka(__m128i x, __m128i y) {
+    __m128i xy = _mm_mul_epu32(x, y);
+    return _mm_add_epi64(_mm_add_epi64(x, y), _mm_add_epi64(xy, xy));
+}
+
+#define G(a0, b0, c0, d0, a1, b1, c1, d1) do {                         \
+    a0 = fblamka(a0, b0);       a1 = fblamka(a1, b1);                  \
+    d0 = ROTR32(XOR(d0, a0));   d1 = ROTR32(XOR(d1, a1));              \
+    c0 = fblamka(c0, d0);       c1 = fblamka(c1, d1);                  \
+    b0 = ROTR(XOR(b0, c0), 24); b1 = ROTR(XOR(b1, c1), 24);            \
+    a0 = fblamka(a0, b0);       a1 = fblamka(a1, b1);                  \
+    d0 = ROTR(XOR(d0, a0), 16); d1 = ROTR(XOR(d1, a1), 16);            \
+    c0 = fblamka(c0, d0);       c1 = fblamka(c1, d1);                  \
+    b0 = ROTR63(XOR(b0, c0));   b1 = ROTR63(XOR(b1, c1));              \
+} while (0)
+
+// Move words so the diagonal quarter-rounds line up as columns, and back
+#define DIAGONALIZE(b0, b1, c0, c1, d0, d1) do {                       \
+    __m128i t0_ = d0, t1_ = b0, t2_ = c0;                              \
+    c0 = c1; c1 = t2_;                                                 \
+    d0 = _mm_unpackhi_epi64(d1, _mm_unpacklo_epi64(t0_, t0_));         \
+    d1 = _mm_unpackhi_epi64(t0_, _mm_unpacklo_epi64(d1, d1));          \
+    b0 = _mm_unpackhi_epi64(b0, _mm_unpacklo_epi64(b1, b1));           \
+    b1 = _mm_unpackhi_epi64(b1, _mm_unpacklo_epi64(t1_, t1_));         \
+} while (0)
+
+#define UNDIAGONALIZE(b0, b1, c0, c1, d0, d1) do {                     \
+    __m128i t0_ = b0, t1_ = d0, t2_ = c0;                              \
+    c0 = c1; c1 = t2_;                                                 \
+    b0 = _mm_unpackhi_epi64(b1, _mm_unpacklo_epi64(b0, b0));           \
+    b1 = _mm_unpackhi_epi64(t0_, _mm_unpacklo_epi64(b1, b1));          \
+    d0 = _mm_unpackhi_epi64(d0, _mm_unpacklo_epi64(d1, d1));           \
+    d1 = _mm_unpackhi_epi64(d1, _mm_unpacklo_epi64(t1_, t1_));         \
+} while (0)
+
+// P over 16 words held as eight registers of two
+#define ROUND(x0, x1, x2, x3, x4, x5, x6, x7) do {                     \
+    G(x0, x2, x4, x6, x1, x3, x5, x7);                                 \
+    DIAGONALIZE(x2, x3, x4, x5, x6, x7);                               \
+    G(x0, x2, x4, x6, x1, x3, x5, x7);                                 \
+    UNDIAGONALIZE(x2, x3, x4, x5, x6, x7);                             \
+} while (0)
+
+static void sse2_fill_block(const argon2_block *prev, const argon2_block *ref,
+                            argon2_block *next, int with_xor) {
+    const __m128i *p = (const __m128i *)prev->v;
+    const __m128i *q = (const __m128i *)ref->v;
+    __m128i *out = (__m128i *)next->v;
+    __m128i s[REGS], z[REGS];
+
+    for (int i = 0; i < REGS; i++) {
+        s[i] = XOR(_mm_loadu_si128(p + i), _mm_loadu_si128(q + i));
+        z[i] = with_xor ? XOR(s[i], _mm_loadu_si128(out + i)) : s[i];
+    }
+
+    for (int i = 0; i < 8; i++) {
+        __m128i *r = s + 8 * i;
+        ROUND(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]);
+    }
+    for (int i = 0; i < 8; i++) {
+        __m128i *c = s + i;
+        ROUND(c[0], c[8], c[16], c[24], c[32], c[40], c[48], c[56]);
+    }
+
+    for (int i = 0; i < REGS; i++) _mm_storeu_si128(out + i, XOR(z[i], s[i]));
+}
+
+static const argon2_kernels k_sse2 = {
+    "sse2",
+    sse2_fill_block,
+};
+
+const argon2_kernels *argon2_kernels_sse2(void) {
+    return &k_sse2;
+}
+
+#else
+
+const argon2_kernels *argon2_kernels_sse2(void) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,50 @@
+// native/src/crypto/blake2b.h
+// BLAKE2b (RFC 7693) interface for OpenLockr, unkeyed, with digests of
+// 1 to 64 bytes. Used by Argon2 for its initial hash and variable-length
+// hash H'.
+//
+// Functions returning int return 0 on success, or -1 on invalid arguments.
+
+#ifndef OPENLOCKR_BLAKE2B_H
+#define OPENLOCKR_BLAKE2B_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLAKE2B_OUT_MAX    64    ///< longest digest in bytes
+#define BLAKE2B_BLOCK_LEN  128   ///< compression block length in bytes
+
+/** Streaming BLAKE2b state. */
+typedef struct {
+    uint64_t h[8];
+    uint64_t t[2];                   ///< bytes compressed so far (128-bit)
+    uint8_t  buf[BLAKE2B_BLOCK_LEN];
+    size_t   buf_len;
+    size_t   out_len;
+} blake2b_ctx;
+
+/**
+ * Start a hash with a digest of `out_len` bytes (1..BLAKE2B_OUT_MAX).
+ */
+int blake2b_init(blake2b_ctx *ctx, size_t out_len);
+void blake2b_update(blake2b_ctx *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Write the out_len-byte digest and wipe the context.
+ */
+void blake2b_final(blake2b_ctx *ctx, uint8_t *out);
+
+/**
+ * One-shot BLAKE2b of `len` bytes into `out_len` bytes.
+ */
+int blake2b(const uint8_t *data, size_t len, uint8_t *out, size_t out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_BLAKE2B_H
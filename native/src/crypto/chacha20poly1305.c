@@ -0,0 +1,346 @@
+// native/src/crypto/chacha20poly1305.c
+// ChaCha20-Poly1305 AEAD (RFC 8439) for OpenLockr on top of the in-tree
+// ChaCha20 kernels. Poly1305 uses 26-bit limbs and 32x32->64 multiplies,
+// which suits 32-bit ARM as well as 64-bit cores.
+
+#include "chacha20poly1305.h"
+#include "chacha_impl.h"
+#include "utils/bytes.h"
+#include "utils/cpu.h"
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+
+// Bytes per pass: ChaCha20 and Poly1305 alternate over chunks this size so
+// the data is still in L1 when it is hashed.
+#define CHACHA_CHUNK_LEN  (16 * CHACHA_BLOCK_LEN)
+
+// The 32-bit block counter starts at 1 (block 0 keys Poly1305)
+#define CHACHA_MAX_MSG_LEN  ((((uint64_t)1 << 32) - 1) * CHACHA_BLOCK_LEN)
+
+static pthread_once_t        g_kernels_once = PTHREAD_ONCE_INIT;
+static const chacha_kernels *g_kernels = NULL;
+
+static void kernels_select(void) {
+    const chacha_kernels *k = NULL;
+    if (cpu_has(CPU_X86_AVX2)) {
+        k = chacha_kernels_avx2();
+    }
+    if (!k && cpu_has(CPU_X86_SSE2)) {
+        k = chacha_kernels_sse2();
+    }
+    if (!k && cpu_has(CPU_ARM_NEON)) {
+        k = chacha_kernels_neon();
+    }
+    g_kernels = k ? k : chacha_kernels_portable();
+}
+
+static const chacha_kernels *kernels(void) {
+    pthread_once(&g_kernels_once, kernels_select);
+    return g_kernels;
+}
+
+const chacha_kernels *chacha_kernels_selected(void) {
+    return kernels();
+}
+
+const char *chacha20_implementation(void) {
+    return kernels()->name;
+}
+
+/*=============================================================================
+  Poly1305
+=============================================================================*/
+
+static void poly_init(chacha20_poly1305_stream *st, const uint8_t *key) {
+    st->r[0] = load32_le(key + 0) & 0x3ffffff;
+    st->r[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+    st->r[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+    st->r[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+    st->r[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 5; i++) st->h[i] = 0;
+    for (int i = 0; i < 4; i++) st->pad[i] = load32_le(key + 16 + 4 * i);
+    st->buf_len = 0;
+}
+
+// h = (h + m) * r mod 2^130 - 5 for each 16-byte block, with the 2^128 bit set
+static void poly_blocks(chacha20_poly1305_stream *st, const uint8_t *m, size_t nblocks) {
+    const uint32_t r0 = st->r[0], r1 = st->r[1], r2 = st->r[2], r3 = st->r[3], r4 = st->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+
+    for (; nblocks > 0; nblocks--, m += 16) {
+        h0 += load32_le(m + 0) & 0x3ffffff;
+        h1 += (load32_le(m + 3) >> 2) & 0x3ffffff;
+        h2 += (load32_le(m + 6) >> 4) & 0x3ffffff;
+        h3 += (load32_le(m + 9) >> 6) & 0x3ffffff;
+        h4 += (load32_le(m + 12) >> 8) | (1u << 24);
+
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 +
+                      (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 +
+                      (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 +
+                      (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 +
+                      (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 +
+                      (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+        uint32_t c;
+        c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff; d1 += c;
+        c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff; d2 += c;
+        c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff; d3 += c;
+        c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff; d4 += c;
+        c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+        h0 += c * 5;
+        c = h0 >> 26; h0 &= 0x3ffffff; h1 += c;
+    }
+
+    st->h[0] = h0; st->h[1] = h1; st->h[2] = h2; st->h[3] = h3; st->h[4] = h4;
+}
+
+static void poly_update(chacha20_poly1305_stream *st, const uint8_t *m, size_t len) {
+    if (st->buf_len) {
+        size_t n = 16 - st->buf_len;
+        if (n > len) n = len;
+        memcpy(st->buf + st->buf_len, m, n);
+        st->buf_len += n;
+        m += n;
+        len -= n;
+        if (st->buf_len < 16) return;
+        poly_blocks(st, st->buf, 1);
+        st->buf_len = 0;
+    }
+    poly_blocks(st, m, len / 16);
+    m += len & ~(size_t)15;
+    len &= 15;
+    memcpy(st->buf, m, len);
+    st->buf_len = len;
+}
+
+// Zero-pad the pending input to a 16-byte boundary (RFC 8439 section 2.8)
+static void poly_pad16(chacha20_poly1305_stream *st) {
+    if (st->buf_len) {
+        memset(st->buf + st->buf_len, 0, 16 - st->buf_len);
+        poly_blocks(st, st->buf, 1);
+        st->buf_len = 0;
+    }
+}
+
+static void poly_finish(chacha20_poly1305_stream *st, uint8_t *mac) {
+    uint32_t h0 = st->h[0], h1 = st->h[1], h2 = st->h[2], h3 = st->h[3], h4 = st->h[4];
+    uint32_t c;
+
+    // Fully carry h
+    c = h1 >> 26; h1 &= 0x3ffffff; h2 += c;
+    c = h2 >> 26; h2 &= 0x3ffffff; h3 += c;
+    c = h3 >> 26; h3 &= 0x3ffffff; h4 += c;
+    c = h4 >> 26; h4 &= 0x3ffffff; h0 += c * 5;
+    c = h0 >> 26; h0 &= 0x3ffffff; h1 += c;
+
+    // g = h + 5 - 2^130; use g if it did not go negative (h >= p)
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1u << 26);
+
+    uint32_t mask = (g4 >> 31) - 1;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+
+    // h mod 2^128, then + pad
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+
+    uint64_t f;
+    f = (uint64_t)h0 + st->pad[0];             store32_le(mac + 0, (uint32_t)f);
+    f = (uint64_t)h1 + st->pad[1] + (f >> 32); store32_le(mac + 4, (uint32_t)f);
+    f = (uint64_t)h2 + st->pad[2] + (f >> 32); store32_le(mac + 8, (uint32_t)f);
+    f = (uint64_t)h3 + st->pad[3] + (f >> 32); store32_le(mac + 12, (uint32_t)f);
+}
+
+/*=============================================================================
+  ChaCha20 keystream
+=============================================================================*/
+
+static void chacha_xor(chacha20_poly1305_stream *st, const uint8_t *in,
+                       uint8_t *out, size_t len) {
+    // Drain the keystream left over from the previous partial block
+    while (len && st->ks_used < CHACHA_BLOCK_LEN) {
+        *out++ = *in++ ^ st->ks[st->ks_used++];
+        len--;
+    }
+
+    size_t blocks = len / CHACHA_BLOCK_LEN;
+    if (blocks) {
+        kernels()->xor_blocks(st->state, in, out, blocks);
+        st->state[12] += (uint32_t)blocks;
+        in  += blocks * CHACHA_BLOCK_LEN;
+        out += blocks * CHACHA_BLOCK_LEN;
+        len -= blocks * CHACHA_BLOCK_LEN;
+    }
+
+    if (len) {
+        chacha_block(st->state, st->ks);
+        st->state[12]++;
+        for (size_t i = 0; i < len; i++) out[i] = in[i] ^ st->ks[i];
+        st->ks_used = len;
+    }
+}
+
+/*=============================================================================
+  Streaming AEAD
+=============================================================================*/
+
+int chacha20_poly1305_stream_init(chacha20_poly1305_stream *st,
+                                  const uint8_t *key,
+                                  const uint8_t *nonce,
+                                  const uint8_t *aad, size_t aad_len,
+                                  int decrypt)
+{
+    if (!st || !key || !nonce || (!aad && aad_len)) {
+        return -1;
+    }
+
+    // "expand 32-byte k"
+    st->state[0] = 0x61707865;
+    st->state[1] = 0x3320646e;
+    st->state[2] = 0x79622d32;
+    st->state[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) st->state[4 + i] = load32_le(key + 4 * i);
+    st->state[12] = 0;
+    for (int i = 0; i < 3; i++) st->state[13 + i] = load32_le(nonce + 4 * i);
+
+    // Block 0 supplies the one-time Poly1305 key; data starts at block 1
+    uint8_t block0[CHACHA_BLOCK_LEN];
+    chacha_block(st->state, block0);
+    poly_init(st, block0);
+    secure_wipe(block0, sizeof(block0));
+    st->state[12] = 1;
+    st->ks_used = CHACHA_BLOCK_LEN;
+
+    if (aad_len) {
+        poly_update(st, aad, aad_len);
+        poly_pad16(st);
+    }
+    st->aad_len = aad_len;
+    st->msg_len = 0;
+    st->decrypt = decrypt;
+    return 0;
+}
+
+int chacha20_poly1305_stream_update(chacha20_poly1305_stream *st,
+                                    const uint8_t *in, size_t len,
+                                    uint8_t *out)
+{
+    if (!st || (len && (!in || !out)) || len > CHACHA_MAX_MSG_LEN - st->msg_len) {
+        return -1;
+    }
+
+    size_t done = len;
+    st->msg_len += len;
+
+    // Poly1305 always runs over the ciphertext: before decrypting, after encrypting
+    while (len > 0) {
+        size_t n = len < CHACHA_CHUNK_LEN ? len : CHACHA_CHUNK_LEN;
+        if (st->decrypt) poly_update(st, in, n);
+        chacha_xor(st, in, out, n);
+        if (!st->decrypt) poly_update(st, out, n);
+        in  += n;
+        out += n;
+        len -= n;
+    }
+    return done > (size_t)INT_MAX ? INT_MAX : (int)done;
+}
+
+int chacha20_poly1305_stream_final(chacha20_poly1305_stream *st, uint8_t *tag) {
+    if (!st || !tag) {
+        return -1;
+    }
+
+    uint8_t lens[16], expect[CHACHA20_POLY1305_TAG_LEN];
+    poly_pad16(st);
+    store64_le(lens, st->aad_len);
+    store64_le(lens + 8, st->msg_len);
+    poly_blocks(st, lens, 1);
+    poly_finish(st, expect);
+
+    int rc = 0;
+    if (st->decrypt) {
+        uint8_t diff = 0;
+        for (int i = 0; i < CHACHA20_POLY1305_TAG_LEN; i++) diff |= expect[i] ^ tag[i];
+        rc = diff ? -1 : 0;
+    } else {
+        memcpy(tag, expect, CHACHA20_POLY1305_TAG_LEN);
+    }
+    secure_wipe(expect, sizeof(expect));
+    secure_wipe(st, sizeof(*st));
+    return rc;
+}
+
+/*=============================================================================
+  One-shot API
+=============================================================================*/
+
+/**
+ * Encrypt and authenticate plaintext using ChaCha20-Poly1305.
+ */
+int chacha20_poly1305_encrypt(const uint8_t *key,
+                              const uint8_t *nonce,
+                              const uint8_t *aad, size_t aad_len,
+                              const uint8_t *plaintext, size_t plaintext_len,
+                              uint8_t *ciphertext,
+                              uint8_t *tag)
+{
+    if (!key || !nonce || (!aad && aad_len) || !plaintext || !ciphertext || !tag ||
+        plaintext_len > (size_t)INT_MAX) {
+        return -1;
+    }
+
+    chacha20_poly1305_stream st;
+    if (chacha20_poly1305_stream_init(&st, key, nonce, aad, aad_len, 0) != 0 ||
+        chacha20_poly1305_stream_update(&st, plaintext, plaintext_len, ciphertext) < 0 ||
+        chacha20_poly1305_stream_final(&st, tag) != 0) {
+        secure_wipe(&st, sizeof(st));
+        return -1;
+    }
+    return (int)plaintext_len;
+}
+
+/**
+ * Verify and decrypt ciphertext using ChaCha20-Poly1305.
+ * On tag mismatch the output buffer is wiped and -1 is returned.
+ */
+int chacha20_poly1305_decrypt(const uint8_t *key,
+                              const uint8_t *nonce,
+                              const uint8_t *aad, size_t aad_len,
+                              const uint8_t *ciphertext, size_t ciphertext_len,
+                              const uint8_t *tag,
+                              uint8_t *plaintext)
+{
+    if (!key || !nonce || (!aad && aad_len) || !ciphertext || !tag || !plaintext ||
+        ciphertext_len > (size_t)INT_MAX) {
+        return -1;
+    }
+
+    chacha20_poly1305_stream st;
+    uint8_t expected[CHACHA20_POLY1305_TAG_LEN];
+    memcpy(expected, tag, CHACHA20_POLY1305_TAG_LEN);
+    if (chacha20_poly1305_stream_init(&st, key, nonce, aad, aad_len, 1) != 0 ||
+        chacha20_poly1305_stream_update(&st, ciphertext, ciphertext_len, plaintext) < 0) {
+        secure_wipe(&st, sizeof(st));
+        return -1;
+    }
+    if (chacha20_poly1305_stream_final(&st, expected) != 0) {
+        secure_wipe(plaintext, ciphertext_len);
+        return -1;
+    }
+    return (int)ciphertext_len;
+}
@@ -0,0 +1,141 @@
+// native/src/crypto/chacha20poly1305.h
+// ChaCha20-Poly1305 AEAD (RFC 8439) interface for OpenLockr.
+// The second AEAD next to AES-256-GCM, for devices without AES instructions:
+// ChaCha20 needs no tables, so it is fast and constant-time everywhere.
+// ChaCha20 runs on AVX2, SSE2 or NEON when available, picked once by runtime
+// CPU detection; Poly1305 is portable.
+//
+// Functions return the number of bytes written on success, or -1 on error.
+
+#ifndef OPENLOCKR_CHACHA20POLY1305_H
+#define OPENLOCKR_CHACHA20POLY1305_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CHACHA20_POLY1305_KEY_LEN    32   ///< key length in bytes
+#define CHACHA20_POLY1305_NONCE_LEN  12   ///< nonce length in bytes
+#define CHACHA20_POLY1305_TAG_LEN    16   ///< authentication tag length in bytes
+
+/**
+ * Name of the ChaCha20 implementation selected for this CPU
+ * ("avx2", "sse2", "neon" or "portable"). Triggers CPU detection on first call.
+ */
+const char *chacha20_implementation(void);
+
+/**
+ * Encrypt and authenticate plaintext using ChaCha20-Poly1305.
+ *
+ * @param key              Pointer to a 32-byte key.
+ * @param nonce            Pointer to a 12-byte nonce; never reuse one under a key.
+ * @param aad              Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len          Length in bytes of the additional data.
+ * @param plaintext        Pointer to the input data to encrypt.
+ * @param plaintext_len    Length in bytes of the input data.
+ * @param ciphertext       Pointer to an output buffer of at least plaintext_len bytes
+ *                         (may equal plaintext).
+ * @param tag              Pointer to a 16-byte buffer to receive the tag.
+ * @return The number of bytes written to ciphertext (≥ 0), or -1 on error.
+ */
+int chacha20_poly1305_encrypt(const uint8_t *key,
+                              const uint8_t *nonce,
+                              const uint8_t *aad,
+                              size_t aad_len,
+                              const uint8_t *plaintext,
+                              size_t plaintext_len,
+                              uint8_t *ciphertext,
+                              uint8_t *tag);
+
+/**
+ * Verify and decrypt ciphertext using ChaCha20-Poly1305.
+ *
+ * @param key              Pointer to a 32-byte key.
+ * @param nonce            Pointer to the 12-byte nonce used to encrypt.
+ * @param aad              Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len          Length in bytes of the additional data.
+ * @param ciphertext       Pointer to the input data to decrypt.
+ * @param ciphertext_len   Length in bytes of the input data.
+ * @param tag              Pointer to the 16-byte tag to verify.
+ * @param plaintext        Pointer to an output buffer of at least ciphertext_len bytes
+ *                         (may equal ciphertext). Wiped if verification fails.
+ * @return The number of bytes written to plaintext (≥ 0), or -1 on error or
+ *         authentication failure.
+ */
+int chacha20_poly1305_decrypt(const uint8_t *key,
+                              const uint8_t *nonce,
+                              const uint8_t *aad,
+                              size_t aad_len,
+                              const uint8_t *ciphertext,
+                              size_t ciphertext_len,
+                              const uint8_t *tag,
+                              uint8_t *plaintext);
+
+/**
+ * Incremental ChaCha20-Poly1305 state for data that arrives in pieces.
+ *
+ * The struct is public so it can live on the caller's stack; its fields are
+ * private. Output of an init/update.../final sequence is byte-identical to
+ * the one-shot functions for the same key, nonce and AAD.
+ */
+typedef struct {
+    uint32_t state[16];    // ChaCha20 input block; state[12] is the next counter
+    uint8_t  ks[64];       // keystream of the current partial block
+    size_t   ks_used;      // bytes of ks already consumed
+    uint32_t r[5];         // Poly1305 key, 26-bit limbs
+    uint32_t h[5];         // Poly1305 accumulator
+    uint32_t pad[4];       // Poly1305 final addend
+    uint8_t  buf[16];      // ciphertext not yet hashed
+    size_t   buf_len;
+    uint64_t aad_len;
+    uint64_t msg_len;
+    int      decrypt;
+} chacha20_poly1305_stream;
+
+/**
+ * Start a streaming ChaCha20-Poly1305 operation.
+ *
+ * @param st       State to initialize.
+ * @param key      Pointer to a 32-byte key (copied into the state).
+ * @param nonce    Pointer to a 12-byte nonce.
+ * @param aad      Additional authenticated data (may be NULL if aad_len is 0).
+ * @param aad_len  Length in bytes of the additional data.
+ * @param decrypt  0 to encrypt, non-zero to decrypt.
+ * @return 0 on success, or -1 on error.
+ */
+int chacha20_poly1305_stream_init(chacha20_poly1305_stream *st,
+                                  const uint8_t *key,
+                                  const uint8_t *nonce,
+                                  const uint8_t *aad, size_t aad_len,
+                                  int decrypt);
+
+/**
+ * Process the next `len` bytes. Any length is accepted; exactly `len` bytes
+ * are written to `out` (in and out may alias).
+ *
+ * When decrypting, the output is unauthenticated until
+ * chacha20_poly1305_stream_final() succeeds and must be discarded otherwise.
+ *
+ * @return `len` (clamped to INT_MAX) on success, or -1 on error.
+ */
+int chacha20_poly1305_stream_update(chacha20_poly1305_stream *st,
+                                    const uint8_t *in, size_t len,
+                                    uint8_t *out);
+
+/**
+ * Finish the stream and wipe the state.
+ * Encrypting: writes the 16-byte tag to `tag`.
+ * Decrypting: compares `tag` against the computed one in constant time.
+ *
+ * @return 0 on success, or -1 on error or tag mismatch.
+ */
+int chacha20_poly1305_stream_final(chacha20_poly1305_stream *st, uint8_t *tag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_CHACHA20POLY1305_H
@@ -0,0 +1,115 @@
+// native/src/crypto/chacha_avx2.c
+// ChaCha20 kernel using AVX2, eight blocks per pass (x86_64).
+//
+// Same word-sliced layout as the SSE2 kernel with eight lanes per vector.
+// Built with -mavx2 (see CMakeLists.txt); only reached after cpu_features()
+// reports AVX2 with OS support for the YMM state.
+
+#include "chacha_impl.h"
+#include "utils/bytes.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+#include <string.h>
+
+#define LOADU(p)     _mm256_loadu_si256((const __m256i *)(p))
+#define STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+#define ROTL(v, n)   _mm256_or_si256(_mm256_slli_epi32((v), (n)), _mm256_srli_epi32((v), 32 - (n)))
+
+// Byte rotations are a single shuffle
+#define ROTL16(v)  _mm256_shuffle_epi8((v), _mm256_setr_epi8(              \
+    2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,                  \
+    2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13))
+#define ROTL8(v)   _mm256_shuffle_epi8((v), _mm256_setr_epi8(              \
+    3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,                  \
+    3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14))
+
+#define QUARTER_ROUND(a, b, c, d)                                             \
+    do {                                                                      \
+        a = _mm256_add_epi32(a, b); d = ROTL16(_mm256_xor_si256(d, a));       \
+        c = _mm256_add_epi32(c, d); b = ROTL(_mm256_xor_si256(b, c), 12);     \
+        a = _mm256_add_epi32(a, b); d = ROTL8(_mm256_xor_si256(d, a));        \
+        c = _mm256_add_epi32(c, d); b = ROTL(_mm256_xor_si256(b, c), 7);      \
+    } while (0)
+
+// Keystream for blocks state[12] .. state[12]+7, word-sliced
+static void core8(const uint32_t state[16], __m256i *x) {
+    __m256i s[16];
+    for (int i = 0; i < 16; i++) s[i] = x[i] = _mm256_set1_epi32((int)state[i]);
+    s[12] = x[12] = _mm256_add_epi32(s[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+    for (int i = 0; i < 10; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+    for (int i = 0; i < 16; i++) x[i] = _mm256_add_epi32(x[i], s[i]);
+}
+
+// Transpose to block order and XOR into 512 bytes. Within each 128-bit half
+// the SSE2 4x4 transpose applies; the halves hold blocks 0-3 and 4-7.
+static void xor8(const __m256i *x, const uint8_t *in, uint8_t *out) {
+    __m256i y[4][4];   // y[g][b]: words 4g..4g+3 of blocks b (low) and b+4 (high)
+    for (int g = 0; g < 4; g++) {
+        __m256i t0 = _mm256_unpacklo_epi32(x[4 * g], x[4 * g + 1]);
+        __m256i t1 = _mm256_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+        __m256i t2 = _mm256_unpackhi_epi32(x[4 * g], x[4 * g + 1]);
+        __m256i t3 = _mm256_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+        y[g][0] = _mm256_unpacklo_epi64(t0, t1);
+        y[g][1] = _mm256_unpackhi_epi64(t0, t1);
+        y[g][2] = _mm256_unpacklo_epi64(t2, t3);
+        y[g][3] = _mm256_unpackhi_epi64(t2, t3);
+    }
+    for (int b = 0; b < 4; b++) {
+        const uint8_t *lo_in = in + CHACHA_BLOCK_LEN * b, *hi_in = lo_in + 4 * CHACHA_BLOCK_LEN;
+        uint8_t *lo_out = out + CHACHA_BLOCK_LEN * b, *hi_out = lo_out + 4 * CHACHA_BLOCK_LEN;
+        STOREU(lo_out,      _mm256_xor_si256(_mm256_permute2x128_si256(y[0][b], y[1][b], 0x20), LOADU(lo_in)));
+        STOREU(lo_out + 32, _mm256_xor_si256(_mm256_permute2x128_si256(y[2][b], y[3][b], 0x20), LOADU(lo_in + 32)));
+        STOREU(hi_out,      _mm256_xor_si256(_mm256_permute2x128_si256(y[0][b], y[1][b], 0x31), LOADU(hi_in)));
+        STOREU(hi_out + 32, _mm256_xor_si256(_mm256_permute2x128_si256(y[2][b], y[3][b], 0x31), LOADU(hi_in + 32)));
+    }
+}
+
+static void avx2_xor_blocks(const uint32_t state[16], const uint8_t *in,
+                            uint8_t *out, size_t nblocks) {
+    uint32_t s[16];
+    __m256i x[16];
+    memcpy(s, state, sizeof(s));
+
+    for (; nblocks >= 8; nblocks -= 8, in += 8 * CHACHA_BLOCK_LEN, out += 8 * CHACHA_BLOCK_LEN) {
+        core8(s, x);
+        xor8(x, in, out);
+        s[12] += 8;
+    }
+    if (nblocks) {
+        uint8_t ks[8 * CHACHA_BLOCK_LEN] = {0};
+        core8(s, x);
+        xor8(x, ks, ks);
+        for (size_t i = 0; i < nblocks * CHACHA_BLOCK_LEN; i++) out[i] = in[i] ^ ks[i];
+        secure_wipe(ks, sizeof(ks));
+    }
+    _mm256_zeroupper();
+}
+
+static const chacha_kernels k_avx2 = {
+    "avx2",
+    avx2_xor_blocks,
+};
+
+const chacha_kernels *chacha_kernels_avx2(void) {
+    return &k_avx2;
+}
+
+#else
+
+const chacha_kernels *chacha_kernels_avx2(void) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,47 @@
+// native/src/crypto/chacha_impl.h
+// Internal ChaCha20 kernel interface shared by chacha20poly1305.c and the
+// per-ISA kernels. Not part of the public API.
+//
+// Kernels work on the 16-word ChaCha20 input block (constants, key, block
+// counter, nonce) and only ever produce whole 64-byte blocks; partial blocks
+// and Poly1305 are handled in portable code.
+
+#ifndef OPENLOCKR_CHACHA_IMPL_H
+#define OPENLOCKR_CHACHA_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CHACHA_BLOCK_LEN  64
+
+typedef struct {
+    const char *name;
+
+    // XOR `nblocks` keystream blocks into in -> out (in and out may alias),
+    // starting at block counter state[12]. The state is not modified; the
+    // caller advances the counter.
+    void (*xor_blocks)(const uint32_t state[16], const uint8_t *in,
+                       uint8_t *out, size_t nblocks);
+} chacha_kernels;
+
+/**
+ * Compute one keystream block for `state` (portable).
+ */
+void chacha_block(const uint32_t state[16], uint8_t out[CHACHA_BLOCK_LEN]);
+
+/**
+ * Kernel tables. The vector getters return NULL when the kernel was not
+ * compiled for this ABI; callers must still check CPU features before use.
+ */
+const chacha_kernels *chacha_kernels_portable(void);
+const chacha_kernels *chacha_kernels_sse2(void);   // 4 blocks per pass
+const chacha_kernels *chacha_kernels_avx2(void);   // 8 blocks per pass
+const chacha_kernels *chacha_kernels_neon(void);   // 4 blocks per pass
+
+/**
+ * Fastest kernel this CPU supports, chosen once per process (also used by
+ * the random generator).
+ */
+const chacha_kernels *chacha_kernels_selected(void);
+
+#endif // OPENLOCKR_CHACHA_IMPL_H
@@ -0,0 +1,107 @@
+// native/src/crypto/chacha_neon.c
+// ChaCha20 kernel using NEON / Advanced SIMD, four blocks per pass
+// (armeabi-v7a and arm64).
+//
+// Same word-sliced layout as the SSE2 kernel. Built with -mfpu=neon on
+// 32-bit ARM (see CMakeLists.txt); only reached after cpu_features()
+// reports NEON.
+
+#include "chacha_impl.h"
+#include "utils/bytes.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+#include <string.h>
+
+#define ROTL(v, n)  vsriq_n_u32(vshlq_n_u32((v), (n)), (v), 32 - (n))
+#define ROTL16(v)   vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)))
+
+#define QUARTER_ROUND(a, b, c, d)                                  \
+    do {                                                           \
+        a = vaddq_u32(a, b); d = ROTL16(veorq_u32(d, a));          \
+        c = vaddq_u32(c, d); b = ROTL(veorq_u32(b, c), 12);        \
+        a = vaddq_u32(a, b); d = ROTL(veorq_u32(d, a), 8);         \
+        c = vaddq_u32(c, d); b = ROTL(veorq_u32(b, c), 7);         \
+    } while (0)
+
+// Keystream for blocks state[12] .. state[12]+3, word-sliced
+static void core4(const uint32_t state[16], uint32x4_t *x) {
+    static const uint32_t lanes[4] = { 0, 1, 2, 3 };
+    uint32x4_t s[16];
+    for (int i = 0; i < 16; i++) s[i] = x[i] = vdupq_n_u32(state[i]);
+    s[12] = x[12] = vaddq_u32(s[12], vld1q_u32(lanes));
+
+    for (int i = 0; i < 10; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+    for (int i = 0; i < 16; i++) x[i] = vaddq_u32(x[i], s[i]);
+}
+
+static inline void xor16(uint8_t *out, const uint8_t *in, uint32x4_t v) {
+    vst1q_u8(out, veorq_u8(vreinterpretq_u8_u32(v), vld1q_u8(in)));
+}
+
+// Transpose words 4g..4g+3 of the four blocks and XOR them into 256 bytes
+static void xor4(const uint32x4_t *x, const uint8_t *in, uint8_t *out) {
+    for (int g = 0; g < 4; g++) {
+        uint32x4x2_t t01 = vtrnq_u32(x[4 * g], x[4 * g + 1]);
+        uint32x4x2_t t23 = vtrnq_u32(x[4 * g + 2], x[4 * g + 3]);
+        size_t off = 16 * g;
+        xor16(out + off, in + off,
+              vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+        off += CHACHA_BLOCK_LEN;
+        xor16(out + off, in + off,
+              vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+        off += CHACHA_BLOCK_LEN;
+        xor16(out + off, in + off,
+              vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+        off += CHACHA_BLOCK_LEN;
+        xor16(out + off, in + off,
+              vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+    }
+}
+
+static void neon_xor_blocks(const uint32_t state[16], const uint8_t *in,
+                            uint8_t *out, size_t nblocks) {
+    uint32_t s[16];
+    uint32x4_t x[16];
+    memcpy(s, state, sizeof(s));
+
+    for (; nblocks >= 4; nblocks -= 4, in += 4 * CHACHA_BLOCK_LEN, out += 4 * CHACHA_BLOCK_LEN) {
+        core4(s, x);
+        xor4(x, in, out);
+        s[12] += 4;
+    }
+    if (nblocks) {
+        uint8_t ks[4 * CHACHA_BLOCK_LEN] = {0};
+        core4(s, x);
+        xor4(x, ks, ks);
+        for (size_t i = 0; i < nblocks * CHACHA_BLOCK_LEN; i++) out[i] = in[i] ^ ks[i];
+        secure_wipe(ks, sizeof(ks));
+    }
+}
+
+static const chacha_kernels k_neon = {
+    "neon",
+    neon_xor_blocks,
+};
+
+const chacha_kernels *chacha_kernels_neon(void) {
+    return &k_neon;
+}
+
+#else
+
+const chacha_kernels *chacha_kernels_neon(void) {
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// native/src/crypto/chacha_portable.c
+// Portable ChaCha20 block function and kernel for OpenLockr.
+// ChaCha20 is add/rotate/xor only, so this is constant-time on any CPU.
+
+#include "chacha_impl.h"
+#include "utils/bytes.h"
+#include <string.h>
+
+#define ROTL32(v, n)  (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d)                     \
+    do {                                              \
+        a += b; d ^= a; d = ROTL32(d, 16);            \
+        c += d; b ^= c; b = ROTL32(b, 12);            \
+        a += b; d ^= a; d = ROTL32(d, 8);             \
+        c += d; b ^= c; b = ROTL32(b, 7);             \
+    } while (0)
+
+void chacha_block(const uint32_t state[16], uint8_t out[CHACHA_BLOCK_LEN]) {
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+
+    for (int i = 0; i < 10; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+    for (int i = 0; i < 16; i++) store32_le(out + 4 * i, x[i] + state[i]);
+
+    secure_wipe(x, sizeof(x));
+}
+
+static void portable_xor_blocks(const uint32_t state[16], const uint8_t *in,
+                                uint8_t *out, size_t nblocks) {
+    uint32_t s[16];
+    uint8_t ks[CHACHA_BLOCK_LEN];
+    memcpy(s, state, sizeof(s));
+
+    for (; nblocks > 0; nblocks--, in += CHACHA_BLOCK_LEN, out += CHACHA_BLOCK_LEN) {
+        chacha_block(s, ks);
+        for (int i = 0; i < CHACHA_BLOCK_LEN; i++) out[i] = in[i] ^ ks[i];
+        s[12]++;
+    }
+
+    secure_wipe(ks, sizeof(ks));
+}
+
+static const chacha_kernels k_portable = {
+    "portable",
+    portable_xor_blocks,
+};
+
+const chacha_kernels *chacha_kernels_portable(void) {
+    return &k_portable;
+}
@@ -0,0 +1,100 @@
+// native/src/crypto/chacha_sse2.c
+// ChaCha20 kernel using SSE2, four blocks per pass (x86 / x86_64).
+//
+// Each vector holds one state word for four consecutive blocks; the result
+// is transposed back to block order before it is XORed into the data.
+// Built with -msse2 (see CMakeLists.txt).
+
+#include "chacha_impl.h"
+#include "utils/bytes.h"
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+#include <string.h>
+
+#define LOADU(p)     _mm_loadu_si128((const __m128i *)(p))
+#define STOREU(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+#define ROTL(v, n)   _mm_or_si128(_mm_slli_epi32((v), (n)), _mm_srli_epi32((v), 32 - (n)))
+
+#define QUARTER_ROUND(a, b, c, d)                                        \
+    do {                                                                 \
+        a = _mm_add_epi32(a, b); d = ROTL(_mm_xor_si128(d, a), 16);      \
+        c = _mm_add_epi32(c, d); b = ROTL(_mm_xor_si128(b, c), 12);      \
+        a = _mm_add_epi32(a, b); d = ROTL(_mm_xor_si128(d, a), 8);       \
+        c = _mm_add_epi32(c, d); b = ROTL(_mm_xor_si128(b, c), 7);       \
+    } while (0)
+
+// Keystream for blocks state[12] .. state[12]+3, word-sliced
+static void core4(const uint32_t state[16], __m128i *x) {
+    __m128i s[16];
+    for (int i = 0; i < 16; i++) s[i] = x[i] = _mm_set1_epi32((int)state[i]);
+    s[12] = x[12] = _mm_add_epi32(s[12], _mm_setr_epi32(0, 1, 2, 3));
+
+    for (int i = 0; i < 10; i++) {
+        QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+    for (int i = 0; i < 16; i++) x[i] = _mm_add_epi32(x[i], s[i]);
+}
+
+// Transpose words 4g..4g+3 of the four blocks and XOR them into 256 bytes
+static void xor4(const __m128i *x, const uint8_t *in, uint8_t *out) {
+    for (int g = 0; g < 4; g++) {
+        __m128i t0 = _mm_unpacklo_epi32(x[4 * g], x[4 * g + 1]);
+        __m128i t1 = _mm_unpacklo_epi32(x[4 * g + 2], x[4 * g + 3]);
+        __m128i t2 = _mm_unpackhi_epi32(x[4 * g], x[4 * g + 1]);
+        __m128i t3 = _mm_unpackhi_epi32(x[4 * g + 2], x[4 * g + 3]);
+        __m128i y[4] = {
+            _mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+            _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3),
+        };
+        for (int b = 0; b < 4; b++) {
+            size_t off = (size_t)CHACHA_BLOCK_LEN * b + 16 * g;
+            STOREU(out + off, _mm_xor_si128(y[b], LOADU(in + off)));
+        }
+    }
+}
+
+static void sse2_xor_blocks(const uint32_t state[16], const uint8_t *in,
+                            uint8_t *out, size_t nblocks) {
+    uint32_t s[16];
+    __m128i x[16];
+    memcpy(s, state, sizeof(s));
+
+    for (; nblocks >= 4; nblocks -= 4, in += 4 * CHACHA_BLOCK_LEN, out += 4 * CHACHA_BLOCK_LEN) {
+        core4(s, x);
+        xor4(x, in, out);
+        s[12] += 4;
+    }
+    if (nblocks) {
+        uint8_t ks[4 * CHACHA_BLOCK_LEN] = {0};
+        core4(s, x);
+        xor4(x, ks, ks);
+        for (size_t i = 0; i < nblocks * CHACHA_BLOCK_LEN; i++) out[i] = in[i] ^ ks[i];
+        secure_wipe(ks, sizeof(ks));
+    }
+}
+
+static const chacha_kernels k_sse2 = {
+    "sse2",
+    sse2_xor_blocks,
+};
+
+const chacha_kernels *chacha_kernels_sse2(void) {
+    return &k_sse2;
+}
+
+#else
+
+const chacha_kernels *chacha_kernels_sse2(void) {
+    return NULL;
+}
+
+#endif
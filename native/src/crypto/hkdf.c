@@ -0,0 +1,64 @@
+// native/src/crypto/hkdf.c
+// HKDF-SHA256 (RFC 5869) on top of the in-tree HMAC-SHA256. Expand keys the
+// HMAC once and copies the keyed state for every output block.
+
+#include "hkdf.h"
+#include "sha256.h"
+#include "utils/bytes.h"
+#include <string.h>
+
+int hkdf_sha256_extract(const uint8_t *salt, size_t salt_len,
+                        const uint8_t *ikm, size_t ikm_len,
+                        uint8_t prk[HKDF_SHA256_PRK_LEN]) {
+    static const uint8_t zeros[SHA256_DIGEST_LEN] = {0};
+    if (!prk || (!ikm && ikm_len) || (!salt && salt_len)) return -1;
+
+    if (salt_len == 0) {
+        salt = zeros;
+        salt_len = sizeof(zeros);
+    }
+    hmac_sha256(salt, salt_len, ikm, ikm_len, prk);
+    return 0;
+}
+
+int hkdf_sha256_expand(const uint8_t *prk, size_t prk_len,
+                       const uint8_t *info, size_t info_len,
+                       uint8_t *out, size_t out_len) {
+    if (!prk || prk_len < HKDF_SHA256_PRK_LEN || (!info && info_len) ||
+        (!out && out_len) || out_len > HKDF_SHA256_MAX_OUT_LEN) {
+        return -1;
+    }
+
+    hmac_sha256_ctx keyed, ctx;
+    uint8_t t[SHA256_DIGEST_LEN];
+    hmac_sha256_init(&keyed, prk, prk_len);
+
+    // T(i) = HMAC(PRK, T(i-1) || info || i), T(0) empty
+    for (uint8_t i = 1; out_len > 0; i++) {
+        ctx = keyed;
+        if (i > 1) hmac_sha256_update(&ctx, t, sizeof(t));
+        if (info_len) hmac_sha256_update(&ctx, info, info_len);
+        hmac_sha256_update(&ctx, &i, 1);
+        hmac_sha256_final(&ctx, t);
+
+        size_t n = out_len < sizeof(t) ? out_len : sizeof(t);
+        memcpy(out, t, n);
+        out += n;
+        out_len -= n;
+    }
+
+    secure_wipe(t, sizeof(t));
+    secure_wipe(&keyed, sizeof(keyed));
+    return 0;
+}
+
+int hkdf_sha256(const uint8_t *salt, size_t salt_len,
+                const uint8_t *ikm, size_t ikm_len,
+                const uint8_t *info, size_t info_len,
+                uint8_t *out, size_t out_len) {
+    uint8_t prk[HKDF_SHA256_PRK_LEN];
+    int rc = hkdf_sha256_extract(salt, salt_len, ikm, ikm_len, prk);
+    if (rc == 0) rc = hkdf_sha256_expand(prk, sizeof(prk), info, info_len, out, out_len);
+    secure_wipe(prk, sizeof(prk));
+    return rc;
+}
@@ -0,0 +1,64 @@
+// native/src/crypto/hkdf.h
+// HKDF-SHA256 (RFC 5869) interface for OpenLockr: cheap derivation of
+// purpose-separated subkeys from key material that is already strong, such
+// as the vault data key. It is not a password KDF; use PBKDF2 for those.
+//
+// All functions return 0 on success, or -1 on error.
+
+#ifndef OPENLOCKR_HKDF_H
+#define OPENLOCKR_HKDF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HKDF_SHA256_PRK_LEN      32          ///< pseudorandom key length in bytes
+#define HKDF_SHA256_MAX_OUT_LEN  (255 * 32)  ///< longest output of one expand
+
+/**
+ * HKDF-Extract: PRK = HMAC-SHA256(salt, ikm).
+ *
+ * @param salt      Optional salt (may be NULL if salt_len is 0; RFC 5869
+ *                  then uses a block of zeros).
+ * @param salt_len  Length in bytes of the salt.
+ * @param ikm       Input keying material.
+ * @param ikm_len   Length in bytes of the input keying material.
+ * @param prk       Receives HKDF_SHA256_PRK_LEN bytes.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int hkdf_sha256_extract(const uint8_t *salt, size_t salt_len,
+                        const uint8_t *ikm, size_t ikm_len,
+                        uint8_t prk[HKDF_SHA256_PRK_LEN]);
+
+/**
+ * HKDF-Expand: `out_len` bytes of output keyed by `prk` and bound to `info`.
+ * Different `info` values give independent keys.
+ *
+ * @param prk       Pseudorandom key (at least HKDF_SHA256_PRK_LEN bytes).
+ * @param prk_len   Length in bytes of the PRK.
+ * @param info      Context / label (may be NULL if info_len is 0).
+ * @param info_len  Length in bytes of the info.
+ * @param out       Output buffer.
+ * @param out_len   Bytes to produce, at most HKDF_SHA256_MAX_OUT_LEN.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int hkdf_sha256_expand(const uint8_t *prk, size_t prk_len,
+                       const uint8_t *info, size_t info_len,
+                       uint8_t *out, size_t out_len);
+
+/**
+ * Extract then expand in one call.
+ */
+int hkdf_sha256(const uint8_t *salt, size_t salt_len,
+                const uint8_t *ikm, size_t ikm_len,
+                const uint8_t *info, size_t info_len,
+                uint8_t *out, size_t out_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_HKDF_H
@@ -0,0 +1,105 @@
+// native/src/crypto/pbkdf2.c
+// PBKDF2-HMAC-SHA256 for OpenLockr.
+//
+// HMAC keying is done once: the SHA-256 states after key ^ ipad and
+// key ^ opad are reused by every iteration, which leaves two compressions
+// per iteration instead of four. U_1 goes through the streaming HMAC (the
+// salt has any length); U_2..U_c run in the selected kernel.
+//
+// Output blocks are independent chains, so keys longer than one digest
+// (an encryption key plus a MAC key, say) run their blocks on the thread
+// pool and cost about the wall time of a single block.
+
+#include "pbkdf2.h"
+#include "pbkdf2_impl.h"
+#include "sha256.h"
+#include "utils/bytes.h"
+#include "utils/cpu.h"
+#include "utils/thread_pool.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+static pthread_once_t        g_kernels_once = PTHREAD_ONCE_INIT;
+static const pbkdf2_kernels *g_kernels = NULL;
+
+static void kernels_select(void) {
+    const pbkdf2_kernels *k = NULL;
+    if (cpu_has(CPU_X86_SHA | CPU_X86_SSE41)) {
+        k = pbkdf2_kernels_x86();
+    }
+    if (!k && cpu_has(CPU_ARM_SHA2)) {
+        k = pbkdf2_kernels_armv8();
+    }
+    g_kernels = k ? k : pbkdf2_kernels_portable();
+}
+
+static const pbkdf2_kernels *kernels(void) {
+    pthread_once(&g_kernels_once, kernels_select);
+    return g_kernels;
+}
+
+const char *pbkdf2_implementation(void) {
+    return kernels()->name;
+}
+
+// One derivation; every output block is an independent chain
+typedef struct {
+    const pbkdf2_kernels  *kernels;
+    const hmac_sha256_ctx *pads;       // pads.inner / pads.outer hold the keyed pad states
+    const uint8_t         *salt;
+    size_t                 salt_len;
+    uint32_t               iterations;
+    uint8_t               *out;
+    size_t                 out_len;
+} pbkdf2_job;
+
+// T_i for i = index + 1, into its slice of the output
+static int pbkdf2_block(void *arg, size_t index) {
+    const pbkdf2_job *job = arg;
+    hmac_sha256_ctx ctx = *job->pads;
+    uint8_t block[SHA256_DIGEST_LEN], be_index[4];
+    uint32_t u[8], t[8];
+
+    // U_1 = HMAC(P, S || INT(i))
+    store32_be(be_index, (uint32_t)index + 1);
+    if (job->salt_len) hmac_sha256_update(&ctx, job->salt, job->salt_len);
+    hmac_sha256_update(&ctx, be_index, sizeof(be_index));
+    hmac_sha256_final(&ctx, block);
+
+    for (int w = 0; w < 8; w++) t[w] = u[w] = load32_be(block + 4 * w);
+    job->kernels->iterate(job->pads->inner.h, job->pads->outer.h, u, t, job->iterations - 1);
+    for (int w = 0; w < 8; w++) store32_be(block + 4 * w, t[w]);
+
+    size_t off = index * SHA256_DIGEST_LEN;
+    size_t n = job->out_len - off < SHA256_DIGEST_LEN ? job->out_len - off : SHA256_DIGEST_LEN;
+    memcpy(job->out + off, block, n);
+
+    secure_wipe(block, sizeof(block));
+    secure_wipe(u, sizeof(u));
+    secure_wipe(t, sizeof(t));
+    return 0;
+}
+
+int pbkdf2_hmac_sha256(
+    const char *password, size_t password_len,
+    const uint8_t *salt,   size_t salt_len,
+    uint32_t iterations,
+    uint8_t *out_key,      size_t key_len
+) {
+    if ((!password && password_len) || (!salt && salt_len) || !out_key ||
+        iterations == 0 || key_len == 0 ||
+        (key_len - 1) / SHA256_DIGEST_LEN >= UINT32_MAX) {
+        return -1;
+    }
+
+    hmac_sha256_ctx pads;
+    hmac_sha256_init(&pads, (const uint8_t *)password, password_len);
+
+    pbkdf2_job job = { kernels(), &pads, salt, salt_len, iterations, out_key, key_len };
+    size_t nblocks = (key_len + SHA256_DIGEST_LEN - 1) / SHA256_DIGEST_LEN;
+    int rc = thread_pool_run(nblocks, pbkdf2_block, &job);
+
+    secure_wipe(&pads, sizeof(pads));
+    return rc == 0 ? 0 : -1;
+}
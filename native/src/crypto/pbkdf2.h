@@ -0,0 +1,53 @@
+// native/src/crypto/pbkdf2.h
+// PBKDF2-HMAC-SHA256 (RFC 8018) for OpenLockr's password-derived keys.
+//
+// The HMAC pad states are computed once per call, and every iteration runs
+// in a kernel that keeps the chaining values in registers: SHA extensions
+// on x86, the ARMv8 SHA2 instructions on arm64, portable C elsewhere,
+// picked once by runtime CPU detection.
+
+#ifndef OPENLOCKR_PBKDF2_H
+#define OPENLOCKR_PBKDF2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Derive `key_len` bytes from a password.
+ *
+ * Each 32-byte block of output is a separate iteration chain. When
+ * key_len exceeds one block, the chains run concurrently on the thread pool
+ * (utils/thread_pool.h), so a 64- or 96-byte key costs about the wall time
+ * of a 32-byte one on a multi-core device.
+ *
+ * @param password      Password bytes (may be NULL if password_len is 0).
+ * @param password_len  Length in bytes of the password.
+ * @param salt          Salt (may be NULL if salt_len is 0).
+ * @param salt_len      Length in bytes of the salt.
+ * @param iterations    Iteration count, at least 1.
+ * @param out_key       Receives the derived key.
+ * @param key_len       Bytes to derive, at least 1.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int pbkdf2_hmac_sha256(
+    const char *password, size_t password_len,
+    const uint8_t *salt,   size_t salt_len,
+    uint32_t iterations,
+    uint8_t *out_key,      size_t key_len
+);
+
+/**
+ * Name of the iteration kernel selected for this CPU
+ * ("sha-ni", "armv8" or "portable"). Triggers CPU detection on first call.
+ */
+const char *pbkdf2_implementation(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_PBKDF2_H
@@ -0,0 +1,98 @@
+// native/src/crypto/pbkdf2_armv8.c
+// PBKDF2 iteration kernel using the ARMv8 SHA2 instructions (arm64).
+//
+// Built with -march=armv8-a+crypto (see CMakeLists.txt); only reached after
+// cpu_features() reports SHA2. The round constants stay in registers for
+// the whole loop.
+
+#include "pbkdf2_impl.h"
+#include "sha256_impl.h"
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+
+#include <arm_neon.h>
+
+// Four rounds on schedule words W[4i..4i+3]
+#define QROUND(abcd, efgh, m, i) do {                       \
+    uint32x4_t wk_ = vaddq_u32((m), k[i]);                  \
+    uint32x4_t abcd_ = (abcd);                              \
+    (abcd) = vsha256hq_u32((abcd), (efgh), wk_);            \
+    (efgh) = vsha256h2q_u32((efgh), abcd_, wk_);            \
+} while (0)
+
+// Replace W[t-16..t-13] in m0 with W[t..t+3]
+#define SCHED(m0, m1, m2, m3) \
+    (m0) = vsha256su1q_u32(vsha256su0q_u32((m0), (m1)), (m2), (m3))
+
+// One block W = m0..m3 into the state (s0, s1)
+static inline void compress(const uint32x4_t *k, uint32x4_t *s0, uint32x4_t *s1,
+                            uint32x4_t m0, uint32x4_t m1, uint32x4_t m2, uint32x4_t m3) {
+    uint32x4_t a = *s0, e = *s1;
+    QROUND(a, e, m0, 0);  SCHED(m0, m1, m2, m3);
+    QROUND(a, e, m1, 1);  SCHED(m1, m2, m3, m0);
+    QROUND(a, e, m2, 2);  SCHED(m2, m3, m0, m1);
+    QROUND(a, e, m3, 3);  SCHED(m3, m0, m1, m2);
+    QROUND(a, e, m0, 4);  SCHED(m0, m1, m2, m3);
+    QROUND(a, e, m1, 5);  SCHED(m1, m2, m3, m0);
+    QROUND(a, e, m2, 6);  SCHED(m2, m3, m0, m1);
+    QROUND(a, e, m3, 7);  SCHED(m3, m0, m1, m2);
+    QROUND(a, e, m0, 8);  SCHED(m0, m1, m2, m3);
+    QROUND(a, e, m1, 9);  SCHED(m1, m2, m3, m0);
+    QROUND(a, e, m2, 10); SCHED(m2, m3, m0, m1);
+    QROUND(a, e, m3, 11); SCHED(m3, m0, m1, m2);
+    QROUND(a, e, m0, 12);
+    QROUND(a, e, m1, 13);
+    QROUND(a, e, m2, 14);
+    QROUND(a, e, m3, 15);
+    *s0 = vaddq_u32(*s0, a);
+    *s1 = vaddq_u32(*s1, e);
+}
+
+static void armv8_iterate(const uint32_t inner[8], const uint32_t outer[8],
+                          uint32_t u[8], uint32_t t[8], uint32_t iterations) {
+    // Padding of a 32-byte message after a key block: 0x80, zeros, 768 bits
+    static const uint32_t pad[8] = { 0x80000000, 0, 0, 0, 0, 0, 0, (64 + 32) * 8 };
+    const uint32x4_t pad0 = vld1q_u32(pad), pad1 = vld1q_u32(pad + 4);
+
+    uint32x4_t k[16];
+    for (int i = 0; i < 16; i++) k[i] = vld1q_u32(&sha256_k[4 * i]);
+
+    const uint32x4_t in0 = vld1q_u32(inner), in1 = vld1q_u32(inner + 4);
+    const uint32x4_t out0 = vld1q_u32(outer), out1 = vld1q_u32(outer + 4);
+    uint32x4_t u0 = vld1q_u32(u), u1 = vld1q_u32(u + 4);
+    uint32x4_t t0 = vld1q_u32(t), t1 = vld1q_u32(t + 4);
+
+    for (; iterations > 0; iterations--) {
+        uint32x4_t s0 = in0, s1 = in1;
+        compress(k, &s0, &s1, u0, u1, pad0, pad1);
+
+        u0 = out0;
+        u1 = out1;
+        compress(k, &u0, &u1, s0, s1, pad0, pad1);
+
+        t0 = veorq_u32(t0, u0);
+        t1 = veorq_u32(t1, u1);
+    }
+
+    vst1q_u32(u, u0);
+    vst1q_u32(u + 4, u1);
+    vst1q_u32(t, t0);
+    vst1q_u32(t + 4, t1);
+}
+
+static const pbkdf2_kernels k_armv8 = {
+    "armv8",
+    armv8_iterate,
+};
+
+const pbkdf2_kernels *pbkdf2_kernels_armv8(void) {
+    return &k_armv8;
+}
+
+#else
+
+const pbkdf2_kernels *pbkdf2_kernels_armv8(void) {
+    return NULL;
+}
+
+#endif
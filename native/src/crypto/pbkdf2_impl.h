@@ -0,0 +1,35 @@
+// native/src/crypto/pbkdf2_impl.h
+// Internal PBKDF2 kernel interface shared by pbkdf2.c and the per-ISA
+// kernels. Not part of the public API.
+//
+// A kernel runs the iteration loop of one output block. Each iteration is
+// HMAC-SHA256 of a 32-byte message, which is exactly two compressions of
+// one padded block: one from the inner pad state, one from the outer pad
+// state. Keeping both pad states, U and the running XOR in registers leaves
+// nothing but those two compressions per iteration.
+
+#ifndef OPENLOCKR_PBKDF2_IMPL_H
+#define OPENLOCKR_PBKDF2_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    const char *name;
+
+    // Run `iterations` rounds of u = HMAC(u), t ^= u. `inner` and `outer`
+    // are the SHA-256 states after absorbing key ^ ipad and key ^ opad; u
+    // and t are digests as host-order words.
+    void (*iterate)(const uint32_t inner[8], const uint32_t outer[8],
+                    uint32_t u[8], uint32_t t[8], uint32_t iterations);
+} pbkdf2_kernels;
+
+/**
+ * Kernel tables. The hardware getters return NULL when the kernel was not
+ * compiled for this ABI; callers must still check CPU features before use.
+ */
+const pbkdf2_kernels *pbkdf2_kernels_portable(void);
+const pbkdf2_kernels *pbkdf2_kernels_x86(void);     // SHA extensions
+const pbkdf2_kernels *pbkdf2_kernels_armv8(void);   // ARMv8 SHA2
+
+#endif // OPENLOCKR_PBKDF2_IMPL_H
@@ -0,0 +1,45 @@
+// native/src/crypto/pbkdf2_portable.c
+// Portable PBKDF2 iteration kernel for OpenLockr.
+
+#include "pbkdf2_impl.h"
+#include "sha256_impl.h"
+#include "utils/bytes.h"
+#include <string.h>
+
+// Second block of HMAC over a 32-byte message: the message, 0x80, then
+// the length of key block plus message in bits
+static void pad_block(uint32_t w[16], const uint32_t msg[8]) {
+    memcpy(w, msg, 8 * sizeof(uint32_t));
+    w[8] = 0x80000000;
+    for (int i = 9; i < 15; i++) w[i] = 0;
+    w[15] = (64 + 32) * 8;
+}
+
+static void portable_iterate(const uint32_t inner[8], const uint32_t outer[8],
+                             uint32_t u[8], uint32_t t[8], uint32_t iterations) {
+    uint32_t s[8], w[16];
+
+    for (; iterations > 0; iterations--) {
+        memcpy(s, inner, sizeof(s));
+        pad_block(w, u);
+        sha256_compress_words(s, w);
+
+        pad_block(w, s);
+        memcpy(u, outer, 8 * sizeof(uint32_t));
+        sha256_compress_words(u, w);
+
+        for (int i = 0; i < 8; i++) t[i] ^= u[i];
+    }
+
+    secure_wipe(s, sizeof(s));
+    secure_wipe(w, sizeof(w));
+}
+
+static const pbkdf2_kernels k_portable = {
+    "portable",
+    portable_iterate,
+};
+
+const pbkdf2_kernels *pbkdf2_kernels_portable(void) {
+    return &k_portable;
+}
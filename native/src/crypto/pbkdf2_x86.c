@@ -0,0 +1,119 @@
+// native/src/crypto/pbkdf2_x86.c
+// PBKDF2 iteration kernel using the x86 SHA extensions (SHA-NI).
+//
+// Built with -msse4.1 -msha (see CMakeLists.txt); only reached after
+// cpu_features() reports SHA and SSE4.1. SHA256RNDS2 keeps the working
+// variables as ABEF / CDGH, so the pad states are converted once up front
+// and each digest is turned back into message words A..H for the next
+// compression.
+
+#include "pbkdf2_impl.h"
+#include "sha256_impl.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SHA__) && defined(__SSE4_1__)
+
+#include <immintrin.h>
+
+#define LOAD(p)      _mm_loadu_si128((const __m128i *)(p))
+#define STORE(p, v)  _mm_storeu_si128((__m128i *)(p), (v))
+
+// Four rounds on schedule words W[4i..4i+3]
+#define QROUND(s0, s1, m, i) do {                                         \
+    __m128i wk_ = _mm_add_epi32((m), LOAD(&sha256_k[4 * (i)]));           \
+    (s1) = _mm_sha256rnds2_epu32((s1), (s0), wk_);                        \
+    (s0) = _mm_sha256rnds2_epu32((s0), (s1), _mm_shuffle_epi32(wk_, 0x0E)); \
+} while (0)
+
+// Replace W[t-16..t-13] in m0 with W[t..t+3]
+#define SCHED(m0, m1, m2, m3)                                             \
+    (m0) = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32((m0), (m1)), \
+                                              _mm_alignr_epi8((m3), (m2), 4)), (m3))
+
+// Words A..D and E..H to the ABEF / CDGH layout
+static inline void to_abef(__m128i abcd, __m128i efgh, __m128i *abef, __m128i *cdgh) {
+    __m128i t = _mm_shuffle_epi32(abcd, 0xB1);    // CDAB
+    efgh = _mm_shuffle_epi32(efgh, 0x1B);         // EFGH
+    *abef = _mm_alignr_epi8(t, efgh, 8);          // ABEF
+    *cdgh = _mm_blend_epi16(efgh, t, 0xF0);       // CDGH
+}
+
+static inline void from_abef(__m128i abef, __m128i cdgh, __m128i *abcd, __m128i *efgh) {
+    __m128i t = _mm_shuffle_epi32(abef, 0x1B);    // FEBA
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);         // DCHG
+    *abcd = _mm_blend_epi16(t, cdgh, 0xF0);       // DCBA
+    *efgh = _mm_alignr_epi8(cdgh, t, 8);          // HGFE
+}
+
+// One block W = m0..m3 into the state (s0, s1)
+static inline void compress(__m128i *s0, __m128i *s1,
+                            __m128i m0, __m128i m1, __m128i m2, __m128i m3) {
+    __m128i a = *s0, c = *s1;
+    QROUND(a, c, m0, 0);  SCHED(m0, m1, m2, m3);
+    QROUND(a, c, m1, 1);  SCHED(m1, m2, m3, m0);
+    QROUND(a, c, m2, 2);  SCHED(m2, m3, m0, m1);
+    QROUND(a, c, m3, 3);  SCHED(m3, m0, m1, m2);
+    QROUND(a, c, m0, 4);  SCHED(m0, m1, m2, m3);
+    QROUND(a, c, m1, 5);  SCHED(m1, m2, m3, m0);
+    QROUND(a, c, m2, 6);  SCHED(m2, m3, m0, m1);
+    QROUND(a, c, m3, 7);  SCHED(m3, m0, m1, m2);
+    QROUND(a, c, m0, 8);  SCHED(m0, m1, m2, m3);
+    QROUND(a, c, m1, 9);  SCHED(m1, m2, m3, m0);
+    QROUND(a, c, m2, 10); SCHED(m2, m3, m0, m1);
+    QROUND(a, c, m3, 11); SCHED(m3, m0, m1, m2);
+    QROUND(a, c, m0, 12);
+    QROUND(a, c, m1, 13);
+    QROUND(a, c, m2, 14);
+    QROUND(a, c, m3, 15);
+    *s0 = _mm_add_epi32(*s0, a);
+    *s1 = _mm_add_epi32(*s1, c);
+}
+
+static void x86_iterate(const uint32_t inner[8], const uint32_t outer[8],
+                        uint32_t u[8], uint32_t t[8], uint32_t iterations) {
+    // Padding of a 32-byte message after a key block: 0x80, zeros, 768 bits
+    const __m128i pad0 = _mm_set_epi32(0, 0, 0, (int)0x80000000);
+    const __m128i pad1 = _mm_set_epi32((64 + 32) * 8, 0, 0, 0);
+
+    __m128i in0, in1, out0, out1;
+    to_abef(LOAD(inner), LOAD(inner + 4), &in0, &in1);
+    to_abef(LOAD(outer), LOAD(outer + 4), &out0, &out1);
+
+    __m128i u0 = LOAD(u), u1 = LOAD(u + 4);
+    __m128i t0 = LOAD(t), t1 = LOAD(t + 4);
+
+    for (; iterations > 0; iterations--) {
+        __m128i s0 = in0, s1 = in1;
+        compress(&s0, &s1, u0, u1, pad0, pad1);
+        from_abef(s0, s1, &u0, &u1);
+
+        s0 = out0;
+        s1 = out1;
+        compress(&s0, &s1, u0, u1, pad0, pad1);
+        from_abef(s0, s1, &u0, &u1);
+
+        t0 = _mm_xor_si128(t0, u0);
+        t1 = _mm_xor_si128(t1, u1);
+    }
+
+    STORE(u, u0);
+    STORE(u + 4, u1);
+    STORE(t, t0);
+    STORE(t + 4, t1);
+}
+
+static const pbkdf2_kernels k_x86 = {
+    "sha-ni",
+    x86_iterate,
+};
+
+const pbkdf2_kernels *pbkdf2_kernels_x86(void) {
+    return &k_x86;
+}
+
+#else
+
+const pbkdf2_kernels *pbkdf2_kernels_x86(void) {
+    return NULL;
+}
+
+#endif
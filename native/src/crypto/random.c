@@ -0,0 +1,184 @@
+// native/src/crypto/random.c
+// CSPRNG for OpenLockr.
+//
+// random_bytes() serves a per-thread ChaCha20 generator so that a nonce
+// costs a memcpy rather than a syscall. Each generator is keyed from
+// getrandom(2) (/dev/urandom on pre-3.17 kernels) and uses fast key erasure:
+// every refill produces RNG_BUF_LEN bytes of keystream, the first 32 of which
+// become the next key, and bytes are wiped from the buffer as they are
+// handed out, so a later memory disclosure reveals nothing already returned.
+// Generators reseed from the kernel after fork(), after RNG_RESEED_BYTES of
+// output and after RNG_RESEED_SECS.
+
+#include "random.h"
+#include "chacha_impl.h"
+#include "utils/bytes.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#define RNG_KEY_LEN       32
+#define RNG_BUF_BLOCKS    16                                // 1 KiB per refill
+#define RNG_BUF_LEN       (RNG_BUF_BLOCKS * CHACHA_BLOCK_LEN)
+#define RNG_RESEED_BYTES  ((uint64_t)1 << 20)
+#define RNG_RESEED_SECS   300
+
+/*=============================================================================
+  Kernel entropy
+=============================================================================*/
+
+// Read from /dev/urandom; used when the getrandom syscall is unavailable
+// (pre-3.17 kernels, which older Android releases still ship).
+static int urandom_read(uint8_t *buf, size_t len) {
+    int fd;
+    do {
+        fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0) return -1;
+
+    while (len > 0) {
+        ssize_t n = read(fd, buf, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(fd);
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    close(fd);
+    return 0;
+}
+
+int random_bytes_os(uint8_t *buf, size_t len) {
+    if (!buf) return -1;
+
+#ifdef SYS_getrandom
+    while (len > 0) {
+        long n = syscall(SYS_getrandom, buf, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == ENOSYS) break;
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    if (len == 0) return 0;
+#endif
+    return urandom_read(buf, len);
+}
+
+/*=============================================================================
+  Per-thread ChaCha20 generator
+=============================================================================*/
+
+typedef struct {
+    uint32_t state[16];         // ChaCha20 input: constants, key, zero counter/nonce
+    uint8_t  buf[RNG_BUF_LEN];  // keystream; consumed bytes are zero
+    size_t   pos;               // next unused byte of buf
+    unsigned fork_gen;          // g_fork_gen when last seeded
+    uint64_t since_seed;        // bytes generated since last seeded
+    time_t   seeded_at;         // CLOCK_MONOTONIC seconds when last seeded
+} rng_state;
+
+static pthread_once_t g_rng_once = PTHREAD_ONCE_INIT;
+static pthread_key_t  g_rng_key;
+static int            g_rng_key_ok = 0;
+static unsigned       g_fork_gen = 0;   // bumped in the child after fork()
+
+static void rng_destroy(void *p) {
+    secure_wipe(p, sizeof(rng_state));
+    free(p);
+}
+
+// The child shares the parent's generator state byte for byte; make every
+// generator it touches reseed before producing output.
+static void rng_after_fork(void) {
+    g_fork_gen++;
+}
+
+static void rng_init_once(void) {
+    g_rng_key_ok = pthread_key_create(&g_rng_key, rng_destroy) == 0 &&
+                   pthread_atfork(NULL, NULL, rng_after_fork) == 0;
+}
+
+static time_t now_secs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec;
+}
+
+// Fold fresh kernel entropy into the key and drop any buffered output
+static int rng_reseed(rng_state *r) {
+    uint8_t seed[RNG_KEY_LEN];
+    if (random_bytes_os(seed, sizeof(seed)) != 0) return -1;
+    for (int i = 0; i < 8; i++) r->state[4 + i] ^= load32_le(seed + 4 * i);
+    secure_wipe(seed, sizeof(seed));
+
+    secure_wipe(r->buf, sizeof(r->buf));
+    r->pos = RNG_BUF_LEN;
+    r->fork_gen = g_fork_gen;
+    r->since_seed = 0;
+    r->seeded_at = now_secs();
+    return 0;
+}
+
+// Regenerate the buffer; its first 32 bytes replace the key
+static int rng_refill(rng_state *r) {
+    if (r->since_seed >= RNG_RESEED_BYTES || now_secs() - r->seeded_at >= RNG_RESEED_SECS) {
+        if (rng_reseed(r) != 0) return -1;
+    }
+
+    chacha_kernels_selected()->xor_blocks(r->state, r->buf, r->buf, RNG_BUF_BLOCKS);
+    for (int i = 0; i < 8; i++) r->state[4 + i] = load32_le(r->buf + 4 * i);
+    secure_wipe(r->buf, RNG_KEY_LEN);
+    r->pos = RNG_KEY_LEN;
+    r->since_seed += RNG_BUF_LEN;
+    return 0;
+}
+
+static rng_state *rng_get(void) {
+    pthread_once(&g_rng_once, rng_init_once);
+    if (!g_rng_key_ok) return NULL;
+
+    rng_state *r = pthread_getspecific(g_rng_key);
+    if (r) return r;
+
+    r = calloc(1, sizeof(*r));
+    if (!r) return NULL;
+    r->state[0] = 0x61707865;
+    r->state[1] = 0x3320646e;
+    r->state[2] = 0x79622d32;
+    r->state[3] = 0x6b206574;
+    if (rng_reseed(r) != 0 || pthread_setspecific(g_rng_key, r) != 0) {
+        rng_destroy(r);
+        return NULL;
+    }
+    return r;
+}
+
+int random_bytes(uint8_t *buf, size_t len) {
+    if (!buf) return -1;
+
+    rng_state *r = rng_get();
+    if (!r) return random_bytes_os(buf, len);
+    if (r->fork_gen != g_fork_gen && rng_reseed(r) != 0) return -1;
+
+    while (len > 0) {
+        if (r->pos == RNG_BUF_LEN && rng_refill(r) != 0) return -1;
+        size_t n = RNG_BUF_LEN - r->pos;
+        if (n > len) n = len;
+        memcpy(buf, r->buf + r->pos, n);
+        memset(r->buf + r->pos, 0, n);
+        r->pos += n;
+        buf += n;
+        len -= n;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+// native/src/crypto/random.h
+// Cryptographically secure random bytes for OpenLockr (nonces, IVs, salts).
+// random_bytes() is a buffered per-thread ChaCha20 generator seeded from the
+// kernel; random_bytes_os() goes to the kernel on every call.
+
+#ifndef OPENLOCKR_RANDOM_H
+#define OPENLOCKR_RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fill a buffer with cryptographically secure random bytes.
+ *
+ * Served from the calling thread's generator, so small requests (nonces)
+ * cost no syscall. The generator reseeds from the kernel after fork(), and
+ * periodically by output volume and time. Safe to call from any thread.
+ *
+ * @param buf  Output buffer.
+ * @param len  Number of bytes to generate.
+ * @return 0 on success, -1 on error.
+ */
+int random_bytes(uint8_t *buf, size_t len);
+
+/**
+ * Fill a buffer with random bytes straight from the kernel (getrandom(2),
+ * or /dev/urandom on kernels without it). Used to seed random_bytes().
+ *
+ * @param buf  Output buffer.
+ * @param len  Number of bytes to generate.
+ * @return 0 on success, -1 on error.
+ */
+int random_bytes_os(uint8_t *buf, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_RANDOM_H
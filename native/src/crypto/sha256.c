@@ -0,0 +1,342 @@
+// native/src/crypto/sha256.c
+// SHA-256 and HMAC-SHA256 for OpenLockr, plus the multi-buffer scheduler.
+//
+// Streaming hashes use the portable compression function. The multi-buffer
+// engine feeds up to SHA256_MAX_LANES messages through one SIMD kernel:
+// messages are sorted longest first, each lane walks its message's full
+// blocks and then a private padded tail, and every kernel call advances all
+// lanes by the blocks the shortest current segment has left. A lane that
+// finishes takes the next message from the queue.
+
+#include "sha256.h"
+#include "sha256_impl.h"
+#include "utils/bytes.h"
+#include "utils/cpu.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static pthread_once_t        g_kernels_once = PTHREAD_ONCE_INIT;
+static const sha256_kernels *g_kernels = NULL;
+
+static void kernels_select(void) {
+    const sha256_kernels *k = NULL;
+    if (cpu_has(CPU_X86_AVX2)) {
+        k = sha256_kernels_avx2();
+    }
+    if (!k && cpu_has(CPU_X86_SSE2)) {
+        k = sha256_kernels_sse2();
+    }
+    if (!k && cpu_has(CPU_ARM_NEON)) {
+        k = sha256_kernels_neon();
+    }
+    g_kernels = k ? k : sha256_kernels_portable();
+}
+
+static const sha256_kernels *kernels(void) {
+    pthread_once(&g_kernels_once, kernels_select);
+    return g_kernels;
+}
+
+const sha256_kernels *sha256_kernels_selected(void) {
+    return kernels();
+}
+
+const char *sha256_implementation(void) {
+    return kernels()->name;
+}
+
+size_t sha256_lanes(void) {
+    return kernels()->lanes;
+}
+
+/*=============================================================================
+  Streaming SHA-256
+=============================================================================*/
+
+void sha256_init(sha256_ctx *ctx) {
+    memcpy(ctx->h, SHA256_IV, sizeof(ctx->h));
+    ctx->len = 0;
+    ctx->buf_len = 0;
+}
+
+void sha256_update(sha256_ctx *ctx, const uint8_t *data, size_t len) {
+    ctx->len += len;
+
+    if (ctx->buf_len > 0) {
+        size_t n = SHA256_BLOCK_LEN - ctx->buf_len;
+        if (n > len) n = len;
+        memcpy(ctx->buf + ctx->buf_len, data, n);
+        ctx->buf_len += n;
+        data += n;
+        len -= n;
+        if (ctx->buf_len < SHA256_BLOCK_LEN) return;
+        sha256_compress(ctx->h, ctx->buf, 1);
+        ctx->buf_len = 0;
+    }
+
+    size_t blocks = len / SHA256_BLOCK_LEN;
+    if (blocks > 0) {
+        sha256_compress(ctx->h, data, blocks);
+        data += blocks * SHA256_BLOCK_LEN;
+        len -= blocks * SHA256_BLOCK_LEN;
+    }
+    memcpy(ctx->buf, data, len);
+    ctx->buf_len = len;
+}
+
+void sha256_final(sha256_ctx *ctx, uint8_t digest[SHA256_DIGEST_LEN]) {
+    uint64_t bits = ctx->len * 8;
+    size_t n = ctx->buf_len;
+
+    ctx->buf[n++] = 0x80;
+    if (n > SHA256_BLOCK_LEN - 8) {
+        memset(ctx->buf + n, 0, SHA256_BLOCK_LEN - n);
+        sha256_compress(ctx->h, ctx->buf, 1);
+        n = 0;
+    }
+    memset(ctx->buf + n, 0, SHA256_BLOCK_LEN - 8 - n);
+    store64_be(ctx->buf + SHA256_BLOCK_LEN - 8, bits);
+    sha256_compress(ctx->h, ctx->buf, 1);
+
+    for (int i = 0; i < 8; i++) store32_be(digest + 4 * i, ctx->h[i]);
+    secure_wipe(ctx, sizeof(*ctx));
+}
+
+void sha256(const uint8_t *data, size_t len, uint8_t digest[SHA256_DIGEST_LEN]) {
+    sha256_ctx ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, data, len);
+    sha256_final(&ctx, digest);
+}
+
+/*=============================================================================
+  HMAC-SHA256
+=============================================================================*/
+
+// States after absorbing the key block XOR ipad / opad; every HMAC under
+// this key continues from them with 64 bytes already counted.
+static void hmac_key_states(const uint8_t *key, size_t key_len,
+                            uint32_t istate[8], uint32_t ostate[8]) {
+    uint8_t block[SHA256_BLOCK_LEN] = {0};
+    if (key_len > SHA256_BLOCK_LEN) {
+        sha256(key, key_len, block);
+    } else if (key_len > 0) {
+        memcpy(block, key, key_len);
+    }
+
+    for (int i = 0; i < SHA256_BLOCK_LEN; i++) block[i] ^= 0x36;
+    memcpy(istate, SHA256_IV, sizeof(SHA256_IV));
+    sha256_compress(istate, block, 1);
+
+    for (int i = 0; i < SHA256_BLOCK_LEN; i++) block[i] ^= 0x36 ^ 0x5c;
+    memcpy(ostate, SHA256_IV, sizeof(SHA256_IV));
+    sha256_compress(ostate, block, 1);
+
+    secure_wipe(block, sizeof(block));
+}
+
+void hmac_sha256_init(hmac_sha256_ctx *ctx, const uint8_t *key, size_t key_len) {
+    hmac_key_states(key, key_len, ctx->inner.h, ctx->outer.h);
+    ctx->inner.len = ctx->outer.len = SHA256_BLOCK_LEN;
+    ctx->inner.buf_len = ctx->outer.buf_len = 0;
+}
+
+void hmac_sha256_update(hmac_sha256_ctx *ctx, const uint8_t *data, size_t len) {
+    sha256_update(&ctx->inner, data, len);
+}
+
+void hmac_sha256_final(hmac_sha256_ctx *ctx, uint8_t mac[SHA256_DIGEST_LEN]) {
+    uint8_t inner[SHA256_DIGEST_LEN];
+    sha256_final(&ctx->inner, inner);
+    sha256_update(&ctx->outer, inner, sizeof(inner));
+    sha256_final(&ctx->outer, mac);
+    secure_wipe(inner, sizeof(inner));
+}
+
+void hmac_sha256(const uint8_t *key, size_t key_len,
+                 const uint8_t *data, size_t len,
+                 uint8_t mac[SHA256_DIGEST_LEN]) {
+    hmac_sha256_ctx ctx;
+    hmac_sha256_init(&ctx, key, key_len);
+    hmac_sha256_update(&ctx, data, len);
+    hmac_sha256_final(&ctx, mac);
+}
+
+/*=============================================================================
+  Multi-buffer engine
+=============================================================================*/
+
+typedef struct {
+    const sha256_job *job;       // NULL when the lane is idle
+    const uint8_t    *next;      // next block to compress
+    size_t            left;      // blocks left in the current segment
+    int               in_tail;   // current segment is `tail`
+    size_t            tail_blocks;
+    uint8_t           tail[2 * SHA256_BLOCK_LEN];   // last partial block + padding
+} mb_lane;
+
+// Start `job` in lane `i`: reset its state column and build its padded tail.
+// `prefix_len` counts bytes absorbed before the message (64 for HMAC).
+static void lane_start(mb_lane *l, uint32_t *state, size_t lanes, size_t i,
+                       const uint32_t iv[8], uint64_t prefix_len,
+                       const sha256_job *job) {
+    size_t full = job->len / SHA256_BLOCK_LEN;
+    size_t rem = job->len % SHA256_BLOCK_LEN;
+
+    for (int w = 0; w < 8; w++) state[w * lanes + i] = iv[w];
+
+    l->job = job;
+    l->tail_blocks = rem + 9 > SHA256_BLOCK_LEN ? 2 : 1;
+    memset(l->tail, 0, sizeof(l->tail));
+    if (rem > 0) memcpy(l->tail, job->data + full * SHA256_BLOCK_LEN, rem);
+    l->tail[rem] = 0x80;
+    store64_be(l->tail + l->tail_blocks * SHA256_BLOCK_LEN - 8,
+               (prefix_len + job->len) * 8);
+
+    if (full > 0) {
+        l->next = job->data;
+        l->left = full;
+        l->in_tail = 0;
+    } else {
+        l->next = l->tail;
+        l->left = l->tail_blocks;
+        l->in_tail = 1;
+    }
+}
+
+/**
+ * Hash the messages in `order` (longest first) from state `iv` on kernel `k`.
+ */
+static void mb_run(const sha256_kernels *k, const uint32_t iv[8], uint64_t prefix_len,
+                   const sha256_job *const *order, size_t count) {
+    size_t lanes = k->lanes;
+    uint32_t state[8 * SHA256_MAX_LANES] = {0};
+    const uint8_t *ptrs[SHA256_MAX_LANES];
+    mb_lane lane[SHA256_MAX_LANES];
+    size_t queued = 0, active = 0;
+
+    for (size_t i = 0; i < lanes; i++) {
+        lane[i].job = NULL;
+        if (queued < count) {
+            lane_start(&lane[i], state, lanes, i, iv, prefix_len, order[queued++]);
+            active++;
+        }
+    }
+
+    while (active > 0) {
+        // Advance every lane to the end of the shortest current segment;
+        // idle lanes re-read an active lane's blocks into a dead column.
+        size_t step = SIZE_MAX;
+        const uint8_t *any = NULL;
+        for (size_t i = 0; i < lanes; i++) {
+            if (lane[i].job && lane[i].left < step) step = lane[i].left;
+            if (lane[i].job) any = lane[i].next;
+        }
+        for (size_t i = 0; i < lanes; i++) ptrs[i] = lane[i].job ? lane[i].next : any;
+        k->compress(state, ptrs, step);
+
+        for (size_t i = 0; i < lanes; i++) {
+            mb_lane *l = &lane[i];
+            if (!l->job) continue;
+            l->next += step * SHA256_BLOCK_LEN;
+            l->left -= step;
+            if (l->left > 0) continue;
+
+            if (!l->in_tail) {
+                l->next = l->tail;
+                l->left = l->tail_blocks;
+                l->in_tail = 1;
+                continue;
+            }
+            for (int w = 0; w < 8; w++) store32_be(l->job->digest + 4 * w, state[w * lanes + i]);
+            l->job = NULL;
+            active--;
+            if (queued < count) {
+                lane_start(l, state, lanes, i, iv, prefix_len, order[queued++]);
+                active++;
+            }
+        }
+    }
+
+    secure_wipe(state, sizeof(state));
+    secure_wipe(lane, sizeof(lane));
+}
+
+static int job_cmp_len_desc(const void *a, const void *b) {
+    size_t la = (*(const sha256_job *const *)a)->len;
+    size_t lb = (*(const sha256_job *const *)b)->len;
+    return la < lb ? 1 : la > lb ? -1 : 0;
+}
+
+static int jobs_valid(const sha256_job *jobs, size_t count) {
+    if (!jobs) return count == 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!jobs[i].digest || (!jobs[i].data && jobs[i].len)) return 0;
+    }
+    return 1;
+}
+
+int sha256_many(const sha256_job *jobs, size_t count) {
+    if (!jobs_valid(jobs, count)) return -1;
+    if (count == 0) return 0;
+
+    const sha256_job **order = malloc(count * sizeof(*order));
+    if (!order) return -1;
+    for (size_t i = 0; i < count; i++) order[i] = &jobs[i];
+    qsort(order, count, sizeof(*order), job_cmp_len_desc);
+
+    mb_run(kernels(), SHA256_IV, 0, order, count);
+    free(order);
+    return 0;
+}
+
+int hmac_sha256_many(const uint8_t *key, size_t key_len,
+                     const sha256_job *jobs, size_t count) {
+    if ((!key && key_len) || !jobs_valid(jobs, count)) return -1;
+    if (count == 0) return 0;
+
+    // One allocation: job order, outer jobs, inner digests
+    size_t order_size = count * sizeof(const sha256_job *);
+    size_t outer_size = count * sizeof(sha256_job);
+    size_t inner_size = count * SHA256_DIGEST_LEN;
+    uint8_t *mem = malloc(order_size + outer_size + inner_size);
+    if (!mem) return -1;
+    const sha256_job **order = (const sha256_job **)mem;
+    sha256_job *outer = (sha256_job *)(mem + order_size);
+    uint8_t *inner = mem + order_size + outer_size;
+
+    uint32_t istate[8], ostate[8];
+    hmac_key_states(key, key_len, istate, ostate);
+    const sha256_kernels *k = kernels();
+
+    // Inner hashes, written to `inner` in job order
+    for (size_t i = 0; i < count; i++) {
+        outer[i].data = jobs[i].data;
+        outer[i].len = jobs[i].len;
+        outer[i].digest = inner + i * SHA256_DIGEST_LEN;
+        order[i] = &outer[i];
+    }
+    qsort(order, count, sizeof(*order), job_cmp_len_desc);
+    mb_run(k, istate, SHA256_BLOCK_LEN, order, count);
+
+    // Outer hashes: every message is one digest long, so no sorting needed
+    for (size_t i = 0; i < count; i++) {
+        outer[i].data = inner + i * SHA256_DIGEST_LEN;
+        outer[i].len = SHA256_DIGEST_LEN;
+        outer[i].digest = jobs[i].digest;
+        order[i] = &outer[i];
+    }
+    mb_run(k, ostate, SHA256_BLOCK_LEN, order, count);
+
+    secure_wipe(istate, sizeof(istate));
+    secure_wipe(ostate, sizeof(ostate));
+    secure_wipe(inner, inner_size);
+    free(mem);
+    return 0;
+}
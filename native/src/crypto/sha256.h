@@ -0,0 +1,129 @@
+// native/src/crypto/sha256.h
+// SHA-256 and HMAC-SHA256 (FIPS 180-4, RFC 2104) interface for OpenLockr.
+//
+// Besides the usual streaming functions there is a multi-buffer engine for
+// hashing many independent messages at once (vault-wide MAC checks, keyed
+// indexes): it runs 8 messages per pass on AVX2 and 4 on SSE2 or NEON,
+// picked once by runtime CPU detection, and falls back to one at a time.
+//
+// Functions returning int return 0 on success, or -1 on error.
+
+#ifndef OPENLOCKR_SHA256_H
+#define OPENLOCKR_SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA256_DIGEST_LEN  32   ///< digest length in bytes
+#define SHA256_BLOCK_LEN   64   ///< compression block length in bytes
+
+/** Streaming SHA-256 state. */
+typedef struct {
+    uint32_t h[8];
+    uint64_t len;                     ///< bytes absorbed so far
+    uint8_t  buf[SHA256_BLOCK_LEN];
+    size_t   buf_len;
+} sha256_ctx;
+
+/** Streaming HMAC-SHA256 state. */
+typedef struct {
+    sha256_ctx inner;
+    sha256_ctx outer;
+} hmac_sha256_ctx;
+
+/**
+ * One message for the multi-buffer functions.
+ */
+typedef struct {
+    const uint8_t *data;     ///< message (may be NULL if len is 0)
+    size_t         len;      ///< message length in bytes
+    uint8_t       *digest;   ///< receives SHA256_DIGEST_LEN bytes
+} sha256_job;
+
+/*=============================================================================
+  Streaming
+=============================================================================*/
+
+void sha256_init(sha256_ctx *ctx);
+void sha256_update(sha256_ctx *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Write the digest and wipe the context.
+ */
+void sha256_final(sha256_ctx *ctx, uint8_t digest[SHA256_DIGEST_LEN]);
+
+/**
+ * One-shot SHA-256 of `len` bytes.
+ */
+void sha256(const uint8_t *data, size_t len, uint8_t digest[SHA256_DIGEST_LEN]);
+
+/**
+ * Start an HMAC-SHA256 computation. Keys longer than one block are hashed
+ * first, as RFC 2104 requires.
+ */
+void hmac_sha256_init(hmac_sha256_ctx *ctx, const uint8_t *key, size_t key_len);
+void hmac_sha256_update(hmac_sha256_ctx *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Write the MAC and wipe the context.
+ */
+void hmac_sha256_final(hmac_sha256_ctx *ctx, uint8_t mac[SHA256_DIGEST_LEN]);
+
+/**
+ * One-shot HMAC-SHA256.
+ */
+void hmac_sha256(const uint8_t *key, size_t key_len,
+                 const uint8_t *data, size_t len,
+                 uint8_t mac[SHA256_DIGEST_LEN]);
+
+/*=============================================================================
+  Multi-buffer
+=============================================================================*/
+
+/**
+ * Name of the multi-buffer kernel selected for this CPU
+ * ("avx2", "sse2", "neon" or "portable"). Triggers CPU detection on first call.
+ */
+const char *sha256_implementation(void);
+
+/**
+ * Number of messages the selected kernel hashes per pass (1, 4 or 8).
+ * Batches of at least this many messages of similar length make best use
+ * of the engine.
+ */
+size_t sha256_lanes(void);
+
+/**
+ * Hash `count` independent messages. Messages are ordered by length and
+ * run through the SIMD lanes together; a lane that finishes picks up the
+ * next message, so mixed lengths are fine. Results are identical to
+ * sha256() on each message.
+ *
+ * @param jobs   Array of `count` messages; each digest is written in place.
+ * @param count  Number of messages (0 is a no-op).
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int sha256_many(const sha256_job *jobs, size_t count);
+
+/**
+ * HMAC-SHA256 of `count` independent messages under one key, on the same
+ * engine: one multi-buffer pass for the inner hashes, one for the outer.
+ *
+ * @param key      MAC key.
+ * @param key_len  Length in bytes of the key.
+ * @param jobs     Array of `count` messages; each MAC is written to `digest`.
+ * @param count    Number of messages (0 is a no-op).
+ * @return 0 on success, -1 on invalid arguments or allocation failure.
+ */
+int hmac_sha256_many(const uint8_t *key, size_t key_len,
+                     const sha256_job *jobs, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_SHA256_H
@@ -0,0 +1,106 @@
+// native/src/crypto/sha256_avx2.c
+// Multi-buffer SHA-256 kernel using AVX2, eight messages per pass (x86_64).
+//
+// Same word-sliced layout as the SSE2 kernel, twice as wide: lanes 0-3 are
+// transposed into the low 128 bits and lanes 4-7 into the high 128 bits.
+// Built with -mavx2 (see CMakeLists.txt); only reached after cpu_features()
+// reports AVX2.
+
+#include "sha256_impl.h"
+#include "utils/bytes.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#define LANES 8
+
+#define LOADU(p)     _mm_loadu_si128((const __m128i *)(p))
+#define ADD(a, b)    _mm256_add_epi32((a), (b))
+#define XOR(a, b)    _mm256_xor_si256((a), (b))
+#define ROTR(v, n)   _mm256_or_si256(_mm256_srli_epi32((v), (n)), _mm256_slli_epi32((v), 32 - (n)))
+
+#define BSIG0(x)  XOR(XOR(ROTR(x, 2), ROTR(x, 13)), ROTR(x, 22))
+#define BSIG1(x)  XOR(XOR(ROTR(x, 6), ROTR(x, 11)), ROTR(x, 25))
+#define SSIG0(x)  XOR(XOR(ROTR(x, 7), ROTR(x, 18)), _mm256_srli_epi32(x, 3))
+#define SSIG1(x)  XOR(XOR(ROTR(x, 17), ROTR(x, 19)), _mm256_srli_epi32(x, 10))
+#define CH(e, f, g)   XOR(g, _mm256_and_si256(e, XOR(f, g)))
+#define MAJ(a, b, c)  _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)))
+
+// Transpose 16 bytes from each of four lanes into four word-sliced vectors
+static void transpose4(__m128i y[4], const uint8_t *const *p, size_t off) {
+    __m128i r0 = LOADU(p[0] + off), r1 = LOADU(p[1] + off);
+    __m128i r2 = LOADU(p[2] + off), r3 = LOADU(p[3] + off);
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+    y[0] = _mm_unpacklo_epi64(t0, t1);
+    y[1] = _mm_unpackhi_epi64(t0, t1);
+    y[2] = _mm_unpacklo_epi64(t2, t3);
+    y[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+// Schedule words 0..15 of one block from each lane, word-sliced
+static void load8(__m256i *w, const uint8_t *const *p, size_t off) {
+    const __m256i bswap = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (int g = 0; g < 4; g++) {
+        __m128i lo[4], hi[4];
+        transpose4(lo, p, off + 16 * g);
+        transpose4(hi, p + 4, off + 16 * g);
+        for (int j = 0; j < 4; j++) {
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo[j]), hi[j], 1);
+            w[4 * g + j] = _mm256_shuffle_epi8(v, bswap);
+        }
+    }
+}
+
+static void avx2_compress(uint32_t *state, const uint8_t *const *blocks, size_t nblocks) {
+    __m256i s[8], w[16];
+    for (int i = 0; i < 8; i++) s[i] = _mm256_loadu_si256((const __m256i *)(state + LANES * i));
+
+    for (size_t off = 0; off < nblocks * 64; off += 64) {
+        __m256i a = s[0], b = s[1], c = s[2], d = s[3];
+        __m256i e = s[4], f = s[5], g = s[6], h = s[7];
+        load8(w, blocks, off);
+
+        for (int t = 0; t < 64; t++) {
+            if (t >= 16) {
+                w[t & 15] = ADD(ADD(w[t & 15], SSIG1(w[(t - 2) & 15])),
+                                ADD(w[(t - 7) & 15], SSIG0(w[(t - 15) & 15])));
+            }
+            __m256i t1 = ADD(ADD(h, BSIG1(e)), ADD(CH(e, f, g),
+                             ADD(_mm256_set1_epi32((int)sha256_k[t]), w[t & 15])));
+            __m256i t2 = ADD(BSIG0(a), MAJ(a, b, c));
+            h = g; g = f; f = e; e = ADD(d, t1);
+            d = c; c = b; b = a; a = ADD(t1, t2);
+        }
+
+        s[0] = ADD(s[0], a); s[1] = ADD(s[1], b); s[2] = ADD(s[2], c); s[3] = ADD(s[3], d);
+        s[4] = ADD(s[4], e); s[5] = ADD(s[5], f); s[6] = ADD(s[6], g); s[7] = ADD(s[7], h);
+    }
+
+    for (int i = 0; i < 8; i++) _mm256_storeu_si256((__m256i *)(state + LANES * i), s[i]);
+    secure_wipe(w, sizeof(w));
+    _mm256_zeroupper();
+}
+
+static const sha256_kernels k_avx2 = {
+    "avx2",
+    LANES,
+    avx2_compress,
+};
+
+const sha256_kernels *sha256_kernels_avx2(void) {
+    return &k_avx2;
+}
+
+#else
+
+const sha256_kernels *sha256_kernels_avx2(void) {
+    return NULL;
+}
+
+#endif
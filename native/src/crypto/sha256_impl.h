@@ -0,0 +1,56 @@
+// native/src/crypto/sha256_impl.h
+// Internal SHA-256 kernel interface shared by sha256.c and the per-ISA
+// multi-buffer kernels. Not part of the public API.
+//
+// A kernel runs the compression function over `lanes` independent messages
+// at once, one message per SIMD lane. State is kept word-sliced: word w of
+// lane i lives at state[w * lanes + i], so a kernel loads each state word of
+// every lane with one vector load. Padding, scheduling and HMAC are handled
+// in portable code.
+
+#ifndef OPENLOCKR_SHA256_IMPL_H
+#define OPENLOCKR_SHA256_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_MAX_LANES  8
+
+typedef struct {
+    const char *name;
+    size_t      lanes;      // independent messages per pass
+
+    // Compress `nblocks` consecutive 64-byte blocks into every lane; lane i
+    // reads them from blocks[i]. Every pointer must be readable.
+    void (*compress)(uint32_t *state, const uint8_t *const *blocks, size_t nblocks);
+} sha256_kernels;
+
+/** SHA-256 round constants (FIPS 180-4, 4.2.2). */
+extern const uint32_t sha256_k[64];
+
+/**
+ * Compress `nblocks` consecutive 64-byte blocks into one state (portable).
+ */
+void sha256_compress(uint32_t state[8], const uint8_t *blocks, size_t nblocks);
+
+/**
+ * Compress one block given as 16 host-order message words (portable).
+ * `w` is used as the schedule buffer and overwritten.
+ */
+void sha256_compress_words(uint32_t state[8], uint32_t w[16]);
+
+/**
+ * Kernel tables. The vector getters return NULL when the kernel was not
+ * compiled for this ABI; callers must still check CPU features before use.
+ */
+const sha256_kernels *sha256_kernels_portable(void);  // 1 lane
+const sha256_kernels *sha256_kernels_sse2(void);      // 4 lanes
+const sha256_kernels *sha256_kernels_avx2(void);      // 8 lanes
+const sha256_kernels *sha256_kernels_neon(void);      // 4 lanes
+
+/**
+ * Widest kernel this CPU supports, chosen once per process.
+ */
+const sha256_kernels *sha256_kernels_selected(void);
+
+#endif // OPENLOCKR_SHA256_IMPL_H
@@ -0,0 +1,92 @@
+// native/src/crypto/sha256_neon.c
+// Multi-buffer SHA-256 kernel using NEON / Advanced SIMD, four messages per
+// pass (armeabi-v7a and arm64).
+//
+// Same word-sliced layout as the SSE2 kernel. Built with -mfpu=neon on
+// 32-bit ARM (see CMakeLists.txt); only reached after cpu_features()
+// reports NEON.
+
+#include "sha256_impl.h"
+#include "utils/bytes.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+#define LANES 4
+
+#define ADD(a, b)    vaddq_u32((a), (b))
+#define XOR(a, b)    veorq_u32((a), (b))
+#define ROTR(v, n)   vsriq_n_u32(vshlq_n_u32((v), 32 - (n)), (v), (n))
+
+#define BSIG0(x)  XOR(XOR(ROTR(x, 2), ROTR(x, 13)), ROTR(x, 22))
+#define BSIG1(x)  XOR(XOR(ROTR(x, 6), ROTR(x, 11)), ROTR(x, 25))
+#define SSIG0(x)  XOR(XOR(ROTR(x, 7), ROTR(x, 18)), vshrq_n_u32(x, 3))
+#define SSIG1(x)  XOR(XOR(ROTR(x, 17), ROTR(x, 19)), vshrq_n_u32(x, 10))
+#define CH(e, f, g)   XOR(g, vandq_u32(e, XOR(f, g)))
+#define MAJ(a, b, c)  vorrq_u32(vandq_u32(a, b), vandq_u32(c, vorrq_u32(a, b)))
+
+// Big-endian words 4g..4g+3 of one lane, in host order
+static inline uint32x4_t load_be(const uint8_t *p) {
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p)));
+}
+
+// Schedule words 0..15 of one block from each lane, word-sliced
+static void load4(uint32x4_t *w, const uint8_t *const *p, size_t off) {
+    for (int g = 0; g < 4; g++) {
+        size_t o = off + 16 * g;
+        uint32x4x2_t t01 = vtrnq_u32(load_be(p[0] + o), load_be(p[1] + o));
+        uint32x4x2_t t23 = vtrnq_u32(load_be(p[2] + o), load_be(p[3] + o));
+        w[4 * g]     = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+        w[4 * g + 1] = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+        w[4 * g + 2] = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+        w[4 * g + 3] = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+    }
+}
+
+static void neon_compress(uint32_t *state, const uint8_t *const *blocks, size_t nblocks) {
+    uint32x4_t s[8], w[16];
+    for (int i = 0; i < 8; i++) s[i] = vld1q_u32(state + LANES * i);
+
+    for (size_t off = 0; off < nblocks * 64; off += 64) {
+        uint32x4_t a = s[0], b = s[1], c = s[2], d = s[3];
+        uint32x4_t e = s[4], f = s[5], g = s[6], h = s[7];
+        load4(w, blocks, off);
+
+        for (int t = 0; t < 64; t++) {
+            if (t >= 16) {
+                w[t & 15] = ADD(ADD(w[t & 15], SSIG1(w[(t - 2) & 15])),
+                                ADD(w[(t - 7) & 15], SSIG0(w[(t - 15) & 15])));
+            }
+            uint32x4_t t1 = ADD(ADD(h, BSIG1(e)), ADD(CH(e, f, g),
+                                ADD(vdupq_n_u32(sha256_k[t]), w[t & 15])));
+            uint32x4_t t2 = ADD(BSIG0(a), MAJ(a, b, c));
+            h = g; g = f; f = e; e = ADD(d, t1);
+            d = c; c = b; b = a; a = ADD(t1, t2);
+        }
+
+        s[0] = ADD(s[0], a); s[1] = ADD(s[1], b); s[2] = ADD(s[2], c); s[3] = ADD(s[3], d);
+        s[4] = ADD(s[4], e); s[5] = ADD(s[5], f); s[6] = ADD(s[6], g); s[7] = ADD(s[7], h);
+    }
+
+    for (int i = 0; i < 8; i++) vst1q_u32(state + LANES * i, s[i]);
+    secure_wipe(w, sizeof(w));
+}
+
+static const sha256_kernels k_neon = {
+    "neon",
+    LANES,
+    neon_compress,
+};
+
+const sha256_kernels *sha256_kernels_neon(void) {
+    return &k_neon;
+}
+
+#else
+
+const sha256_kernels *sha256_kernels_neon(void) {
+    return NULL;
+}
+
+#endif
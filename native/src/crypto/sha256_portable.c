@@ -0,0 +1,69 @@
+// native/src/crypto/sha256_portable.c
+// Portable SHA-256 compression function and single-lane kernel for OpenLockr.
+
+#include "sha256_impl.h"
+#include "utils/bytes.h"
+
+#define ROTR32(v, n)  (((v) >> (n)) | ((v) << (32 - (n))))
+
+#define BSIG0(x)  (ROTR32(x, 2) ^ ROTR32(x, 13) ^ ROTR32(x, 22))
+#define BSIG1(x)  (ROTR32(x, 6) ^ ROTR32(x, 11) ^ ROTR32(x, 25))
+#define SSIG0(x)  (ROTR32(x, 7) ^ ROTR32(x, 18) ^ ((x) >> 3))
+#define SSIG1(x)  (ROTR32(x, 17) ^ ROTR32(x, 19) ^ ((x) >> 10))
+#define CH(e, f, g)   ((g) ^ ((e) & ((f) ^ (g))))
+#define MAJ(a, b, c)  (((a) & (b)) | ((c) & ((a) | (b))))
+
+const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+void sha256_compress_words(uint32_t state[8], uint32_t w[16]) {
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int t = 0; t < 64; t++) {
+        if (t >= 16) {
+            w[t & 15] += SSIG1(w[(t - 2) & 15]) + w[(t - 7) & 15] + SSIG0(w[(t - 15) & 15]);
+        }
+        uint32_t t1 = h + BSIG1(e) + CH(e, f, g) + sha256_k[t] + w[t & 15];
+        uint32_t t2 = BSIG0(a) + MAJ(a, b, c);
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+void sha256_compress(uint32_t state[8], const uint8_t *blocks, size_t nblocks) {
+    uint32_t w[16];
+
+    for (; nblocks > 0; nblocks--, blocks += 64) {
+        for (int t = 0; t < 16; t++) w[t] = load32_be(blocks + 4 * t);
+        sha256_compress_words(state, w);
+    }
+
+    secure_wipe(w, sizeof(w));
+}
+
+// With one lane the word-sliced layout is just the plain state
+static void portable_compress(uint32_t *state, const uint8_t *const *blocks, size_t nblocks) {
+    sha256_compress(state, blocks[0], nblocks);
+}
+
+static const sha256_kernels k_portable = {
+    "portable",
+    1,
+    portable_compress,
+};
+
+const sha256_kernels *sha256_kernels_portable(void) {
+    return &k_portable;
+}
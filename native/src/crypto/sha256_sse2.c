@@ -0,0 +1,97 @@
+// native/src/crypto/sha256_sse2.c
+// Multi-buffer SHA-256 kernel using SSE2, four messages per pass
+// (x86 / x86_64).
+//
+// Each vector holds one state or schedule word for four messages. Message
+// words are transposed into that layout 4x4 at a time and byte-swapped with
+// shuffles, since SSE2 has no pshufb. Built with -msse2 (see CMakeLists.txt).
+
+#include "sha256_impl.h"
+#include "utils/bytes.h"
+
+#if defined(__SSE2__)
+
+#include <emmintrin.h>
+
+#define LANES 4
+
+#define LOADU(p)     _mm_loadu_si128((const __m128i *)(p))
+#define ADD(a, b)    _mm_add_epi32((a), (b))
+#define XOR(a, b)    _mm_xor_si128((a), (b))
+#define ROTR(v, n)   _mm_or_si128(_mm_srli_epi32((v), (n)), _mm_slli_epi32((v), 32 - (n)))
+
+#define BSIG0(x)  XOR(XOR(ROTR(x, 2), ROTR(x, 13)), ROTR(x, 22))
+#define BSIG1(x)  XOR(XOR(ROTR(x, 6), ROTR(x, 11)), ROTR(x, 25))
+#define SSIG0(x)  XOR(XOR(ROTR(x, 7), ROTR(x, 18)), _mm_srli_epi32(x, 3))
+#define SSIG1(x)  XOR(XOR(ROTR(x, 17), ROTR(x, 19)), _mm_srli_epi32(x, 10))
+#define CH(e, f, g)   XOR(g, _mm_and_si128(e, XOR(f, g)))
+#define MAJ(a, b, c)  _mm_or_si128(_mm_and_si128(a, b), _mm_and_si128(c, _mm_or_si128(a, b)))
+
+// Big-endian words to host order: swap 16-bit halves, then bytes within them
+static __m128i bswap32(__m128i v) {
+    v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+// Schedule words 4g..4g+3 of one block from each lane, word-sliced
+static void load4(__m128i *w, const uint8_t *const *p, size_t off) {
+    for (int g = 0; g < 4; g++) {
+        __m128i r0 = LOADU(p[0] + off + 16 * g), r1 = LOADU(p[1] + off + 16 * g);
+        __m128i r2 = LOADU(p[2] + off + 16 * g), r3 = LOADU(p[3] + off + 16 * g);
+        __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+        __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+        __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+        w[4 * g]     = bswap32(_mm_unpacklo_epi64(t0, t1));
+        w[4 * g + 1] = bswap32(_mm_unpackhi_epi64(t0, t1));
+        w[4 * g + 2] = bswap32(_mm_unpacklo_epi64(t2, t3));
+        w[4 * g + 3] = bswap32(_mm_unpackhi_epi64(t2, t3));
+    }
+}
+
+static void sse2_compress(uint32_t *state, const uint8_t *const *blocks, size_t nblocks) {
+    __m128i s[8], w[16];
+    for (int i = 0; i < 8; i++) s[i] = _mm_loadu_si128((const __m128i *)(state + LANES * i));
+
+    for (size_t off = 0; off < nblocks * 64; off += 64) {
+        __m128i a = s[0], b = s[1], c = s[2], d = s[3];
+        __m128i e = s[4], f = s[5], g = s[6], h = s[7];
+        load4(w, blocks, off);
+
+        for (int t = 0; t < 64; t++) {
+            if (t >= 16) {
+                w[t & 15] = ADD(ADD(w[t & 15], SSIG1(w[(t - 2) & 15])),
+                                ADD(w[(t - 7) & 15], SSIG0(w[(t - 15) & 15])));
+            }
+            __m128i t1 = ADD(ADD(h, BSIG1(e)), ADD(CH(e, f, g),
+                             ADD(_mm_set1_epi32((int)sha256_k[t]), w[t & 15])));
+            __m128i t2 = ADD(BSIG0(a), MAJ(a, b, c));
+            h = g; g = f; f = e; e = ADD(d, t1);
+            d = c; c = b; b = a; a = ADD(t1, t2);
+        }
+
+        s[0] = ADD(s[0], a); s[1] = ADD(s[1], b); s[2] = ADD(s[2], c); s[3] = ADD(s[3], d);
+        s[4] = ADD(s[4], e); s[5] = ADD(s[5], f); s[6] = ADD(s[6], g); s[7] = ADD(s[7], h);
+    }
+
+    for (int i = 0; i < 8; i++) _mm_storeu_si128((__m128i *)(state + LANES * i), s[i]);
+    secure_wipe(w, sizeof(w));
+}
+
+static const sha256_kernels k_sse2 = {
+    "sse2",
+    LANES,
+    sse2_compress,
+};
+
+const sha256_kernels *sha256_kernels_sse2(void) {
+    return &k_sse2;
+}
+
+#else
+
+const sha256_kernels *sha256_kernels_sse2(void) {
+    return NULL;
+}
+
+#endif
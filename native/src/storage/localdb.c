@@ -1,6 +1,9 @@
 // native/src/storage/localdb.c
 // Local storage backend for OpenLockr using SQLite3.
-// Implements simple key–value store: table `entries(id TEXT PRIMARY KEY, cipher TEXT)`.
+// Implements simple key–value store: table `entries(id TEXT PRIMARY KEY, cipher TEXT)`,
+// plus `meta(key TEXT PRIMARY KEY, value TEXT)` for per-vault parameters and
+// `blobs(id TEXT PRIMARY KEY, cipher TEXT, synced INTEGER)` for
+// content-addressed ciphertexts, with whether each has reached Firestore.
 
 #include "localdb.h"
 #include <sqlite3.h>
@@ -8,24 +11,55 @@
 #include <string.h>
 
 #define DB_FILENAME    "openlockr.db"
-#define SQL_CREATE     "CREATE TABLE IF NOT EXISTS entries (id TEXT PRIMARY KEY, cipher TEXT);"
+#define SQL_CREATE     "CREATE TABLE IF NOT EXISTS entries (id TEXT PRIMARY KEY, cipher TEXT);" \
+                       "CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value TEXT);" \
+                       "CREATE TABLE IF NOT EXISTS blobs (id TEXT PRIMARY KEY, cipher TEXT," \
+                       " synced INTEGER NOT NULL DEFAULT 0);"
 #define SQL_INSERT     "INSERT OR REPLACE INTO entries (id, cipher) VALUES (?, ?);"
 #define SQL_SELECT     "SELECT cipher FROM entries WHERE id = ?;"
+#define SQL_ANY_ENTRY  "SELECT 1 FROM entries LIMIT 1;"
+#define SQL_WARM       "SELECT sum(length(cipher)) FROM entries;"
+#define SQL_META_PUT   "INSERT OR REPLACE INTO meta (key, value) VALUES (?, ?);"
+#define SQL_META_GET   "SELECT value FROM meta WHERE key = ?;"
+#define SQL_BLOB_PUT   "INSERT OR IGNORE INTO blobs (id, cipher) VALUES (?, ?);"
+#define SQL_BLOB_GET   "SELECT cipher FROM blobs WHERE id = ?;"
+#define SQL_BLOB_HAS_SYNCED "SELECT synced FROM blobs LIMIT 0;"
+#define SQL_BLOB_ADD_SYNCED "ALTER TABLE blobs ADD COLUMN synced INTEGER NOT NULL DEFAULT 0;"
+#define SQL_BLOB_SYNCED     "SELECT synced FROM blobs WHERE id = ?;"
+#define SQL_BLOB_SET_SYNCED "UPDATE blobs SET synced = 1 WHERE id = ?;"
 
 static sqlite3 *g_db = NULL;
 
 /**
- * Initialize the local SQLite database.
- * Opens (or creates) DB_FILENAME in working directory and ensures table exists.
+ * Open DB_FILENAME in working directory without touching the schema.
+ * A no-op if the database is already open.
  */
-int localdb_init(void) {
+int localdb_open(void) {
+    if (g_db) return 0;
     int rc = sqlite3_open(DB_FILENAME, &g_db);
     if (rc != SQLITE_OK) {
         sqlite3_close(g_db);
         g_db = NULL;
         return -1;
     }
-    rc = sqlite3_exec(g_db, SQL_CREATE, NULL, NULL, NULL);
+    return 0;
+}
+
+/**
+ * Initialize the local SQLite database.
+ * Opens (or creates) DB_FILENAME in working directory and ensures table exists.
+ */
+int localdb_init(void) {
+    if (localdb_open() != 0) return -1;
+    int rc = sqlite3_exec(g_db, SQL_CREATE, NULL, NULL, NULL);
+
+    // Blobs tables created before the synced column get it (rows unsynced)
+    sqlite3_stmt *stmt = NULL;
+    if (rc == SQLITE_OK &&
+        sqlite3_prepare_v2(g_db, SQL_BLOB_HAS_SYNCED, -1, &stmt, NULL) != SQLITE_OK) {
+        rc = sqlite3_exec(g_db, SQL_BLOB_ADD_SYNCED, NULL, NULL, NULL);
+    }
+    sqlite3_finalize(stmt);
     if (rc != SQLITE_OK) {
         sqlite3_close(g_db);
         g_db = NULL;
@@ -34,6 +68,20 @@ int localdb_init(void) {
     return 0;
 }
 
+/**
+ * Read every entry once so its pages are cached before the first lookup.
+ */
+int localdb_warm(void) {
+    if (!g_db) return -1;
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(g_db, SQL_WARM, -1, &stmt, NULL) != SQLITE_OK) {
+        return -1;
+    }
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_ROW ? 0 : -1;
+}
+
 /**
  * Close the local database.
  */
@@ -44,23 +92,15 @@ void localdb_close(void) {
     }
 }
 
-/**
- * Store or update an entry in local DB.
- *
- * @param id         Null-terminated entry identifier.
- * @param b64_cipher Null-terminated Base64 ciphertext.
- * @return 0 on success, non-zero on error.
- */
-int localdb_put_entry(const char *id, const char *b64_cipher) {
-    if (!g_db || !id || !b64_cipher) return -1;
-
+// Run a two-parameter INSERT OR REPLACE statement
+static int put_text(const char *sql, const char *key, const char *value) {
     sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(g_db, SQL_INSERT, -1, &stmt, NULL);
+    int rc = sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL);
     if (rc != SQLITE_OK) {
         return -1;
     }
-    sqlite3_bind_text(stmt, 1, id, -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, b64_cipher, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 1, key, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, value, -1, SQLITE_STATIC);
 
     rc = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
@@ -70,37 +110,26 @@ int localdb_put_entry(const char *id, const char *b64_cipher) {
     return 0;
 }
 
-/**
- * Retrieve an entry's Base64 ciphertext by id.
- *
- * @param id        Null-terminated entry identifier.
- * @param out_b64   Pointer-to-pointer; on success *out_b64 = malloc'd cipher string.
- *                  Caller must free().
- * @return  0 on success,
- *         -2 if not found,
- *         -1 on other errors.
- */
-int localdb_get_entry(const char *id, char **out_b64) {
-    if (!g_db || !id || !out_b64) return -1;
-
+// Run a one-parameter SELECT and copy out the first text column
+static int get_text(const char *sql, const char *key, char **out) {
     sqlite3_stmt *stmt = NULL;
-    int rc = sqlite3_prepare_v2(g_db, SQL_SELECT, -1, &stmt, NULL);
+    int rc = sqlite3_prepare_v2(g_db, sql, -1, &stmt, NULL);
     if (rc != SQLITE_OK) {
         return -1;
     }
-    sqlite3_bind_text(stmt, 1, id, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 1, key, -1, SQLITE_STATIC);
 
     rc = sqlite3_step(stmt);
     if (rc == SQLITE_ROW) {
         const unsigned char *text = sqlite3_column_text(stmt, 0);
         if (text) {
             size_t len = strlen((const char *)text);
-            *out_b64 = (char *)malloc(len + 1);
-            if (!*out_b64) {
+            *out = (char *)malloc(len + 1);
+            if (!*out) {
                 sqlite3_finalize(stmt);
                 return -1;
             }
-            memcpy(*out_b64, text, len + 1);
+            memcpy(*out, text, len + 1);
             sqlite3_finalize(stmt);
             return 0;
         }
@@ -110,3 +139,110 @@ int localdb_get_entry(const char *id, char **out_b64) {
     sqlite3_finalize(stmt);
     return -2;  // not found
 }
+
+/**
+ * Store or update an entry in local DB.
+ *
+ * @param id         Null-terminated entry identifier.
+ * @param b64_cipher Null-terminated Base64 ciphertext.
+ * @return 0 on success, non-zero on error.
+ */
+int localdb_put_entry(const char *id, const char *b64_cipher) {
+    if (!g_db || !id || !b64_cipher) return -1;
+    return put_text(SQL_INSERT, id, b64_cipher);
+}
+
+/**
+ * Retrieve an entry's Base64 ciphertext by id.
+ *
+ * @param id        Null-terminated entry identifier.
+ * @param out_b64   Pointer-to-pointer; on success *out_b64 = malloc'd cipher string.
+ *                  Caller must free().
+ * @return  0 on success,
+ *         -2 if not found,
+ *         -1 on other errors.
+ */
+int localdb_get_entry(const char *id, char **out_b64) {
+    if (!g_db || !id || !out_b64) return -1;
+    return get_text(SQL_SELECT, id, out_b64);
+}
+
+/**
+ * Report whether the `entries` table holds at least one row.
+ */
+int localdb_has_entries(void) {
+    if (!g_db) return -1;
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(g_db, SQL_ANY_ENTRY, -1, &stmt, NULL) != SQLITE_OK) {
+        return -1;
+    }
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc == SQLITE_ROW) return 1;
+    return rc == SQLITE_DONE ? 0 : -1;
+}
+
+/**
+ * Store or update a vault parameter.
+ */
+int localdb_put_meta(const char *key, const char *value) {
+    if (!g_db || !key || !value) return -1;
+    return put_text(SQL_META_PUT, key, value);
+}
+
+/**
+ * Retrieve a vault parameter; -2 if it has never been set.
+ */
+int localdb_get_meta(const char *key, char **out_value) {
+    if (!g_db || !key || !out_value) return -1;
+    return get_text(SQL_META_GET, key, out_value);
+}
+
+/**
+ * Store a content-addressed blob unless one with that id already exists.
+ */
+int localdb_put_blob(const char *id, const char *b64_cipher, int *out_inserted) {
+    if (!g_db || !id || !b64_cipher || !out_inserted) return -1;
+    if (put_text(SQL_BLOB_PUT, id, b64_cipher) != 0) return -1;
+    *out_inserted = sqlite3_changes(g_db) > 0;
+    return 0;
+}
+
+/**
+ * Retrieve a blob by content id; -2 if it is not stored locally.
+ */
+int localdb_get_blob(const char *id, char **out_b64) {
+    if (!g_db || !id || !out_b64) return -1;
+    return get_text(SQL_BLOB_GET, id, out_b64);
+}
+
+/**
+ * Report whether a stored blob has been marked synced.
+ */
+int localdb_blob_synced(const char *id) {
+    if (!g_db || !id) return -1;
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(g_db, SQL_BLOB_SYNCED, -1, &stmt, NULL) != SQLITE_OK) {
+        return -1;
+    }
+    sqlite3_bind_text(stmt, 1, id, -1, SQLITE_STATIC);
+    int rc = sqlite3_step(stmt);
+    int synced = rc == SQLITE_ROW ? sqlite3_column_int(stmt, 0) != 0 : rc == SQLITE_DONE ? -2 : -1;
+    sqlite3_finalize(stmt);
+    return synced;
+}
+
+/**
+ * Mark a stored blob as uploaded.
+ */
+int localdb_set_blob_synced(const char *id) {
+    if (!g_db || !id) return -1;
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(g_db, SQL_BLOB_SET_SYNCED, -1, &stmt, NULL) != SQLITE_OK) {
+        return -1;
+    }
+    sqlite3_bind_text(stmt, 1, id, -1, SQLITE_STATIC);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE ? 0 : -1;
+}
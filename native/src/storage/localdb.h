@@ -8,14 +8,32 @@
 extern "C" {
 #endif
 
+/**
+ * Open the SQLite file without creating or checking tables, so an existing
+ * vault's meta can be read before localdb_init() finishes the job.
+ * Does nothing if the database is already open.
+ *
+ * @return 0 on success, non-zero on error.
+ */
+int localdb_open(void);
+
 /**
  * Initialize the local database.
- * Opens (or creates) the SQLite file and ensures the `entries` table exists.
+ * Opens (or creates) the SQLite file and ensures the `entries`, `meta` and
+ * `blobs` tables exist. Reuses a database opened by localdb_open().
  *
  * @return 0 on success, non-zero on error.
  */
 int localdb_init(void);
 
+/**
+ * Read through the `entries` table once so its pages are in the OS page
+ * cache (and SQLite's, as far as it holds them) before the first lookup.
+ *
+ * @return 0 on success, non-zero on error.
+ */
+int localdb_warm(void);
+
 /**
  * Close the local database, freeing resources.
  */
@@ -43,6 +61,77 @@ int localdb_put_entry(const char *id, const char *b64_cipher);
  */
 int localdb_get_entry(const char *id, char **out_b64);
 
+/**
+ * Check whether any entry is stored locally.
+ *
+ * @return 1 if the `entries` table has a row, 0 if it is empty,
+ *         -1 on error.
+ */
+int localdb_has_entries(void);
+
+/**
+ * Store or update a vault parameter in the `meta` table.
+ *
+ * @param key    Null-terminated parameter name.
+ * @param value  Null-terminated parameter value.
+ * @return 0 on success, non-zero on error.
+ */
+int localdb_put_meta(const char *key, const char *value);
+
+/**
+ * Retrieve a vault parameter from the `meta` table.
+ *
+ * @param key        Null-terminated parameter name.
+ * @param out_value  Pointer-to-pointer; on success *out_value will be set to a
+ *                   malloc()’d null-terminated string. Caller must free(*out_value).
+ * @return  0 on success,
+ *         -2 if the parameter is not set,
+ *         -1 on other errors.
+ */
+int localdb_get_meta(const char *key, char **out_value);
+
+/**
+ * Store a content-addressed ciphertext in the `blobs` table. Blobs are
+ * immutable: if `id` is already present the existing row is kept.
+ *
+ * @param id            Null-terminated content id.
+ * @param b64_cipher    Null-terminated Base64-encoded ciphertext.
+ * @param out_inserted  Set to 1 if the blob was new, 0 if it already existed.
+ * @return 0 on success, non-zero on error.
+ */
+int localdb_put_blob(const char *id, const char *b64_cipher, int *out_inserted);
+
+/**
+ * Retrieve a blob's Base64-encoded ciphertext by content id.
+ *
+ * @param id       Null-terminated content id.
+ * @param out_b64  Pointer-to-pointer; on success *out_b64 will be set to a
+ *                 malloc()’d null-terminated string. Caller must free(*out_b64).
+ * @return  0 on success,
+ *         -2 if the blob is not stored locally,
+ *         -1 on other errors.
+ */
+int localdb_get_blob(const char *id, char **out_b64);
+
+/**
+ * Report whether a blob has been uploaded (see localdb_set_blob_synced()).
+ * Blobs start out unsynced.
+ *
+ * @param id  Null-terminated content id.
+ * @return  1 if synced, 0 if not,
+ *         -2 if the blob is not stored locally,
+ *         -1 on other errors.
+ */
+int localdb_blob_synced(const char *id);
+
+/**
+ * Record that a blob has reached Firestore.
+ *
+ * @param id  Null-terminated content id.
+ * @return 0 on success, non-zero on error.
+ */
+int localdb_set_blob_synced(const char *id);
+
 #ifdef __cplusplus
 }
 #endif
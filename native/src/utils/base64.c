@@ -1,12 +1,18 @@
 // native/src/utils/base64.c
 // Minimal Base64 encode/decode implementation for OpenLockr.
-// Provides malloc()-allocated output; caller must free().
+// Provides malloc()-allocated output (caller must free()) or in-place
+// conversion within a caller buffer. Bulk data goes through a SIMD kernel
+// picked once by runtime CPU detection (base64_impl.h); the scalar loops
+// below do the rest.
 
 #include "base64.h"
+#include "base64_impl.h"
+#include "cpu.h"
+#include <pthread.h>
 #include <stdlib.h>
+#include <limits.h>
 #include <string.h>
 #include <stdint.h>
-#include <stdbool.h>
 
 // Base64 character set
 static const char b64_table[] =
@@ -14,40 +20,86 @@ static const char b64_table[] =
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";
 
-// Reverse lookup table (built at runtime)
-static uint8_t b64_rev[256];
-static bool    b64_rev_inited = false;
+// Reverse lookup: character -> 6-bit value, 0xFF if not in the alphabet
+static const uint8_t b64_rev[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
 
-// Build reverse lookup table once
-static void init_b64_rev(void) {
-    if (b64_rev_inited) return;
-    memset(b64_rev, 0xFF, sizeof(b64_rev));
-    for (int i = 0; i < 64; i++) {
-        b64_rev[(unsigned char)b64_table[i]] = (uint8_t)i;
+static pthread_once_t        g_kernels_once = PTHREAD_ONCE_INIT;
+static const base64_kernels *g_kernels = NULL;   // NULL: scalar only
+
+static void kernels_select(void) {
+    const base64_kernels *k = NULL;
+    if (cpu_has(CPU_X86_AVX2)) {
+        k = base64_kernels_avx2();
+    }
+    if (!k && cpu_has(CPU_X86_SSSE3)) {
+        k = base64_kernels_ssse3();
     }
-    b64_rev_inited = true;
+    if (!k && cpu_has(CPU_ARM_NEON)) {
+        k = base64_kernels_neon();
+    }
+    g_kernels = k;
 }
 
-char *base64_encode(const uint8_t *data, size_t len, size_t *out_len) {
-    if (!data || !out_len) return NULL;
+static const base64_kernels *kernels(void) {
+    pthread_once(&g_kernels_once, kernels_select);
+    return g_kernels;
+}
 
-    // Calculate output length: 4 * ceil(len/3)
-    size_t enc_len = ((len + 2) / 3) * 4;
-    char *enc = malloc(enc_len + 1);
-    if (!enc) return NULL;
+const char *base64_implementation(void) {
+    const base64_kernels *k = kernels();
+    return k ? k->name : "portable";
+}
+
+size_t base64_encoded_len(size_t len) {
+    return ((len + 2) / 3) * 4;
+}
+
+size_t base64_decoded_max_len(size_t len) {
+    return (len / 4) * 3;
+}
+
+// Encode `len` bytes into base64_encoded_len(len) characters (no NUL).
+// Groups are produced last to first: group g reads bytes [3g, 3g+3) and
+// writes [4g, 4g+4), which never clobbers an unread group, so `enc` may
+// start at `data` for in-place expansion. The kernel takes the leading
+// whole blocks, after the scalar loop has done the groups behind them.
+static void encode_groups(const uint8_t *data, size_t len, char *enc) {
+    size_t enc_len = base64_encoded_len(len);
 
-    size_t di = 0, ei = 0;
-    while (di < len) {
-        uint32_t a = di < len ? data[di++] : 0;
-        uint32_t b = di < len ? data[di++] : 0;
-        uint32_t c = di < len ? data[di++] : 0;
+    const base64_kernels *k = kernels();
+    size_t blocks = k && len > k->enc_slack ? (len - k->enc_slack) / k->enc_block : 0;
+    size_t first = blocks ? blocks * k->enc_block / 3 : 0;
+
+    for (size_t g = (len + 2) / 3; g-- > first; ) {
+        size_t di = g * 3, ei = g * 4;
+        uint32_t a = data[di];
+        uint32_t b = di + 1 < len ? data[di + 1] : 0;
+        uint32_t c = di + 2 < len ? data[di + 2] : 0;
         uint32_t triple = (a << 16) | (b << 8) | c;
 
-        enc[ei++] = b64_table[(triple >> 18) & 0x3F];
-        enc[ei++] = b64_table[(triple >> 12) & 0x3F];
-        enc[ei++] = b64_table[(triple >> 6 ) & 0x3F];
-        enc[ei++] = b64_table[ triple         & 0x3F];
+        enc[ei]     = b64_table[(triple >> 18) & 0x3F];
+        enc[ei + 1] = b64_table[(triple >> 12) & 0x3F];
+        enc[ei + 2] = b64_table[(triple >> 6 ) & 0x3F];
+        enc[ei + 3] = b64_table[ triple         & 0x3F];
     }
+    if (blocks) k->encode(data, blocks, enc);
 
     // Add padding if needed
     int mod = len % 3;
@@ -55,26 +107,21 @@ char *base64_encode(const uint8_t *data, size_t len, size_t *out_len) {
         enc[enc_len - 1] = '=';
         if (mod == 1) enc[enc_len - 2] = '=';
     }
-
-    enc[enc_len] = '\0';
-    *out_len = enc_len;
-    return enc;
 }
 
-uint8_t *base64_decode(const char *b64, size_t len, size_t *out_len) {
-    if (!b64 || !out_len || (len % 4) != 0) return NULL;
-    init_b64_rev();
-
-    // Count padding
-    size_t pad = 0;
-    if (len > 0 && b64[len - 1] == '=') pad++;
-    if (len > 1 && b64[len - 2] == '=') pad++;
-
-    size_t dec_len = (len / 4) * 3 - pad;
-    uint8_t *dec = malloc(dec_len);
-    if (!dec) return NULL;
-
+// Decode `len` characters into `dec` (dec_len bytes). Output never passes
+// the input position, so `dec` may start at `b64` for in-place decoding.
+// Returns 0, or -1 on an invalid character.
+static int decode_groups(const char *b64, size_t len, uint8_t *dec, size_t dec_len) {
+    // The kernel stops at the first block it cannot decode, leaving
+    // padding and errors to the scalar loop
     size_t di = 0, bi = 0;
+    const base64_kernels *k = kernels();
+    if (k && len > k->dec_slack) {
+        size_t blocks = k->decode(b64, (len - k->dec_slack) / k->dec_block, dec);
+        bi = blocks * k->dec_block;
+        di = bi / 4 * 3;
+    }
     while (bi < len) {
         uint32_t sa = b64_rev[(unsigned char)b64[bi++]];
         uint32_t sb = b64_rev[(unsigned char)b64[bi++]];
@@ -85,8 +132,7 @@ uint8_t *base64_decode(const char *b64, size_t len, size_t *out_len) {
         if (sa == 0xFF || sb == 0xFF ||
             (b64[bi-2] != '=' && sc == 0xFF) ||
             (b64[bi-1] != '=' && sd == 0xFF)) {
-            free(dec);
-            return NULL;
+            return -1;
         }
 
         uint32_t triple = (sa << 18) | (sb << 12) | ((sc & 0x3F) << 6) | (sd & 0x3F);
@@ -95,7 +141,232 @@ uint8_t *base64_decode(const char *b64, size_t len, size_t *out_len) {
         if (di < dec_len) dec[di++] = (triple >>  8) & 0xFF;
         if (di < dec_len) dec[di++] =  triple        & 0xFF;
     }
+    return 0;
+}
+
+// Decoded size of a padded Base64 string, or -1 if the length is invalid
+static int decoded_len(const char *b64, size_t len, size_t *dec_len) {
+    if ((len % 4) != 0) return -1;
+
+    // Count padding
+    size_t pad = 0;
+    if (len > 0 && b64[len - 1] == '=') pad++;
+    if (len > 1 && b64[len - 2] == '=') pad++;
+
+    *dec_len = (len / 4) * 3 - pad;
+    return 0;
+}
+
+int base64_encode_into(const uint8_t *data, size_t len, char *out, size_t out_cap) {
+    if (!data || !out) return -1;
+
+    size_t enc_len = base64_encoded_len(len);
+    if (len > (size_t)INT_MAX / 4 * 3 || out_cap < enc_len + 1) return -1;
+
+    encode_groups(data, len, out);
+    out[enc_len] = '\0';
+    return (int)enc_len;
+}
+
+char *base64_encode(const uint8_t *data, size_t len, size_t *out_len) {
+    if (!data || !out_len) return NULL;
+
+    // Calculate output length: 4 * ceil(len/3)
+    size_t enc_len = base64_encoded_len(len);
+    char *enc = malloc(enc_len + 1);
+    if (!enc) return NULL;
+
+    encode_groups(data, len, enc);
+    enc[enc_len] = '\0';
+    *out_len = enc_len;
+    return enc;
+}
+
+char *base64_encode_inplace(uint8_t *buf, size_t len, size_t cap, size_t *out_len) {
+    if (!buf || !out_len) return NULL;
+
+    size_t enc_len = base64_encoded_len(len);
+    if (cap < enc_len + 1) return NULL;
+
+    char *enc = (char *)buf;
+    encode_groups(buf, len, enc);
+    enc[enc_len] = '\0';
+    *out_len = enc_len;
+    return enc;
+}
+
+int base64_decode_into(const char *b64, size_t len, uint8_t *out, size_t out_cap) {
+    size_t dec_len;
+    if (!b64 || !out || len > INT_MAX || decoded_len(b64, len, &dec_len) != 0) return -1;
+    if (out_cap < dec_len) return -1;
+
+    if (decode_groups(b64, len, out, dec_len) != 0) return -1;
+    return (int)dec_len;
+}
+
+uint8_t *base64_decode(const char *b64, size_t len, size_t *out_len) {
+    size_t dec_len;
+    if (!b64 || !out_len || decoded_len(b64, len, &dec_len) != 0) return NULL;
+
+    uint8_t *dec = malloc(dec_len);
+    if (!dec) return NULL;
+
+    if (decode_groups(b64, len, dec, dec_len) != 0) {
+        free(dec);
+        return NULL;
+    }
+
+    *out_len = dec_len;
+    return dec;
+}
+
+uint8_t *base64_decode_inplace(char *b64, size_t len, size_t *out_len) {
+    size_t dec_len;
+    if (!b64 || !out_len || decoded_len(b64, len, &dec_len) != 0) return NULL;
+
+    uint8_t *dec = (uint8_t *)b64;
+    if (decode_groups(b64, len, dec, dec_len) != 0) return NULL;
 
     *out_len = dec_len;
     return dec;
 }
+
+/*=============================================================================
+  Streaming
+=============================================================================*/
+
+// Decode whole quanta from the front of `src` (n a multiple of 4) until
+// one holds anything but alphabet characters. Returns characters consumed.
+static size_t decode_quanta(const char *src, size_t n, uint8_t *dst) {
+    size_t di = 0, bi = 0;
+    const base64_kernels *k = kernels();
+    if (k && n > k->dec_slack) {
+        size_t blocks = k->decode(src, (n - k->dec_slack) / k->dec_block, dst);
+        bi = blocks * k->dec_block;
+        di = bi / 4 * 3;
+    }
+    for (; bi < n; bi += 4, di += 3) {
+        uint32_t sa = b64_rev[(unsigned char)src[bi]];
+        uint32_t sb = b64_rev[(unsigned char)src[bi + 1]];
+        uint32_t sc = b64_rev[(unsigned char)src[bi + 2]];
+        uint32_t sd = b64_rev[(unsigned char)src[bi + 3]];
+        if ((sa | sb | sc | sd) > 0x3F) break;
+
+        uint32_t triple = (sa << 18) | (sb << 12) | (sc << 6) | sd;
+        dst[di]     = (triple >> 16) & 0xFF;
+        dst[di + 1] = (triple >>  8) & 0xFF;
+        dst[di + 2] =  triple        & 0xFF;
+    }
+    return bi;
+}
+
+static int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void base64_encode_stream_init(base64_encode_stream *st) {
+    if (st) memset(st, 0, sizeof(*st));
+}
+
+int base64_encode_stream_update(base64_encode_stream *st,
+                                const uint8_t *data, size_t len,
+                                char *out, size_t out_cap) {
+    if (!st || (!data && len) || !out || st->part_len > 2) return -1;
+    if (len > (size_t)INT_MAX / 4 * 3) return -1;
+
+    size_t total = st->part_len + len;
+    if (out_cap < total / 3 * 4) return -1;
+
+    size_t i = 0, o = 0;
+    if (st->part_len && total >= 3) {
+        while (st->part_len < 3) st->part[st->part_len++] = data[i++];
+        encode_groups(st->part, 3, out);
+        st->part_len = 0;
+        o = 4;
+    }
+
+    size_t whole = (len - i) / 3 * 3;
+    if (whole) {
+        encode_groups(data + i, whole, out + o);
+        i += whole;
+        o += whole / 3 * 4;
+    }
+
+    while (i < len) st->part[st->part_len++] = data[i++];
+    return (int)o;
+}
+
+int base64_encode_stream_final(base64_encode_stream *st, char *out, size_t out_cap) {
+    if (!st || !out || out_cap < 4 || st->part_len > 2) return -1;
+
+    int n = st->part_len ? 4 : 0;
+    if (n) encode_groups(st->part, st->part_len, out);
+    memset(st, 0, sizeof(*st));
+    return n;
+}
+
+void base64_decode_stream_init(base64_decode_stream *st) {
+    if (st) memset(st, 0, sizeof(*st));
+}
+
+int base64_decode_stream_update(base64_decode_stream *st,
+                                const char *b64, size_t len,
+                                uint8_t *out, size_t out_cap) {
+    if (!st || st->failed) return -1;
+    if ((!b64 && len) || !out || len > INT_MAX ||
+        out_cap < base64_decoded_max_len(st->quad_len + len)) {
+        goto fail;
+    }
+
+    size_t i = 0, o = 0;
+    while (i < len) {
+        // Fast path: whole quanta straight from the input, up to the first
+        // whitespace, padding or invalid character
+        if (st->quad_len == 0 && !st->done) {
+            size_t n = decode_quanta(b64 + i, (len - i) / 4 * 4, out + o);
+            i += n;
+            o += n / 4 * 3;
+            if (i == len) break;
+        }
+
+        // Slow path: one character at a time until the quantum completes
+        char c = b64[i++];
+        if (is_space(c)) continue;
+        if (st->done) goto fail;
+
+        if (c == '=') {
+            if (st->quad_len < 2) goto fail;
+        } else if (b64_rev[(unsigned char)c] == 0xFF ||
+                   (st->quad_len == 3 && st->quad[2] == '=')) {
+            goto fail;
+        }
+        st->quad[st->quad_len++] = c;
+        if (st->quad_len < 4) continue;
+
+        uint32_t sa = b64_rev[(unsigned char)st->quad[0]];
+        uint32_t sb = b64_rev[(unsigned char)st->quad[1]];
+        uint32_t sc = b64_rev[(unsigned char)st->quad[2]];
+        uint32_t sd = b64_rev[(unsigned char)st->quad[3]];
+        uint32_t triple = (sa << 18) | (sb << 12) | ((sc & 0x3F) << 6) | (sd & 0x3F);
+
+        out[o++] = (triple >> 16) & 0xFF;
+        if (st->quad[2] != '=') out[o++] = (triple >> 8) & 0xFF;
+        if (st->quad[3] != '=') out[o++] = triple & 0xFF;
+        st->done = st->quad[3] == '=';
+        st->quad_len = 0;
+    }
+    return (int)o;
+
+fail:
+    memset(st, 0, sizeof(*st));
+    st->failed = 1;
+    return -1;
+}
+
+int base64_decode_stream_final(base64_decode_stream *st) {
+    if (!st) return -1;
+
+    int rc = st->failed || st->quad_len ? -1 : 0;
+    memset(st, 0, sizeof(*st));
+    return rc;
+}
@@ -1,6 +1,12 @@
 // native/src/utils/base64.h
 // Base64 encoding and decoding interface for OpenLockr.
-// Provides malloc()-allocated output; caller is responsible for free().
+// Provides malloc()-allocated output (caller is responsible for free()),
+// `_into` variants that write to a caller buffer, or in-place variants that
+// convert within a single caller-owned buffer. All functions are
+// thread-safe; only the malloc() variants allocate.
+// Streaming encoders and decoders take input in arbitrary chunks.
+// Long inputs are converted by SSSE3/AVX2 or NEON kernels when the CPU has
+// them; results are identical to the scalar code.
 
 #ifndef OPENLOCKR_BASE64_H
 #define OPENLOCKR_BASE64_H
@@ -12,6 +18,37 @@
 extern "C" {
 #endif
 
+/**
+ * Name of the SIMD kernel selected for this CPU ("avx2", "ssse3", "neon" or
+ * "portable"). Triggers CPU detection on first call.
+ */
+const char *base64_implementation(void);
+
+/**
+ * Length of the Base64 encoding of `len` bytes (excluding NUL).
+ */
+size_t base64_encoded_len(size_t len);
+
+/**
+ * Upper bound on the decoded length of `len` Base64 characters; the exact
+ * length is up to 2 bytes less, depending on padding.
+ */
+size_t base64_decoded_max_len(size_t len);
+
+/**
+ * Encode binary data to Base64 into a caller buffer, with a terminating NUL.
+ *
+ * @param data      Pointer to input binary data.
+ * @param len       Length in bytes of input data.
+ * @param out       Receives the string; must not overlap `data`
+ *                  (see base64_encode_inplace()).
+ * @param out_cap   Size of `out`, at least base64_encoded_len(len) + 1.
+ * @return          Characters written (excluding NUL), or -1 on error
+ *                  (invalid args, `out_cap` too small, or output too long
+ *                  for an int).
+ */
+int base64_encode_into(const uint8_t *data, size_t len, char *out, size_t out_cap);
+
 /**
  * Encode binary data to a Base64 null-terminated string.
  *
@@ -40,6 +77,140 @@ char *base64_encode(const uint8_t *data, size_t len, size_t *out_len);
  */
 uint8_t *base64_decode(const char *b64, size_t len, size_t *out_len);
 
+/**
+ * Decode a Base64 string into a caller buffer.
+ *
+ * @param b64       Pointer to Base64 string (may include padding '=').
+ * @param len       Length in bytes of the Base64 string.
+ * @param out       Receives the decoded bytes; may start at `b64` but must
+ *                  not otherwise overlap it.
+ * @param out_cap   Size of `out`; base64_decoded_max_len(len) always
+ *                  suffices, the exact decoded length is enough.
+ * @return          Bytes written, or -1 on error (invalid args, bad input,
+ *                  or `out_cap` too small); `out` is then unspecified.
+ */
+int base64_decode_into(const char *b64, size_t len, uint8_t *out, size_t out_cap);
+
+/**
+ * Encode binary data to Base64 within the same buffer.
+ *
+ * The first `len` bytes of `buf` are replaced by their Base64 encoding and a
+ * terminating NUL, so `cap` must be at least base64_encoded_len(len) + 1.
+ *
+ * @param buf       Buffer holding the input; receives the encoded string.
+ * @param len       Length in bytes of input data.
+ * @param cap       Total size of `buf` in bytes.
+ * @param out_len   Pointer to size_t to receive length of output (excluding NUL).
+ * @return          `buf` as a NUL-terminated string, or NULL on error
+ *                  (invalid args or `cap` too small).
+ */
+char *base64_encode_inplace(uint8_t *buf, size_t len, size_t cap, size_t *out_len);
+
+/**
+ * Decode a Base64 string within the same buffer.
+ *
+ * The decoded bytes are written from the start of `b64`; they are never
+ * longer than the input, so no extra space is needed.
+ *
+ * @param b64       Writable Base64 string (may include padding '=').
+ * @param len       Length in bytes of the Base64 string.
+ * @param out_len   Pointer to size_t to receive length of decoded data.
+ * @return          `b64` reinterpreted as the decoded bytes, or NULL on error
+ *                  (invalid args or bad input; the buffer is then unspecified).
+ */
+uint8_t *base64_decode_inplace(char *b64, size_t len, size_t *out_len);
+
+/**
+ * Incremental Base64 encoder, for data that arrives in chunks.
+ *
+ * The struct is public so it can live on the caller's stack; its fields are
+ * private. Concatenating the output of an init/update.../final sequence
+ * gives the same string as base64_encode() on the whole input.
+ */
+typedef struct {
+    uint8_t part[3];       // bytes of the current incomplete group
+    size_t  part_len;
+} base64_encode_stream;
+
+/**
+ * Incremental Base64 decoder, for text that arrives in chunks.
+ *
+ * Chunks may split anywhere, including inside a 4-character quantum.
+ * Spaces, tabs and line breaks (CR, LF) are skipped wherever they appear;
+ * runs of whole quanta between them go through the SIMD kernels. Padding
+ * must be complete, and after a padded quantum only whitespace may follow.
+ */
+typedef struct {
+    char   quad[4];        // characters of the current incomplete quantum
+    size_t quad_len;
+    int    done;           // padding seen, only whitespace may follow
+    int    failed;
+} base64_decode_stream;
+
+/**
+ * Start an incremental encode.
+ */
+void base64_encode_stream_init(base64_encode_stream *st);
+
+/**
+ * Encode the next `len` bytes. Complete 3-byte groups are written out; up to
+ * 2 bytes are held back until the next call or base64_encode_stream_final().
+ *
+ * @param st        Stream state.
+ * @param data      Input bytes (may be NULL if len is 0).
+ * @param len       Length in bytes of the input.
+ * @param out       Receives the characters (no NUL); must not overlap `data`.
+ * @param out_cap   Size of `out`; base64_encoded_len(len) always suffices.
+ * @return          Characters written, or -1 on error (invalid args,
+ *                  `out_cap` too small or `len` too long for an int).
+ */
+int base64_encode_stream_update(base64_encode_stream *st,
+                                const uint8_t *data, size_t len,
+                                char *out, size_t out_cap);
+
+/**
+ * Finish the encode: write the held-back bytes with padding, then wipe the
+ * state.
+ *
+ * @param st        Stream state.
+ * @param out       Receives the last quantum (no NUL).
+ * @param out_cap   Size of `out`, at least 4.
+ * @return          Characters written (0 or 4), or -1 on error.
+ */
+int base64_encode_stream_final(base64_encode_stream *st, char *out, size_t out_cap);
+
+/**
+ * Start an incremental decode.
+ */
+void base64_decode_stream_init(base64_decode_stream *st);
+
+/**
+ * Decode the next `len` characters. Complete quanta are written out; an
+ * incomplete one is held until the next call. Once a call fails, every
+ * later call fails too.
+ *
+ * @param st        Stream state.
+ * @param b64       Input characters (may be NULL if len is 0).
+ * @param len       Length in bytes of the input.
+ * @param out       Receives the decoded bytes; must not overlap `b64`.
+ * @param out_cap   Size of `out`; base64_decoded_max_len(len + 3) always
+ *                  suffices.
+ * @return          Bytes written, or -1 on error (invalid args, bad input,
+ *                  `out_cap` too small or `len` too long for an int).
+ */
+int base64_decode_stream_update(base64_decode_stream *st,
+                                const char *b64, size_t len,
+                                uint8_t *out, size_t out_cap);
+
+/**
+ * Finish the decode and wipe the state.
+ *
+ * @param st        Stream state.
+ * @return          0 if the input ended on a quantum boundary and no call
+ *                  failed, or -1 otherwise.
+ */
+int base64_decode_stream_final(base64_decode_stream *st);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,115 @@
+// native/src/utils/base64_avx2.c
+// Base64 kernel using AVX2 (x86_64), 24 bytes <-> 32 characters per block.
+//
+// The SSSE3 algorithm on two 128-bit lanes: each lane encodes 12 bytes or
+// decodes 16 characters, and decoded lanes are joined with one cross-lane
+// permute. Built with -mavx2 (see CMakeLists.txt).
+
+#include "base64_impl.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#define LOADU128(p)  _mm_loadu_si128((const __m128i *)(p))
+#define LOADU(p)     _mm256_loadu_si256((const __m256i *)(p))
+#define STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+
+// 12 bytes per lane (of 16 loaded) -> 16 six-bit indexes per lane
+static inline __m256i enc_reshuffle(__m256i in) {
+    in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                                  7, 6, 8, 7, 10, 9, 11, 10,
+                                                  1, 0, 2, 1, 4, 3, 5, 4,
+                                                  7, 6, 8, 7, 10, 9, 11, 10));
+    __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(t1, t3);
+}
+
+// Indexes 0..63 -> alphabet characters
+static inline __m256i enc_translate(__m256i idx) {
+    __m256i r = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+    __m256i lt26 = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+    r = _mm256_or_si256(r, _mm256_and_si256(lt26, _mm256_set1_epi8(13)));
+    const __m256i offset = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                            '/' - 63, 'A', 0, 0,
+                                            'a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                            '/' - 63, 'A', 0, 0);
+    return _mm256_add_epi8(idx, _mm256_shuffle_epi8(offset, r));
+}
+
+static void encode_avx2(const uint8_t *src, size_t nblocks, char *dst) {
+    for (size_t i = nblocks; i-- > 0; ) {
+        const uint8_t *p = src + i * 24;
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(LOADU128(p)),
+                                             LOADU128(p + 12), 1);
+        STOREU(dst + i * 32, enc_translate(enc_reshuffle(in)));
+    }
+}
+
+static size_t decode_avx2(const char *src, size_t nblocks, uint8_t *dst) {
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+
+    size_t i;
+    for (i = 0; i < nblocks; i++) {
+        __m256i str = LOADU(src + i * 32);
+
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        __m256i ok = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256());
+        if (_mm256_movemask_epi8(ok) != -1) break;
+
+        __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+
+        // 12 bytes at the bottom of each lane, then both lanes side by side
+        __m256i ab_bc = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+        __m256i out = _mm256_madd_epi16(ab_bc, _mm256_set1_epi32(0x00011000));
+        out = _mm256_shuffle_epi8(out, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                                        8, 14, 13, 12, -1, -1, -1, -1,
+                                                        2, 1, 0, 6, 5, 4, 10, 9,
+                                                        8, 14, 13, 12, -1, -1, -1, -1));
+        out = _mm256_permutevar8x32_epi32(out, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        STOREU(dst + i * 24, out);
+    }
+    return i;
+}
+
+static const base64_kernels k_avx2 = {
+    "avx2",
+    24, 4, encode_avx2,
+    32, 16, decode_avx2,
+};
+
+const base64_kernels *base64_kernels_avx2(void) {
+    return &k_avx2;
+}
+
+#else
+
+const base64_kernels *base64_kernels_avx2(void) {
+    return NULL;
+}
+
+#endif
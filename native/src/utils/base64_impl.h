@@ -0,0 +1,50 @@
+// native/src/utils/base64_impl.h
+// Internal Base64 kernel interface shared by base64.c and the per-ISA
+// kernels. Not part of the public API.
+//
+// Kernels only handle whole blocks from the front of the data; the tail,
+// padding and any block that fails vector validation are left to the
+// scalar code in base64.c.
+
+#ifndef OPENLOCKR_BASE64_IMPL_H
+#define OPENLOCKR_BASE64_IMPL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct {
+    const char *name;
+
+    // Encoding: `enc_block` input bytes become enc_block * 4 / 3 characters.
+    // A block may read up to `enc_slack` bytes past its end, so the caller
+    // keeps that many input bytes after the last block.
+    size_t enc_block;
+    size_t enc_slack;
+
+    // Encode `nblocks` blocks from src to dst, last block first, so dst may
+    // start at src for in-place expansion.
+    void (*encode)(const uint8_t *src, size_t nblocks, char *dst);
+
+    // Decoding: `dec_block` characters become dec_block * 3 / 4 bytes. A
+    // block may write up to `dec_slack` characters' worth of output past
+    // its end, so the caller keeps that many input characters after the
+    // last block.
+    size_t dec_block;
+    size_t dec_slack;
+
+    // Decode up to `nblocks` blocks from src to dst, first block first, so
+    // dst may start at src. Stops before the first block holding anything
+    // but the 64 alphabet characters (padding included).
+    // Returns the number of blocks decoded.
+    size_t (*decode)(const char *src, size_t nblocks, uint8_t *dst);
+} base64_kernels;
+
+/**
+ * Kernel tables. The getters return NULL when the kernel was not compiled
+ * for this ABI; callers must still check CPU features before use.
+ */
+const base64_kernels *base64_kernels_ssse3(void);   // 12 bytes / 16 chars per block
+const base64_kernels *base64_kernels_avx2(void);    // 24 bytes / 32 chars per block
+const base64_kernels *base64_kernels_neon(void);    // 48 bytes / 64 chars per block
+
+#endif // OPENLOCKR_BASE64_IMPL_H
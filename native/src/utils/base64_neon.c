@@ -0,0 +1,128 @@
+// native/src/utils/base64_neon.c
+// Base64 kernel using NEON / Advanced SIMD, 48 bytes <-> 64 characters per
+// block (armeabi-v7a and arm64).
+//
+// VLD3/VST4 and VLD4/VST3 de-interleave the 3-byte groups and 4-character
+// quanta, so the bit packing is plain shifts. Characters are mapped and
+// validated with the same range tables as the SSSE3 kernel. Built with
+// -mfpu=neon on 32-bit ARM (see CMakeLists.txt); only reached after
+// cpu_features() reports NEON.
+
+#include "base64_impl.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+#include <arm_neon.h>
+
+// 16-entry table lookup; indexes past 15 give 0
+static inline uint8x16_t lookup16(uint8x16_t table, uint8x16_t idx) {
+#if defined(__aarch64__)
+    return vqtbl1q_u8(table, idx);
+#else
+    uint8x8x2_t t = { { vget_low_u8(table), vget_high_u8(table) } };
+    return vcombine_u8(vtbl2_u8(t, vget_low_u8(idx)), vtbl2_u8(t, vget_high_u8(idx)));
+#endif
+}
+
+static inline int any_set(uint8x16_t v) {
+#if defined(__aarch64__)
+    return vmaxvq_u8(v) != 0;
+#else
+    uint32x2_t t = vreinterpret_u32_u8(vorr_u8(vget_low_u8(v), vget_high_u8(v)));
+    return (vget_lane_u32(t, 0) | vget_lane_u32(t, 1)) != 0;
+#endif
+}
+
+static const uint8_t ENC_OFFSET[16] = {
+    (uint8_t)('a' - 26), (uint8_t)('0' - 52), (uint8_t)('0' - 52), (uint8_t)('0' - 52),
+    (uint8_t)('0' - 52), (uint8_t)('0' - 52), (uint8_t)('0' - 52), (uint8_t)('0' - 52),
+    (uint8_t)('0' - 52), (uint8_t)('0' - 52), (uint8_t)('0' - 52), (uint8_t)('+' - 62),
+    (uint8_t)('/' - 63), 'A', 0, 0,
+};
+static const uint8_t DEC_LUT_LO[16] = {
+    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+};
+static const uint8_t DEC_LUT_HI[16] = {
+    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+};
+static const uint8_t DEC_LUT_ROLL[16] = {
+    0, 16, 19, 4, (uint8_t)-65, (uint8_t)-65, (uint8_t)-71, (uint8_t)-71,
+    0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+// Indexes 0..63 -> alphabet characters
+static inline uint8x16_t enc_translate(uint8x16_t idx, uint8x16_t offset) {
+    uint8x16_t r = vqsubq_u8(idx, vdupq_n_u8(51));
+    uint8x16_t lt26 = vcltq_u8(idx, vdupq_n_u8(26));
+    r = vorrq_u8(r, vandq_u8(lt26, vdupq_n_u8(13)));
+    return vaddq_u8(idx, lookup16(offset, r));
+}
+
+static void encode_neon(const uint8_t *src, size_t nblocks, char *dst) {
+    const uint8x16_t offset = vld1q_u8(ENC_OFFSET);
+    const uint8x16_t m3f = vdupq_n_u8(0x3F);
+
+    for (size_t i = nblocks; i-- > 0; ) {
+        uint8x16x3_t in = vld3q_u8(src + i * 48);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), m3f);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), m3f);
+        out.val[3] = vandq_u8(in.val[2], m3f);
+        for (int j = 0; j < 4; j++) out.val[j] = enc_translate(out.val[j], offset);
+        vst4q_u8((uint8_t *)dst + i * 64, out);
+    }
+}
+
+static size_t decode_neon(const char *src, size_t nblocks, uint8_t *dst) {
+    const uint8x16_t lut_lo = vld1q_u8(DEC_LUT_LO);
+    const uint8x16_t lut_hi = vld1q_u8(DEC_LUT_HI);
+    const uint8x16_t lut_roll = vld1q_u8(DEC_LUT_ROLL);
+    const uint8x16_t m0f = vdupq_n_u8(0x0F);
+    const uint8x16_t c2f = vdupq_n_u8(0x2F);
+
+    size_t i;
+    for (i = 0; i < nblocks; i++) {
+        uint8x16x4_t str = vld4q_u8((const uint8_t *)src + i * 64);
+
+        // Validate and map all four character vectors
+        uint8x16_t bad = vdupq_n_u8(0);
+        for (int j = 0; j < 4; j++) {
+            uint8x16_t hi_nibbles = vshrq_n_u8(str.val[j], 4);
+            uint8x16_t lo = lookup16(lut_lo, vandq_u8(str.val[j], m0f));
+            uint8x16_t hi = lookup16(lut_hi, hi_nibbles);
+            bad = vorrq_u8(bad, vandq_u8(lo, hi));
+
+            uint8x16_t eq_2f = vceqq_u8(str.val[j], c2f);
+            str.val[j] = vaddq_u8(str.val[j], lookup16(lut_roll, vaddq_u8(eq_2f, hi_nibbles)));
+        }
+        if (any_set(bad)) break;
+
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(str.val[0], 2), vshrq_n_u8(str.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(str.val[1], 4), vshrq_n_u8(str.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(str.val[2], 6), str.val[3]);
+        vst3q_u8(dst + i * 48, out);
+    }
+    return i;
+}
+
+static const base64_kernels k_neon = {
+    "neon",
+    48, 0, encode_neon,
+    64, 0, decode_neon,
+};
+
+const base64_kernels *base64_kernels_neon(void) {
+    return &k_neon;
+}
+
+#else
+
+const base64_kernels *base64_kernels_neon(void) {
+    return NULL;
+}
+
+#endif
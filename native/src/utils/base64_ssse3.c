@@ -0,0 +1,104 @@
+// native/src/utils/base64_ssse3.c
+// Base64 kernel using SSSE3 (x86 / x86_64), 12 bytes <-> 16 characters
+// per block.
+//
+// Encoding spreads each 3-byte group over four 6-bit lanes with PSHUFB and
+// two multiplies, then maps indexes to ASCII with a 16-entry offset table.
+// Decoding classifies every character by its high and low nibble (a
+// character is valid when the two class masks share no bit), adds a
+// per-range offset and packs the 6-bit values back with multiply-adds.
+// Built with -mssse3 (see CMakeLists.txt).
+
+#include "base64_impl.h"
+
+#if defined(__SSSE3__)
+
+#include <tmmintrin.h>
+
+#define LOADU(p)     _mm_loadu_si128((const __m128i *)(p))
+#define STOREU(p, v) _mm_storeu_si128((__m128i *)(p), (v))
+
+// 12 bytes (of 16 loaded) -> 16 six-bit indexes, one per byte
+static inline __m128i enc_reshuffle(__m128i in) {
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                            7, 6, 8, 7, 10, 9, 11, 10));
+    __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+// Indexes 0..63 -> alphabet characters
+static inline __m128i enc_translate(__m128i idx) {
+    // Range number: 13 for A-Z, 0 for a-z, 1..10 for digits, 11 '+', 12 '/'
+    __m128i r = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+    __m128i lt26 = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+    r = _mm_or_si128(r, _mm_and_si128(lt26, _mm_set1_epi8(13)));
+    const __m128i offset = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+                                         '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                         '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                         '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(idx, _mm_shuffle_epi8(offset, r));
+}
+
+static void encode_ssse3(const uint8_t *src, size_t nblocks, char *dst) {
+    for (size_t i = nblocks; i-- > 0; ) {
+        __m128i in = LOADU(src + i * 12);
+        STOREU(dst + i * 16, enc_translate(enc_reshuffle(in)));
+    }
+}
+
+static size_t decode_ssse3(const char *src, size_t nblocks, uint8_t *dst) {
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2F);
+
+    size_t i;
+    for (i = 0; i < nblocks; i++) {
+        __m128i str = LOADU(src + i * 16);
+
+        // Validate: every character's nibble classes must be disjoint
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        __m128i bad = _mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128());
+        if (_mm_movemask_epi8(bad) != 0xFFFF) break;
+
+        // Characters -> 6-bit values; '/' shares its high nibble with '+'
+        __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+        str = _mm_add_epi8(str, roll);
+
+        // Pack 4 x 6 bits -> 3 bytes per 32-bit lane, then drop the gaps
+        __m128i ab_bc = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+        __m128i out = _mm_madd_epi16(ab_bc, _mm_set1_epi32(0x00011000));
+        out = _mm_shuffle_epi8(out, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                                  8, 14, 13, 12, -1, -1, -1, -1));
+        STOREU(dst + i * 12, out);
+    }
+    return i;
+}
+
+static const base64_kernels k_ssse3 = {
+    "ssse3",
+    12, 4, encode_ssse3,
+    16, 8, decode_ssse3,
+};
+
+const base64_kernels *base64_kernels_ssse3(void) {
+    return &k_ssse3;
+}
+
+#else
+
+const base64_kernels *base64_kernels_ssse3(void) {
+    return NULL;
+}
+
+#endif
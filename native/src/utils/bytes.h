@@ -0,0 +1,72 @@
+// native/src/utils/bytes.h
+// Byte-order load/store helpers and secure wiping, shared by the crypto
+// primitives and the core. Not part of the public API.
+//
+// Everything is static inline: loads and stores are assembled byte by byte,
+// so they work at any alignment and on either host byte order, and compile
+// to a single move where the target allows it.
+
+#ifndef OPENLOCKR_BYTES_H
+#define OPENLOCKR_BYTES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Zero `n` bytes at `p` through a volatile pointer, so the stores are kept
+ * even when the buffer is never read again (unlike a plain memset()).
+ */
+static inline void secure_wipe(void *p, size_t n) {
+    volatile uint8_t *v = p;
+    while (n--) *v++ = 0;
+}
+
+/*=============================================================================
+  Little-endian
+=============================================================================*/
+
+static inline uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static inline void store32_le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint64_t load64_le(const uint8_t *p) {
+    return (uint64_t)load32_le(p) | (uint64_t)load32_le(p + 4) << 32;
+}
+
+static inline void store64_le(uint8_t *p, uint64_t v) {
+    store32_le(p, (uint32_t)v);
+    store32_le(p + 4, (uint32_t)(v >> 32));
+}
+
+/*=============================================================================
+  Big-endian
+=============================================================================*/
+
+static inline uint32_t load32_be(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+}
+
+static inline void store32_be(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline uint64_t load64_be(const uint8_t *p) {
+    return (uint64_t)load32_be(p) << 32 | (uint64_t)load32_be(p + 4);
+}
+
+static inline void store64_be(uint8_t *p, uint64_t v) {
+    store32_be(p, (uint32_t)(v >> 32));
+    store32_be(p + 4, (uint32_t)v);
+}
+
+#endif // OPENLOCKR_BYTES_H
@@ -0,0 +1,100 @@
+// native/src/utils/cpu.c
+// CPU feature probing: CPUID on x86/x86_64, auxiliary vector on ARM.
+
+#include "cpu.h"
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(__aarch64__) || defined(__arm__)
+#include <sys/auxv.h>
+#endif
+
+// HWCAP bits, in case the NDK / libc headers predate them
+#if defined(__aarch64__)
+#ifndef HWCAP_ASIMD
+#define HWCAP_ASIMD   (1 << 1)
+#endif
+#ifndef HWCAP_AES
+#define HWCAP_AES     (1 << 3)
+#endif
+#ifndef HWCAP_PMULL
+#define HWCAP_PMULL   (1 << 4)
+#endif
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2    (1 << 6)
+#endif
+#elif defined(__arm__)
+#ifndef HWCAP_NEON
+#define HWCAP_NEON    (1 << 12)
+#endif
+#ifndef HWCAP2_AES
+#define HWCAP2_AES    (1 << 0)
+#endif
+#ifndef HWCAP2_PMULL
+#define HWCAP2_PMULL  (1 << 1)
+#endif
+#ifndef HWCAP2_SHA2
+#define HWCAP2_SHA2   (1 << 3)
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+// XCR0: which register state the OS saves on context switch
+static uint64_t xgetbv0(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+}
+#endif
+
+static pthread_once_t g_cpu_once = PTHREAD_ONCE_INIT;
+static uint32_t       g_cpu_features = 0;
+static uint32_t       g_cpu_mask = ~0u;      // see cpu_features_restrict()
+
+static void cpu_probe(void) {
+    uint32_t f = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        if (ecx & (1u << 9))  f |= CPU_X86_SSSE3;
+        if (ecx & (1u << 25)) f |= CPU_X86_AESNI;
+        if (ecx & (1u << 1))  f |= CPU_X86_PCLMUL;
+        if (ecx & (1u << 19)) f |= CPU_X86_SSE41;
+        if (edx & (1u << 26)) f |= CPU_X86_SSE2;
+
+        // AVX2 also needs the OS to preserve XMM and YMM registers
+        int os_ymm = (ecx & (1u << 27)) && (xgetbv0() & 0x6) == 0x6;
+        if (__get_cpuid_max(0, NULL) >= 7) {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            if (os_ymm && (ebx & (1u << 5))) f |= CPU_X86_AVX2;
+            if (ebx & (1u << 29)) f |= CPU_X86_SHA;
+        }
+    }
+#elif defined(__aarch64__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    if (hwcap & HWCAP_ASIMD) f |= CPU_ARM_NEON;
+    if (hwcap & HWCAP_AES)   f |= CPU_ARM_AES;
+    if (hwcap & HWCAP_PMULL) f |= CPU_ARM_PMULL;
+    if (hwcap & HWCAP_SHA2)  f |= CPU_ARM_SHA2;
+#elif defined(__arm__)
+    unsigned long hwcap  = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+    if (hwcap & HWCAP_NEON)    f |= CPU_ARM_NEON;
+    if (hwcap2 & HWCAP2_AES)   f |= CPU_ARM_AES;
+    if (hwcap2 & HWCAP2_PMULL) f |= CPU_ARM_PMULL;
+    if (hwcap2 & HWCAP2_SHA2)  f |= CPU_ARM_SHA2;
+#endif
+
+    g_cpu_features = f;
+}
+
+uint32_t cpu_features(void) {
+    pthread_once(&g_cpu_once, cpu_probe);
+    return g_cpu_features & g_cpu_mask;
+}
+
+void cpu_features_restrict(uint32_t mask) {
+    g_cpu_mask &= mask;
+}
@@ -0,0 +1,55 @@
+// native/src/utils/cpu.h
+// Runtime CPU feature detection for OpenLockr.
+// Features are probed once per process; later calls return the cached set.
+
+#ifndef OPENLOCKR_CPU_H
+#define OPENLOCKR_CPU_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*=============================================================================
+  Feature bits
+=============================================================================*/
+#define CPU_X86_SSSE3     (1u << 0)   ///< x86 SSSE3 (pshufb)
+#define CPU_X86_AESNI     (1u << 1)   ///< x86 AES-NI
+#define CPU_X86_PCLMUL    (1u << 2)   ///< x86 carry-less multiply
+#define CPU_X86_SSE2      (1u << 3)   ///< x86 SSE2
+#define CPU_X86_AVX2      (1u << 4)   ///< x86 AVX2, with OS support for YMM state
+#define CPU_X86_SSE41     (1u << 5)   ///< x86 SSE4.1
+#define CPU_X86_SHA       (1u << 6)   ///< x86 SHA extensions (SHA256RNDS2, ...)
+
+#define CPU_ARM_NEON      (1u << 16)  ///< ARM Advanced SIMD
+#define CPU_ARM_AES       (1u << 17)  ///< ARMv8 Crypto Extensions: AESE/AESD
+#define CPU_ARM_PMULL     (1u << 18)  ///< ARMv8 Crypto Extensions: 64-bit PMULL
+#define CPU_ARM_SHA2      (1u << 19)  ///< ARMv8 Crypto Extensions: SHA256H/SHA256SU*
+
+/**
+ * Return the set of CPU_* features available on this device.
+ * The first call probes the CPU; it is safe to call from any thread.
+ */
+uint32_t cpu_features(void);
+
+/**
+ * Hide every feature not in `mask` from cpu_features() and cpu_has(), so
+ * kernels picked afterwards fall back to what the mask leaves. Each kernel
+ * table is picked once per process, so this only has an effect before the
+ * first crypto call; the native tests use it to run every kernel.
+ */
+void cpu_features_restrict(uint32_t mask);
+
+/**
+ * Test whether every feature in `mask` is available.
+ */
+static inline int cpu_has(uint32_t mask) {
+    return (cpu_features() & mask) == mask;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_CPU_H
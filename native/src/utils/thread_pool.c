@@ -0,0 +1,130 @@
+// native/src/utils/thread_pool.c
+// Worker pool behind thread_pool_run(). One loop is posted at a time; the
+// workers and the caller claim item indexes under a mutex, which is cheap
+// next to the 64 KiB chunks the pool is used for.
+
+#include "thread_pool.h"
+#include <pthread.h>
+#include <unistd.h>
+
+static pthread_once_t g_pool_once = PTHREAD_ONCE_INIT;
+
+static struct {
+    pthread_mutex_t lock;       // guards the fields below
+    pthread_cond_t  posted;     // workers: a loop has items to claim
+    pthread_cond_t  drained;    // caller: every claimed item has finished
+    pthread_mutex_t busy;       // held by the thread whose loop is posted
+    size_t          workers;    // worker threads running (0 after fork)
+
+    // Posted loop; fn == NULL when idle
+    thread_pool_fn  fn;
+    void           *arg;
+    size_t          count;
+    size_t          next;       // next unclaimed index
+    size_t          running;    // claimed, not yet finished
+    int             rc;         // first failure
+} g_pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER, 0, NULL, NULL, 0, 0, 0, 0,
+};
+
+// Claim and run items of the posted loop until none are left.
+// Called and returns with g_pool.lock held.
+static void pool_drain(void) {
+    while (g_pool.fn && g_pool.next < g_pool.count && g_pool.rc == 0) {
+        thread_pool_fn fn = g_pool.fn;
+        void *arg = g_pool.arg;
+        size_t i = g_pool.next++;
+        g_pool.running++;
+        pthread_mutex_unlock(&g_pool.lock);
+
+        int rc = fn(arg, i);
+
+        pthread_mutex_lock(&g_pool.lock);
+        if (rc != 0 && g_pool.rc == 0) g_pool.rc = rc;
+        if (--g_pool.running == 0) pthread_cond_broadcast(&g_pool.drained);
+    }
+}
+
+static void *pool_worker(void *unused) {
+    (void)unused;
+    pthread_mutex_lock(&g_pool.lock);
+    for (;;) {
+        while (!g_pool.fn || g_pool.next >= g_pool.count || g_pool.rc != 0) {
+            pthread_cond_wait(&g_pool.posted, &g_pool.lock);
+        }
+        pool_drain();
+    }
+    return NULL;
+}
+
+// The child of a fork() has none of the workers; run everything inline there.
+// Locks may have been held by threads that no longer exist, so start afresh.
+static void pool_after_fork(void) {
+    pthread_mutex_init(&g_pool.lock, NULL);
+    pthread_mutex_init(&g_pool.busy, NULL);
+    pthread_cond_init(&g_pool.posted, NULL);
+    pthread_cond_init(&g_pool.drained, NULL);
+    g_pool.workers = 0;
+    g_pool.fn = NULL;
+}
+
+static void pool_start(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t want = cpus > 1 ? (size_t)cpus - 1 : 0;
+    if (want > THREAD_POOL_MAX_WORKERS) want = THREAD_POOL_MAX_WORKERS;
+    if (want == 0 || pthread_atfork(NULL, NULL, pool_after_fork) != 0) return;
+
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) != 0) return;
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    pthread_mutex_lock(&g_pool.lock);
+    for (size_t i = 0; i < want; i++) {
+        pthread_t t;
+        if (pthread_create(&t, &attr, pool_worker, NULL) != 0) break;
+        g_pool.workers++;
+    }
+    pthread_mutex_unlock(&g_pool.lock);
+    pthread_attr_destroy(&attr);
+}
+
+size_t thread_pool_threads(void) {
+    pthread_once(&g_pool_once, pool_start);
+    pthread_mutex_lock(&g_pool.lock);
+    size_t n = g_pool.workers + 1;
+    pthread_mutex_unlock(&g_pool.lock);
+    return n;
+}
+
+static int run_inline(size_t count, thread_pool_fn fn, void *arg) {
+    for (size_t i = 0; i < count; i++) {
+        int rc = fn(arg, i);
+        if (rc != 0) return rc;
+    }
+    return 0;
+}
+
+int thread_pool_run(size_t count, thread_pool_fn fn, void *arg) {
+    if (!fn) return -1;
+    if (count < 2 || thread_pool_threads() < 2) return run_inline(count, fn, arg);
+    if (pthread_mutex_trylock(&g_pool.busy) != 0) return run_inline(count, fn, arg);
+
+    pthread_mutex_lock(&g_pool.lock);
+    g_pool.fn = fn;
+    g_pool.arg = arg;
+    g_pool.count = count;
+    g_pool.next = 0;
+    g_pool.running = 0;
+    g_pool.rc = 0;
+    pthread_cond_broadcast(&g_pool.posted);
+
+    pool_drain();
+    while (g_pool.running > 0) pthread_cond_wait(&g_pool.drained, &g_pool.lock);
+    int rc = g_pool.rc;
+    g_pool.fn = NULL;
+    pthread_mutex_unlock(&g_pool.lock);
+
+    pthread_mutex_unlock(&g_pool.busy);
+    return rc;
+}
@@ -0,0 +1,47 @@
+// native/src/utils/thread_pool.h
+// Small process-wide worker pool for data-parallel loops (chunk sealing).
+// Workers are started on first use, one fewer than the online CPUs (the
+// calling thread works too), and live until the process exits.
+
+#ifndef OPENLOCKR_THREAD_POOL_H
+#define OPENLOCKR_THREAD_POOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define THREAD_POOL_MAX_WORKERS  7   ///< cap on worker threads (8 cores with the caller)
+
+/**
+ * One item of a parallel loop.
+ * @return 0 on success, or a non-zero code that stops the loop.
+ */
+typedef int (*thread_pool_fn)(void *arg, size_t index);
+
+/**
+ * Number of threads a thread_pool_run() call can use, counting the caller
+ * (1 when no workers could be started). Starts the pool on first call.
+ */
+size_t thread_pool_threads(void);
+
+/**
+ * Run fn(arg, i) for every i in [0, count) on the pool and the calling
+ * thread, and return when all calls have finished. Items may run in any
+ * order and concurrently, so fn must only touch state owned by item i.
+ *
+ * The pool runs one loop at a time: if it is busy (another thread's loop,
+ * or a nested call), or after fork(), the loop runs on the calling thread
+ * alone. Either way every item runs unless one fails.
+ *
+ * @return 0 if every call returned 0; otherwise the first non-zero code
+ *         seen, after which items not yet started are skipped.
+ */
+int thread_pool_run(size_t count, thread_pool_fn fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OPENLOCKR_THREAD_POOL_H
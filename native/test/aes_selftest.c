@@ -0,0 +1,322 @@
+// native/test/aes_selftest.c
+// Known-answer self-test, cross-check and throughput benchmark for AES
+// backends, plus a check of batch CBC decryption. Uses only the public
+// interface, so it exercises external backends exactly as it does the
+// in-tree ones.
+
+#include "aes_selftest.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*=============================================================================
+  Known-answer vectors
+=============================================================================*/
+
+// NIST SP 800-38A, F.2.5 CBC-AES256.Encrypt
+static const uint8_t cbc_key[32] = {
+    0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe, 0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+    0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7, 0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4,
+};
+static const uint8_t cbc_iv[16] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+static const uint8_t cbc_pt[64] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96, 0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+    0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c, 0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+    0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11, 0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+    0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17, 0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10,
+};
+static const uint8_t cbc_ct[64] = {
+    0xf5, 0x8c, 0x4c, 0x04, 0xd6, 0xe5, 0xf1, 0xba, 0x77, 0x9e, 0xab, 0xfb, 0x5f, 0x7b, 0xfb, 0xd6,
+    0x9c, 0xfc, 0x4e, 0x96, 0x7e, 0xdb, 0x80, 0x8d, 0x67, 0x9f, 0x77, 0x7b, 0xc6, 0x70, 0x2c, 0x7d,
+    0x39, 0xf2, 0x33, 0x69, 0xa9, 0xd9, 0xba, 0xcf, 0xa5, 0x30, 0xe2, 0x63, 0x04, 0x23, 0x14, 0x61,
+    0xb2, 0xeb, 0x05, 0xe2, 0xc3, 0x9b, 0xe9, 0xfc, 0xda, 0x6c, 0x19, 0x07, 0x8c, 0x6a, 0x9d, 0x1b,
+};
+
+// McGrew & Viega, "The Galois/Counter Mode of Operation", test case 16
+static const uint8_t gcm_key[32] = {
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+    0xfe, 0xff, 0xe9, 0x92, 0x86, 0x65, 0x73, 0x1c, 0x6d, 0x6a, 0x8f, 0x94, 0x67, 0x30, 0x83, 0x08,
+};
+static const uint8_t gcm_nonce[AES_GCM_NONCE_LEN] = {
+    0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88,
+};
+static const uint8_t gcm_aad[20] = {
+    0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef, 0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+    0xab, 0xad, 0xda, 0xd2,
+};
+static const uint8_t gcm_pt[60] = {
+    0xd9, 0x31, 0x32, 0x25, 0xf8, 0x84, 0x06, 0xe5, 0xa5, 0x59, 0x09, 0xc5, 0xaf, 0xf5, 0x26, 0x9a,
+    0x86, 0xa7, 0xa9, 0x53, 0x15, 0x34, 0xf7, 0xda, 0x2e, 0x4c, 0x30, 0x3d, 0x8a, 0x31, 0x8a, 0x72,
+    0x1c, 0x3c, 0x0c, 0x95, 0x95, 0x68, 0x09, 0x53, 0x2f, 0xcf, 0x0e, 0x24, 0x49, 0xa6, 0xb5, 0x25,
+    0xb1, 0x6a, 0xed, 0xf5, 0xaa, 0x0d, 0xe6, 0x57, 0xba, 0x63, 0x7b, 0x39,
+};
+static const uint8_t gcm_ct[60] = {
+    0x52, 0x2d, 0xc1, 0xf0, 0x99, 0x56, 0x7d, 0x07, 0xf4, 0x7f, 0x37, 0xa3, 0x2a, 0x84, 0x42, 0x7d,
+    0x64, 0x3a, 0x8c, 0xdc, 0xbf, 0xe5, 0xc0, 0xc9, 0x75, 0x98, 0xa2, 0xbd, 0x25, 0x55, 0xd1, 0xaa,
+    0x8c, 0xb0, 0x8e, 0x48, 0x59, 0x0d, 0xbb, 0x3d, 0xa7, 0xb0, 0x8b, 0x10, 0x56, 0x82, 0x88, 0x38,
+    0xc5, 0xf6, 0x1e, 0x63, 0x93, 0xba, 0x7a, 0x0a, 0xbc, 0xc9, 0xf6, 0x62,
+};
+static const uint8_t gcm_tag[AES_GCM_TAG_LEN] = {
+    0x76, 0xfc, 0x6e, 0xce, 0x0f, 0x4e, 0x17, 0x68, 0xcd, 0xdf, 0x88, 0x53, 0xbb, 0x2d, 0x55, 0x1b,
+};
+
+/*=============================================================================
+  Self-test
+=============================================================================*/
+
+static int selftest_cbc(const aes_backend *b) {
+    uint8_t ct[sizeof(cbc_pt) + 16], pt[sizeof(ct)];
+    void *ctx = b->key_new(b, cbc_key);
+    if (!ctx) return -1;
+
+    // The vector has no padding; ours adds a full block, so compare the prefix
+    int ok = b->cbc_encrypt(ctx, cbc_iv, cbc_pt, sizeof(cbc_pt), ct) == (int)sizeof(ct) &&
+             memcmp(ct, cbc_ct, sizeof(cbc_ct)) == 0 &&
+             b->cbc_decrypt(ctx, cbc_iv, ct, sizeof(ct), pt) == (int)sizeof(cbc_pt) &&
+             memcmp(pt, cbc_pt, sizeof(cbc_pt)) == 0;
+
+    b->key_free(ctx);
+    return ok ? 0 : -1;
+}
+
+static int selftest_gcm(const aes_backend *b) {
+    uint8_t ct[sizeof(gcm_pt)], pt[sizeof(gcm_pt)], tag[AES_GCM_TAG_LEN];
+    void *ctx = b->key_new(b, gcm_key);
+    if (!ctx) return -1;
+
+    int ok = b->gcm_seal(ctx, gcm_nonce, gcm_aad, sizeof(gcm_aad),
+                         gcm_pt, sizeof(gcm_pt), ct, tag) == (int)sizeof(gcm_pt) &&
+             memcmp(ct, gcm_ct, sizeof(gcm_ct)) == 0 &&
+             memcmp(tag, gcm_tag, sizeof(gcm_tag)) == 0 &&
+             b->gcm_open(ctx, gcm_nonce, gcm_aad, sizeof(gcm_aad),
+                         gcm_ct, sizeof(gcm_ct), gcm_tag, pt) == (int)sizeof(gcm_pt) &&
+             memcmp(pt, gcm_pt, sizeof(gcm_pt)) == 0;
+
+    if (ok) {
+        tag[0] ^= 0x01;
+        ok = b->gcm_open(ctx, gcm_nonce, gcm_aad, sizeof(gcm_aad),
+                         gcm_ct, sizeof(gcm_ct), tag, pt) < 0;
+    }
+
+    b->key_free(ctx);
+    return ok ? 0 : -1;
+}
+
+int aes_backend_selftest(const aes_backend *b) {
+    if (!b) return -1;
+    return selftest_cbc(b) == 0 && selftest_gcm(b) == 0 ? 0 : -1;
+}
+
+/*=============================================================================
+  Cross-check on long messages
+=============================================================================*/
+
+// Plaintext lengths of 9 to 70 blocks, most ending in a partial block, so
+// the 8-block CBC-decrypt and CTR loops run and hand a remainder to the
+// single-block code.
+static const size_t cross_lens[] = { 9 * 16 + 5, 9 * 16, 16 * 16 + 1, 17 * 16 + 15, 70 * 16 + 7 };
+
+static void fill(uint8_t *p, size_t len, uint8_t seed) {
+    for (size_t i = 0; i < len; i++) p[i] = (uint8_t)(i * 167 + seed);
+}
+
+// One message of `len` bytes through both backends: identical CBC
+// ciphertext and GCM ciphertext and tag, and a round trip through `b`
+static int cross_one(const aes_backend *b, const void *ctx,
+                     const aes_backend *ref, const void *ref_ctx, size_t len) {
+    static const uint8_t aad[37] = { 0x5a, 0xa5 };
+    size_t padded = AES_CBC_PADDED_LEN(len);
+    uint8_t *plain = malloc(padded), *out = malloc(padded);
+    uint8_t *want = malloc(padded), *back = malloc(padded);
+    uint8_t tag[AES_GCM_TAG_LEN], want_tag[AES_GCM_TAG_LEN];
+    int ok = 0;
+    if (!plain || !out || !want || !back) goto done;
+    fill(plain, len, (uint8_t)len);
+
+    ok = b->cbc_encrypt(ctx, cbc_iv, plain, len, out) == (int)padded &&
+         ref->cbc_encrypt(ref_ctx, cbc_iv, plain, len, want) == (int)padded &&
+         memcmp(out, want, padded) == 0 &&
+         b->cbc_decrypt(ctx, cbc_iv, out, padded, back) == (int)len &&
+         memcmp(back, plain, len) == 0;
+
+    ok = ok &&
+         b->gcm_seal(ctx, gcm_nonce, aad, sizeof(aad), plain, len, out, tag) == (int)len &&
+         ref->gcm_seal(ref_ctx, gcm_nonce, aad, sizeof(aad), plain, len, want, want_tag)
+             == (int)len &&
+         memcmp(out, want, len) == 0 && memcmp(tag, want_tag, sizeof(tag)) == 0 &&
+         b->gcm_open(ctx, gcm_nonce, aad, sizeof(aad), out, len, tag, back) == (int)len &&
+         memcmp(back, plain, len) == 0;
+
+    // A flipped bit in the last block must still fail the tag
+    if (ok) {
+        out[len - 1] ^= 0x01;
+        ok = b->gcm_open(ctx, gcm_nonce, aad, sizeof(aad), out, len, tag, back) < 0;
+    }
+done:
+    free(plain);
+    free(out);
+    free(want);
+    free(back);
+    return ok;
+}
+
+int aes_backend_crosscheck(const aes_backend *b, const aes_backend *ref) {
+    if (!b || !ref) return -1;
+    void *ctx = b->key_new(b, gcm_key);
+    void *ref_ctx = ref->key_new(ref, gcm_key);
+    int ok = ctx && ref_ctx;
+    for (size_t i = 0; ok && i < sizeof(cross_lens) / sizeof(cross_lens[0]); i++) {
+        ok = cross_one(b, ctx, ref, ref_ctx, cross_lens[i]);
+    }
+    if (ctx) b->key_free(ctx);
+    if (ref_ctx) ref->key_free(ref_ctx);
+    return ok ? 0 : -1;
+}
+
+/*=============================================================================
+  Batch CBC decryption
+=============================================================================*/
+
+// Entry lengths mixing one- and two-block rows with runs of 8 and more
+// blocks, odd tails, and an entry whose ciphertext is not whole blocks
+static const size_t batch_lens[] = {
+    0, 5, 9 * 16 + 5, 31, 17 * 16 + 15, 1, 8 * 16, 70 * 16 + 7, 16 * 16 + 1, 15, 2 * 16,
+};
+#define BATCH_N    (sizeof(batch_lens) / sizeof(batch_lens[0]))
+#define BATCH_BAD  3   // entry decrypted with a ciphertext length of 17
+
+// Encrypt every entry with `k`, decrypt them in one batch (odd entries in
+// place) and compare with the plaintexts
+static int batch_one(const aes_256_key *k) {
+    uint8_t *plain[BATCH_N], *ct[BATCH_N], *out[BATCH_N], iv[BATCH_N][16];
+    aes_cbc_batch_item items[BATCH_N];
+    int ok = 1;
+    for (size_t i = 0; i < BATCH_N; i++) {
+        size_t padded = AES_CBC_PADDED_LEN(batch_lens[i]);
+        plain[i] = malloc(padded);
+        ct[i] = malloc(padded);
+        out[i] = i % 2 ? ct[i] : malloc(padded);
+        if (!plain[i] || !ct[i] || !out[i]) {
+            ok = 0;
+            continue;
+        }
+        fill(plain[i], batch_lens[i], (uint8_t)i);
+        fill(iv[i], sizeof(iv[i]), (uint8_t)(0x80 + i));
+        ok &= aes_256_cbc_encrypt_keyed(k, iv[i], plain[i], batch_lens[i], ct[i]) == (int)padded;
+        items[i].iv = iv[i];
+        items[i].ciphertext = ct[i];
+        items[i].ciphertext_len = i == BATCH_BAD ? 17 : padded;
+        items[i].plaintext = out[i];
+        items[i].result = 0;
+    }
+
+    ok = ok && aes_256_cbc_decrypt_batch(k, items, BATCH_N) == 1;
+    for (size_t i = 0; ok && i < BATCH_N; i++) {
+        ok = i == BATCH_BAD ? items[i].result == -1
+                            : items[i].result == (int)batch_lens[i] &&
+                              memcmp(out[i], plain[i], batch_lens[i]) == 0;
+    }
+
+    for (size_t i = 0; i < BATCH_N; i++) {
+        if (out[i] != ct[i]) free(out[i]);
+        free(plain[i]);
+        free(ct[i]);
+    }
+    return ok;
+}
+
+int aes_batch_selftest(void) {
+    const aes_backend *selected = aes_backend_selected();
+    int ok = selected != NULL;
+    for (size_t i = 0; ok && i < aes_backend_count(); i++) {
+        aes_256_key *k = NULL;
+        ok = aes_backend_select(aes_backend_get(i)->name) == 0 &&
+             (k = aes_256_key_new(gcm_key, sizeof(gcm_key))) != NULL &&
+             batch_one(k);
+        aes_256_key_free(k);
+    }
+    if (selected) aes_backend_select(selected->name);
+    return ok ? 0 : -1;
+}
+
+/*=============================================================================
+  Benchmark
+=============================================================================*/
+
+#define BENCH_NS  100000000LL   // time spent on each operation
+
+enum { OP_CBC_ENC, OP_CBC_DEC, OP_GCM_SEAL, OP_GCM_OPEN };
+
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int run_op(const aes_backend *b, const void *ctx, int op,
+                  const uint8_t *in, size_t len, uint8_t *out, uint8_t *tag) {
+    static const uint8_t iv[16] = {0};
+    switch (op) {
+    case OP_CBC_ENC:  return b->cbc_encrypt(ctx, iv, in, len, out);
+    case OP_CBC_DEC:  return b->cbc_decrypt(ctx, iv, in, len, out);
+    case OP_GCM_SEAL: return b->gcm_seal(ctx, iv, NULL, 0, in, len, out, tag);
+    default:          return b->gcm_open(ctx, iv, NULL, 0, in, len, tag, out);
+    }
+}
+
+// MB/s of `op`, or a negative value if the backend reported an error
+static double measure(const aes_backend *b, const void *ctx, int op,
+                      const uint8_t *in, size_t len, uint8_t *out, uint8_t *tag) {
+    long long start = now_ns(), elapsed;
+    unsigned long long bytes = 0;
+    do {
+        for (int i = 0; i < 16; i++) {
+            if (run_op(b, ctx, op, in, len, out, tag) < 0) return -1.0;
+            bytes += len;
+        }
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_NS);
+    return (double)bytes * 1000.0 / (double)elapsed;
+}
+
+int aes_backend_benchmark(const aes_backend *b, size_t msg_len,
+                          aes_backend_perf *out) {
+    if (!b || !out || msg_len == 0 || msg_len > (size_t)1 << 30) return -1;
+
+    // CBC decrypt needs whole blocks; measure it on the padded ciphertext
+    size_t padded = AES_CBC_PADDED_LEN(msg_len);
+    uint8_t *plain = malloc(padded);
+    uint8_t *cbc   = malloc(padded);
+    uint8_t *work  = malloc(padded);
+    uint8_t *gcm   = malloc(msg_len);
+    uint8_t tag[AES_GCM_TAG_LEN];
+    void *ctx = b->key_new(b, gcm_key);
+    int rc = -1;
+
+    if (plain && cbc && work && gcm && ctx) {
+        for (size_t i = 0; i < msg_len; i++) plain[i] = (uint8_t)(i * 131 + 7);
+        static const uint8_t iv[16] = {0};
+
+        if (b->cbc_encrypt(ctx, iv, plain, msg_len, cbc) == (int)padded &&
+            b->gcm_seal(ctx, iv, NULL, 0, plain, msg_len, gcm, tag) == (int)msg_len) {
+            out->cbc_encrypt = measure(b, ctx, OP_CBC_ENC, plain, msg_len, work, tag);
+            out->cbc_decrypt = measure(b, ctx, OP_CBC_DEC, cbc, padded, work, tag);
+            out->gcm_seal    = measure(b, ctx, OP_GCM_SEAL, plain, msg_len, work, tag);
+            // Sealing overwrote `tag`; reseal so opening verifies
+            b->gcm_seal(ctx, iv, NULL, 0, plain, msg_len, gcm, tag);
+            out->gcm_open    = measure(b, ctx, OP_GCM_OPEN, gcm, msg_len, work, tag);
+
+            rc = out->cbc_encrypt < 0 || out->cbc_decrypt < 0 ||
+                 out->gcm_seal < 0 || out->gcm_open < 0 ? -1 : 0;
+        }
+    }
+
+    if (ctx) b->key_free(ctx);
+    free(plain);
+    free(cbc);
+    free(work);
+    free(gcm);
+    return rc;
+}
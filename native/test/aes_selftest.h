@@ -0,0 +1,57 @@
+// native/test/aes_selftest.h
+// Known-answer self-test, cross-check and throughput benchmark for AES
+// backends, plus a check of batch CBC decryption.
+// Test-only: built into openlockr_aes_test, not into the shipped library.
+
+#ifndef OPENLOCKR_AES_SELFTEST_H
+#define OPENLOCKR_AES_SELFTEST_H
+
+#include "crypto/aes.h"
+
+/**
+ * Run known-answer tests against a backend: NIST SP 800-38A F.2.5
+ * (CBC-AES256) and GCM test case 16 from the McGrew–Viega specification,
+ * in both directions, plus rejection of a corrupted tag.
+ *
+ * @return 0 if every vector passed, or -1.
+ */
+int aes_backend_selftest(const aes_backend *b);
+
+/**
+ * Encrypt and decrypt messages of 9 to 70 blocks, most with a partial last
+ * block, through `b` and through `ref`, which must give identical CBC and
+ * GCM output; `b` must also round-trip them. The short vectors above never
+ * reach the 8-block loops of the hardware backends; these do.
+ *
+ * @return 0 if the backends agree, or -1.
+ */
+int aes_backend_crosscheck(const aes_backend *b, const aes_backend *ref);
+
+/**
+ * Decrypt a batch of CBC entries of mixed lengths, a few in place, with
+ * aes_256_cbc_decrypt_batch(), once with a key made by each backend, and
+ * compare with the plaintexts. One entry with a bad length must fail
+ * alone. Restores the selected backend.
+ *
+ * @return 0 if every batch decrypted correctly, or -1.
+ */
+int aes_batch_selftest(void);
+
+/** Throughput of one backend in MB/s (10^6 bytes per second). */
+typedef struct {
+    double cbc_encrypt;
+    double cbc_decrypt;
+    double gcm_seal;
+    double gcm_open;
+} aes_backend_perf;
+
+/**
+ * Measure a backend on messages of `msg_len` bytes. Each operation is
+ * repeated for roughly 100 ms of wall-clock time.
+ *
+ * @return 0 on success, or -1 on error.
+ */
+int aes_backend_benchmark(const aes_backend *b, size_t msg_len,
+                          aes_backend_perf *out);
+
+#endif // OPENLOCKR_AES_SELFTEST_H
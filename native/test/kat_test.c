@@ -0,0 +1,488 @@
+// native/test/kat_test.c
+// openlockr_kat_test: known-answer vectors for the in-tree primitives, run
+// once per CPU feature level so every compiled kernel is checked (AVX2,
+// SSE2/SSSE3 and portable on x86; NEON, ARMv8 and portable on ARM).
+//
+//   SHA-256          FIPS 180-2 examples, plus sha256_many() against them
+//   HMAC-SHA256      RFC 4231 test cases 1, 2 and 6, plus hmac_sha256_many()
+//   PBKDF2           RFC 7914 section 11 (HMAC-SHA256) and the common
+//                    4096-iteration 40-byte vector
+//   HKDF-SHA256      RFC 5869 appendix A.1 to A.3
+//   ChaCha20-Poly1305 RFC 8439 section 2.8.2
+//   AES-256-GCM-SIV  RFC 8452 appendix C.2 and the C.3 counter wrap
+//   Argon2id         RFC 9106 section 5.3
+//   Base64           RFC 4648 section 10
+//   random_bytes()   not a vector: a forked child's output differs from the
+//                    parent's
+//
+// The "long" cases hash the output for a test_pattern() input; their
+// expected digests come from independent implementations (OpenSSL, Python
+// hashlib/base64) and cover the multi-block kernel paths the short vectors
+// miss.
+
+#include "test_util.h"
+#include "crypto/aes.h"
+#include "crypto/argon2.h"
+#include "crypto/chacha20poly1305.h"
+#include "crypto/hkdf.h"
+#include "crypto/pbkdf2.h"
+#include "crypto/random.h"
+#include "crypto/sha256.h"
+#include "utils/base64.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define LONG_LEN  1000
+
+static int sha256_equal_hex(const uint8_t *data, size_t len, const char *hex) {
+    uint8_t d[SHA256_DIGEST_LEN];
+    sha256(data, len, d);
+    return test_equal_hex(d, sizeof(d), hex);
+}
+
+/*=============================================================================
+  SHA-256 and HMAC-SHA256
+=============================================================================*/
+
+static void kat_sha256(void) {
+    static const struct { const char *msg; const char *digest; } v[] = {
+        { "", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+        { "abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+        { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+          "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+        { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+          "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu",
+          "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+    };
+    for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++) {
+        CHECK(sha256_equal_hex((const uint8_t *)v[i].msg, strlen(v[i].msg), v[i].digest));
+    }
+
+    // One million 'a', streamed in uneven pieces
+    uint8_t a[1000], d[SHA256_DIGEST_LEN];
+    memset(a, 'a', sizeof(a));
+    sha256_ctx ctx;
+    sha256_init(&ctx);
+    for (size_t done = 0, step = 1; done < 1000000; done += step, step = step % 997 + 1) {
+        if (step > 1000000 - done) step = 1000000 - done;
+        sha256_update(&ctx, a, step);
+    }
+    sha256_final(&ctx, d);
+    CHECK(test_equal_hex(d, sizeof(d),
+                         "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+}
+
+static void kat_hmac_sha256(void) {
+    uint8_t key[131], mac[SHA256_DIGEST_LEN];
+
+    memset(key, 0x0b, 20);
+    hmac_sha256(key, 20, (const uint8_t *)"Hi There", 8, mac);
+    CHECK(test_equal_hex(mac, sizeof(mac),
+                         "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"));
+
+    const char *msg = "what do ya want for nothing?";
+    hmac_sha256((const uint8_t *)"Jefe", 4, (const uint8_t *)msg, strlen(msg), mac);
+    CHECK(test_equal_hex(mac, sizeof(mac),
+                         "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843"));
+
+    memset(key, 0xaa, sizeof(key));
+    msg = "Test Using Larger Than Block-Size Key - Hash Key First";
+    hmac_sha256(key, sizeof(key), (const uint8_t *)msg, strlen(msg), mac);
+    CHECK(test_equal_hex(mac, sizeof(mac),
+                         "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54"));
+}
+
+// Multi-buffer engine: nine messages straddling the padding boundaries,
+// each checked against the one-shot function, then the concatenated
+// digests against a digest from Python's hashlib / hmac
+static void kat_sha256_many(void) {
+    static const size_t lens[] = { 0, 1, 55, 56, 63, 64, 65, 1000, 4096 };
+    enum { N = sizeof(lens) / sizeof(lens[0]) };
+    uint8_t *msgs[N], digests[N][SHA256_DIGEST_LEN], one[SHA256_DIGEST_LEN];
+    sha256_job jobs[N];
+    uint8_t key[40];
+    test_pattern(key, sizeof(key), 9);
+
+    for (size_t i = 0; i < N; i++) {
+        msgs[i] = malloc(lens[i] ? lens[i] : 1);
+        test_pattern(msgs[i], lens[i], (uint8_t)lens[i]);
+        jobs[i].data = msgs[i];
+        jobs[i].len = lens[i];
+        jobs[i].digest = digests[i];
+    }
+
+    CHECK(sha256_many(jobs, N) == 0);
+    for (size_t i = 0; i < N; i++) {
+        sha256(msgs[i], lens[i], one);
+        CHECK(memcmp(one, digests[i], sizeof(one)) == 0);
+    }
+    CHECK(sha256_equal_hex(&digests[0][0], sizeof(digests),
+                           "e10cef5599d69f44eaebb9576ab6943b3f0333d29bed5c729325825b8b820adb"));
+
+    CHECK(hmac_sha256_many(key, sizeof(key), jobs, N) == 0);
+    for (size_t i = 0; i < N; i++) {
+        hmac_sha256(key, sizeof(key), msgs[i], lens[i], one);
+        CHECK(memcmp(one, digests[i], sizeof(one)) == 0);
+    }
+    CHECK(sha256_equal_hex(&digests[0][0], sizeof(digests),
+                           "6f1d8b3ee824efe2b0c77fc6925a5348b58d25c562fb170b70d797873bb0cdaf"));
+
+    for (size_t i = 0; i < N; i++) free(msgs[i]);
+}
+
+/*=============================================================================
+  PBKDF2-HMAC-SHA256
+=============================================================================*/
+
+static void kat_pbkdf2(void) {
+    static const struct {
+        const char *password;
+        const char *salt;
+        uint32_t    iterations;
+        const char *key;
+    } v[] = {
+        { "passwd", "salt", 1,
+          "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"
+          "49ca9cccf179b645991664b39d77ef317c71b845b1e30bd509112041d3a19783" },
+        { "Password", "NaCl", 80000,
+          "4ddcd8f60b98be21830cee5ef22701f9641a4418d04c0414aeff08876b34ab56"
+          "a1d425a1225833549adb841b51c9b3176a272bdebba1d078478f62b397f33c8d" },
+        { "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096,
+          "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9" },
+    };
+    uint8_t out[64];
+    for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++) {
+        size_t len = strlen(v[i].key) / 2;
+        CHECK(pbkdf2_hmac_sha256(v[i].password, strlen(v[i].password),
+                                 (const uint8_t *)v[i].salt, strlen(v[i].salt),
+                                 v[i].iterations, out, len) == 0);
+        CHECK(test_equal_hex(out, len, v[i].key));
+    }
+}
+
+/*=============================================================================
+  HKDF-SHA256
+=============================================================================*/
+
+static void kat_hkdf(void) {
+    static const struct {
+        const char *ikm;
+        const char *salt;
+        const char *info;
+        const char *prk;
+        const char *okm;
+    } v[] = {
+        { "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+          "000102030405060708090a0b0c",
+          "f0f1f2f3f4f5f6f7f8f9",
+          "077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5",
+          "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+          "34007208d5b887185865" },
+        { "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+          "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+          "404142434445464748494a4b4c4d4e4f",
+          "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+          "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+          "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf",
+          "b0b1b2b3b4b5b6b7b8b9babbbcbdbebfc0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+          "d0d1d2d3d4d5d6d7d8d9dadbdcdddedfe0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+          "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+          "06a6b88c5853361a06104c9ceb35b45cef760014904671014a193f40c15fc244",
+          "b11e398dc80327a1c8e7f78c596a49344f012eda2d4efad8a050cc4c19afa97c"
+          "59045a99cac7827271cb41c65e590e09da3275600c2f09b8367793a9aca3db71"
+          "cc30c58179ec3e87c14c01d5c1f3434f1d87" },
+        { "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b",
+          "",
+          "",
+          "19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04",
+          "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d"
+          "9d201395faa4b61a96c8" },
+    };
+    uint8_t ikm[80], salt[80], info[80], prk[HKDF_SHA256_PRK_LEN], okm[82];
+    for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++) {
+        size_t ikm_len = test_unhex(v[i].ikm, ikm);
+        size_t salt_len = test_unhex(v[i].salt, salt);
+        size_t info_len = test_unhex(v[i].info, info);
+        size_t len = strlen(v[i].okm) / 2;
+
+        CHECK(hkdf_sha256_extract(salt_len ? salt : NULL, salt_len, ikm, ikm_len, prk) == 0);
+        CHECK(test_equal_hex(prk, sizeof(prk), v[i].prk));
+        CHECK(hkdf_sha256_expand(prk, sizeof(prk), info_len ? info : NULL, info_len,
+                                 okm, len) == 0);
+        CHECK(test_equal_hex(okm, len, v[i].okm));
+
+        memset(okm, 0, sizeof(okm));
+        CHECK(hkdf_sha256(salt_len ? salt : NULL, salt_len, ikm, ikm_len,
+                          info_len ? info : NULL, info_len, okm, len) == 0);
+        CHECK(test_equal_hex(okm, len, v[i].okm));
+    }
+}
+
+/*=============================================================================
+  ChaCha20-Poly1305
+=============================================================================*/
+
+static void kat_chacha20_poly1305(void) {
+    static const char *pt =
+        "Ladies and Gentlemen of the class of '99: If I could offer you only one "
+        "tip for the future, sunscreen would be it.";
+    static const char *ct_hex =
+        "d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+        "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+        "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+        "3ff4def08e4b7a9de576d26586cec64b6116";
+    uint8_t key[32], nonce[12], aad[12], ct[LONG_LEN + 16], out[LONG_LEN], tag[16];
+    size_t len = strlen(pt);
+
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(0x80 + i);
+    test_unhex("070000004041424344454647", nonce);
+    test_unhex("50515253c0c1c2c3c4c5c6c7", aad);
+
+    CHECK(chacha20_poly1305_encrypt(key, nonce, aad, sizeof(aad),
+                                    (const uint8_t *)pt, len, ct, tag) == (int)len);
+    CHECK(test_equal_hex(ct, len, ct_hex));
+    CHECK(test_equal_hex(tag, sizeof(tag), "1ae10b594f09e26a7e902ecbd0600691"));
+    CHECK(chacha20_poly1305_decrypt(key, nonce, aad, sizeof(aad), ct, len, tag, out) == (int)len);
+    CHECK(memcmp(out, pt, len) == 0);
+    tag[15] ^= 0x01;
+    CHECK(chacha20_poly1305_decrypt(key, nonce, aad, sizeof(aad), ct, len, tag, out) < 0);
+
+    // Long message through the multi-block kernels, one-shot and streamed
+    uint8_t msg[LONG_LEN];
+    test_pattern(key, sizeof(key), 1);
+    test_pattern(nonce, sizeof(nonce), 2);
+    test_pattern(aad, sizeof(aad), 3);
+    test_pattern(msg, sizeof(msg), 4);
+    CHECK(chacha20_poly1305_encrypt(key, nonce, aad, sizeof(aad), msg, LONG_LEN,
+                                    ct, ct + LONG_LEN) == LONG_LEN);
+    CHECK(sha256_equal_hex(ct, LONG_LEN + 16,
+                           "8df30870915d4754c58b5bf50572974278527a9367e85c9e89bb49c76e0ce32d"));
+
+    chacha20_poly1305_stream st;
+    size_t done = 0;
+    CHECK(chacha20_poly1305_stream_init(&st, key, nonce, aad, sizeof(aad), 0) == 0);
+    for (size_t step = 1; done < LONG_LEN; done += step, step = step * 3 + 1) {
+        if (step > LONG_LEN - done) step = LONG_LEN - done;
+        CHECK(chacha20_poly1305_stream_update(&st, msg + done, step, out + done) == (int)step);
+    }
+    CHECK(chacha20_poly1305_stream_final(&st, tag) == 0);
+    CHECK(memcmp(out, ct, LONG_LEN) == 0);
+    CHECK(memcmp(tag, ct + LONG_LEN, sizeof(tag)) == 0);
+}
+
+/*=============================================================================
+  AES-256-GCM-SIV
+=============================================================================*/
+
+static void kat_gcm_siv(void) {
+    static const struct {
+        const char *key, *nonce, *aad, *pt, *result;   // result = ct || tag
+    } v[] = {
+        { "0100000000000000000000000000000000000000000000000000000000000000",
+          "030000000000000000000000", "", "",
+          "07f5f4169bbf55a8400cd47ea6fd400f" },
+        { "0100000000000000000000000000000000000000000000000000000000000000",
+          "030000000000000000000000", "", "0100000000000000",
+          "c2ef328e5c71c83b843122130f7364b761e0b97427e3df28" },
+        { "0100000000000000000000000000000000000000000000000000000000000000",
+          "030000000000000000000000", "", "010000000000000000000000",
+          "9aab2aeb3faa0a34aea8e2b18ca50da9ae6559e48fd10f6e5c9ca17e" },
+        { "0100000000000000000000000000000000000000000000000000000000000000",
+          "030000000000000000000000", "01", "0200000000000000",
+          "1de22967237a813291213f267e3b452f02d01ae33e4ec854" },
+        { "0100000000000000000000000000000000000000000000000000000000000000",
+          "030000000000000000000000", "01",
+          "0200000000000000000000000000000003000000000000000000000000000000"
+          "0400000000000000",
+          "bdf21f4913e5f08f4ae4afaf2ab98d4c2bfdb33e78df11fe84e4572a412ca639"
+          "508f8f535cea6342c7c492f145d7a8bb3c5973eaae7a3dc8" },
+        // C.3: the 32-bit counter wraps inside the message
+        { "0000000000000000000000000000000000000000000000000000000000000000",
+          "000000000000000000000000", "",
+          "000000000000000000000000000000004db923dc793ee6497c76dcc03a98e108",
+          "f3f80f2cf0cb2dd9c5984fcda908456cc537703b5ba70324a6793a7bf218d3ea"
+          "ffffffff000000000000000000000000" },
+    };
+    uint8_t key[32], nonce[12], aad[16], pt[LONG_LEN], ct[LONG_LEN + 16], out[LONG_LEN];
+
+    for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++) {
+        test_unhex(v[i].key, key);
+        test_unhex(v[i].nonce, nonce);
+        size_t aad_len = test_unhex(v[i].aad, aad);
+        size_t len = test_unhex(v[i].pt, pt);
+
+        aes_256_key *k = aes_256_key_new(key, sizeof(key));
+        if (!CHECK(k != NULL)) continue;
+        CHECK(aes_256_gcm_siv_encrypt_keyed(k, nonce, aad, aad_len, pt, len,
+                                            ct, ct + len) == (int)len);
+        CHECK(test_equal_hex(ct, len + 16, v[i].result));
+        CHECK(aes_256_gcm_siv_decrypt_keyed(k, nonce, aad, aad_len, ct, len,
+                                            ct + len, out) == (int)len);
+        CHECK(memcmp(out, pt, len) == 0);
+        ct[len] ^= 0x80;
+        CHECK(aes_256_gcm_siv_decrypt_keyed(k, nonce, aad, aad_len, ct, len,
+                                            ct + len, out) < 0);
+        aes_256_key_free(k);
+    }
+
+    // Long message, digest from an independent Python reference
+    test_pattern(key, sizeof(key), 1);
+    test_pattern(nonce, sizeof(nonce), 2);
+    test_pattern(aad, 12, 3);
+    test_pattern(pt, LONG_LEN, 4);
+    aes_256_key *k = aes_256_key_new(key, sizeof(key));
+    if (CHECK(k != NULL)) {
+        CHECK(aes_256_gcm_siv_encrypt_keyed(k, nonce, aad, 12, pt, LONG_LEN,
+                                            ct, ct + LONG_LEN) == LONG_LEN);
+        CHECK(sha256_equal_hex(ct, LONG_LEN + 16,
+                               "1b8984684501dc5cfa16a44edc956a3c52c64ee1aff0d6056acca428e4acaeb6"));
+        aes_256_key_free(k);
+    }
+}
+
+/*=============================================================================
+  Argon2id
+=============================================================================*/
+
+static void kat_argon2id(void) {
+    uint8_t password[32], salt[16], secret[8], ad[12], tag[32];
+    memset(password, 0x01, sizeof(password));
+    memset(salt, 0x02, sizeof(salt));
+    memset(secret, 0x03, sizeof(secret));
+    memset(ad, 0x04, sizeof(ad));
+
+    argon2_params p = { 3, 32, 4 };
+    CHECK(argon2id(&p, password, sizeof(password), salt, sizeof(salt),
+                   secret, sizeof(secret), ad, sizeof(ad), tag, sizeof(tag)) == 0);
+    CHECK(test_equal_hex(tag, sizeof(tag),
+                         "0d640df58d78766c08c037a34a8b53c9d01ef0452d75b65eb52520e96b01e659"));
+}
+
+/*=============================================================================
+  Base64
+=============================================================================*/
+
+static void kat_base64(void) {
+    static const struct { const char *raw, *b64; } v[] = {
+        { "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" },
+    };
+    char enc[2 * LONG_LEN];
+    uint8_t dec[2 * LONG_LEN];      // the stream decoder wants room for whitespace too
+
+    for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++) {
+        size_t len = strlen(v[i].raw), b64_len = strlen(v[i].b64);
+        CHECK(base64_encode_into((const uint8_t *)v[i].raw, len, enc, sizeof(enc)) == (int)b64_len);
+        CHECK(strcmp(enc, v[i].b64) == 0);
+        CHECK(base64_decode_into(v[i].b64, b64_len, dec, sizeof(dec)) == (int)len);
+        CHECK(memcmp(dec, v[i].raw, len) == 0);
+    }
+    CHECK(base64_decode_into("Zm9v!mFy", 8, dec, sizeof(dec)) < 0);
+    CHECK(base64_decode_into("Zm9vYmF", 7, dec, sizeof(dec)) < 0);
+
+    // Long input: encode, in-place encode, decode with and without line breaks
+    uint8_t raw[LONG_LEN], buf[2 * LONG_LEN];
+    test_pattern(raw, sizeof(raw), 5);
+    int n = base64_encode_into(raw, sizeof(raw), enc, sizeof(enc));
+    CHECK(n == (int)base64_encoded_len(sizeof(raw)));
+    CHECK(sha256_equal_hex((const uint8_t *)enc, (size_t)n,
+                           "47de6693be726d171b23f2bda5a4ec611e779b6ab1853c325d6b09783c49627d"));
+
+    size_t out_len = 0;
+    memcpy(buf, raw, sizeof(raw));
+    CHECK(base64_encode_inplace(buf, sizeof(raw), sizeof(buf), &out_len) != NULL);
+    CHECK(out_len == (size_t)n && memcmp(buf, enc, out_len) == 0);
+
+    CHECK(base64_decode_into(enc, (size_t)n, dec, sizeof(dec)) == LONG_LEN);
+    CHECK(memcmp(dec, raw, sizeof(raw)) == 0);
+
+    char wrapped[2 * LONG_LEN];
+    size_t w = 0;
+    for (int i = 0; i < n; i++) {
+        if (i && i % 76 == 0) { wrapped[w++] = '\r'; wrapped[w++] = '\n'; }
+        wrapped[w++] = enc[i];
+    }
+    base64_decode_stream st;
+    base64_decode_stream_init(&st);
+    size_t got = 0;
+    for (size_t off = 0, step = 1; off < w; off += step, step = step * 2 + 1) {
+        if (step > w - off) step = w - off;
+        int r = base64_decode_stream_update(&st, wrapped + off, step, dec + got,
+                                            sizeof(dec) - got);
+        if (!CHECK(r >= 0)) break;
+        got += (size_t)r;
+    }
+    CHECK(base64_decode_stream_final(&st) == 0);
+    CHECK(got == LONG_LEN && memcmp(dec, raw, sizeof(raw)) == 0);
+}
+
+/*=============================================================================
+  CSPRNG across fork()
+=============================================================================*/
+
+// Not a vector: a child must not replay the parent's buffered stream. The
+// parent draws first so its generator is seeded and holds buffered output.
+static void check_random_fork(void) {
+    uint8_t warm[16], parent[64], child[64];
+    int fds[2];
+    CHECK(random_bytes(warm, sizeof(warm)) == 0);
+    if (!CHECK(pipe(fds) == 0)) return;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        int ok = random_bytes(child, sizeof(child)) == 0 &&
+                 write(fds[1], child, sizeof(child)) == (ssize_t)sizeof(child);
+        _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    if (!CHECK(pid > 0)) {
+        close(fds[0]);
+        return;
+    }
+
+    size_t got = 0;
+    ssize_t n;
+    while (got < sizeof(child) &&
+           ((n = read(fds[0], child + got, sizeof(child) - got)) > 0 || (n < 0 && errno == EINTR))) {
+        if (n > 0) got += (size_t)n;
+    }
+    close(fds[0]);
+    int status = 0;
+    CHECK(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    CHECK(random_bytes(parent, sizeof(parent)) == 0);
+    CHECK(got == sizeof(child) && memcmp(parent, child, sizeof(child)) != 0);
+}
+
+/*=============================================================================
+  Driver
+=============================================================================*/
+
+static int all_kats(void) {
+    printf("aes %s, sha256 %s, pbkdf2 %s, chacha20 %s, argon2 %s, base64 %s\n",
+           aes_implementation(), sha256_implementation(), pbkdf2_implementation(),
+           chacha20_implementation(), argon2_implementation(), base64_implementation());
+
+    kat_sha256();
+    kat_hmac_sha256();
+    kat_sha256_many();
+    kat_pbkdf2();
+    kat_hkdf();
+    kat_chacha20_poly1305();
+    kat_gcm_siv();
+    kat_argon2id();
+    kat_base64();
+    check_random_fork();
+
+    printf("%s\n", g_test_failures ? "FAILED" : "ok");
+    return g_test_failures;
+}
+
+int main(void) {
+    return test_run_per_cpu_level(all_kats) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,83 @@
+// native/test/sync_stub.c
+// In-memory stand-in for the Firestore bridge. Not thread-safe; the tests
+// drive the core from one thread.
+
+#include "sync_stub.h"
+#include "core.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct doc {
+    char       *id;
+    char       *value;
+    struct doc *next;
+} doc;
+
+static doc     *g_docs = NULL;
+static int      g_fail_uploads = 0;
+static unsigned g_uploads = 0;
+
+static doc *find(const char *id) {
+    for (doc *d = g_docs; d; d = d->next) {
+        if (strcmp(d->id, id) == 0) return d;
+    }
+    return NULL;
+}
+
+int sync_stub_put(const char *id, const char *b64_cipher) {
+    char *value = strdup(b64_cipher);
+    if (!value) return -1;
+
+    doc *d = find(id);
+    if (!d) {
+        d = calloc(1, sizeof(*d));
+        if (!d || !(d->id = strdup(id))) {
+            free(d);
+            free(value);
+            return -1;
+        }
+        d->next = g_docs;
+        g_docs = d;
+    }
+    free(d->value);
+    d->value = value;
+    return 0;
+}
+
+void sync_stub_reset(void) {
+    g_fail_uploads = 0;
+    g_uploads = 0;
+    while (g_docs) {
+        doc *d = g_docs;
+        g_docs = d->next;
+        free(d->id);
+        free(d->value);
+        free(d);
+    }
+}
+
+void sync_stub_fail_uploads(int fail) {
+    g_fail_uploads = fail;
+}
+
+unsigned sync_stub_uploads(void) {
+    return g_uploads;
+}
+
+int firestore_sync_upload(const char *id, const char *b64_cipher) {
+    if (!id || !b64_cipher) return OLKR_ERR_INVALID_ARG;
+    if (g_fail_uploads) return OLKR_ERR_SYNC;
+    if (sync_stub_put(id, b64_cipher) != 0) return OLKR_ERR_OOM;
+    g_uploads++;
+    return OLKR_OK;
+}
+
+int firestore_sync_download(const char *id, char **out_b64_cipher) {
+    if (!id || !out_b64_cipher) return OLKR_ERR_INVALID_ARG;
+    *out_b64_cipher = NULL;
+
+    doc *d = find(id);
+    if (!d) return OLKR_ERR_NOT_FOUND;
+    *out_b64_cipher = strdup(d->value);
+    return *out_b64_cipher ? OLKR_OK : OLKR_ERR_OOM;
+}
@@ -0,0 +1,30 @@
+// native/test/sync_stub.h
+// In-memory stand-in for the Firestore bridge, linked into the native test
+// executables in place of the app's implementation.
+
+#ifndef OPENLOCKR_SYNC_STUB_H
+#define OPENLOCKR_SYNC_STUB_H
+
+/**
+ * Store `b64_cipher` under `id` as if a remote client had uploaded it.
+ * @return 0 on success, or -1 on allocation failure.
+ */
+int sync_stub_put(const char *id, const char *b64_cipher);
+
+/**
+ * Drop every stored document and stop failing uploads.
+ */
+void sync_stub_reset(void);
+
+/**
+ * While `fail` is non-zero, firestore_sync_upload() stores nothing and
+ * returns OLKR_ERR_SYNC, as if the device were offline.
+ */
+void sync_stub_fail_uploads(int fail);
+
+/**
+ * Number of successful firestore_sync_upload() calls since the last reset.
+ */
+unsigned sync_stub_uploads(void);
+
+#endif // OPENLOCKR_SYNC_STUB_H
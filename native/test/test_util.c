@@ -0,0 +1,94 @@
+// native/test/test_util.c
+// Helpers shared by the native test executables.
+
+#include "test_util.h"
+#include "utils/cpu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+int g_test_failures = 0;
+
+int test_check(int ok, const char *what, const char *file, int line) {
+    if (!ok) {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what);
+        g_test_failures++;
+    }
+    return ok;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+size_t test_unhex(const char *hex, uint8_t *out) {
+    size_t n = 0;
+    for (; hex[0] && hex[1]; hex += 2) {
+        out[n++] = (uint8_t)(hex_digit(hex[0]) << 4 | hex_digit(hex[1]));
+    }
+    return n;
+}
+
+int test_equal_hex(const uint8_t *got, size_t len, const char *hex) {
+    if (strlen(hex) != 2 * len) return 0;
+    for (size_t i = 0; i < len; i++) {
+        if (got[i] != (uint8_t)(hex_digit(hex[2 * i]) << 4 | hex_digit(hex[2 * i + 1]))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void test_pattern(uint8_t *p, size_t len, uint8_t seed) {
+    for (size_t i = 0; i < len; i++) p[i] = (uint8_t)(i * 167 + seed);
+}
+
+int test_run_per_cpu_level(int (*suite)(void)) {
+    static const uint32_t levels[] = {
+        ~0u,                              // everything detected
+        ~CPU_X86_AVX2,                    // 128-bit x86 kernels
+        CPU_X86_SSE2 | CPU_ARM_NEON,      // plain SIMD, no AES/SHA instructions
+        0,                                // portable only
+    };
+    uint32_t all = cpu_features();
+    uint32_t done[sizeof(levels) / sizeof(levels[0])];
+    size_t ndone = 0;
+    int failed = 0;
+
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        uint32_t mask = all & levels[i];
+        int seen = 0;
+        for (size_t j = 0; j < ndone; j++) seen |= done[j] == mask;
+        if (seen) continue;
+        done[ndone++] = mask;
+
+        fflush(stdout);
+        fflush(stderr);
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return failed + 1;
+        }
+        if (pid == 0) {
+            cpu_features_restrict(mask);
+            printf("== cpu features 0x%08x ==\n", (unsigned)mask);
+            int n = suite();
+            fflush(stdout);
+            fflush(stderr);
+            _exit(n == 0 && g_test_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        int status = 0;
+        if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+            WEXITSTATUS(status) != EXIT_SUCCESS) {
+            printf("FAILED at cpu features 0x%08x\n", (unsigned)mask);
+            failed++;
+        }
+    }
+    return failed;
+}
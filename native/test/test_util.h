@@ -0,0 +1,52 @@
+// native/test/test_util.h
+// Helpers shared by the native test executables: failure reporting, hex
+// vectors, deterministic filler data and a runner that repeats a suite once
+// per CPU feature level, so every compiled kernel gets exercised.
+
+#ifndef OPENLOCKR_TEST_UTIL_H
+#define OPENLOCKR_TEST_UTIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Failures recorded by CHECK() in this process. */
+extern int g_test_failures;
+
+/**
+ * Record a failure (with file, line and the condition) unless `cond` holds.
+ * Evaluates to the truth value of `cond`.
+ */
+#define CHECK(cond) test_check((cond) != 0, #cond, __FILE__, __LINE__)
+
+int test_check(int ok, const char *what, const char *file, int line);
+
+/**
+ * Decode `hex` (two digits per byte, no separators) into `out`.
+ * @return Number of bytes written.
+ */
+size_t test_unhex(const char *hex, uint8_t *out);
+
+/**
+ * Non-zero if the first `len` bytes of `got` equal the bytes spelled by `hex`
+ * (which must hold exactly 2 * len digits).
+ */
+int test_equal_hex(const uint8_t *got, size_t len, const char *hex);
+
+/**
+ * Fill `p` with the filler pattern p[i] = i * 167 + seed (mod 256). The
+ * long-message vectors in kat_test.c were generated from this same pattern.
+ */
+void test_pattern(uint8_t *p, size_t len, uint8_t seed);
+
+/**
+ * Run `suite` once per distinct CPU feature level, each in a forked child
+ * that restricts the features (cpu_features_restrict()) before any kernel is
+ * chosen: everything the CPU has, then without AVX2, then plain SSE2/NEON
+ * without the AES and SHA instructions, then portable code only.
+ *
+ * `suite` returns its number of failures.
+ * @return Total number of failed levels (0 when every level passed).
+ */
+int test_run_per_cpu_level(int (*suite)(void));
+
+#endif // OPENLOCKR_TEST_UTIL_H